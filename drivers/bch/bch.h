@@ -52,9 +52,35 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* Configuration ************************************************************/
+
+/* The number of sectors held in the sector cache.  The dirty sector bitmap
+ * limits this to 32.
+ */
+
+#ifndef CONFIG_BCH_NCACHE
+#  define CONFIG_BCH_NCACHE 1
+#endif
+
+#if CONFIG_BCH_NCACHE < 1 || CONFIG_BCH_NCACHE > 32
+#  error CONFIG_BCH_NCACHE must be in the range 1-32
+#endif
+
 #define bchlib_semgive(d) nxsem_post(&(d)->sem)  /* To match bchlib_semtake */
 #define MAX_OPENCNT       (255)                  /* Limit of uint8_t */
 
+/* Sector cache helpers.  bchlib_cached() is true if the sector is in the
+ * sector cache; bchlib_sectbuf() returns the address of the cached sector
+ * data; bchlib_markdirty() marks the cached sector as modified.
+ */
+
+#define bchlib_cached(b,s) \
+  ((s) >= (b)->sector && (s) - (b)->sector < (b)->ncached)
+#define bchlib_sectbuf(b,s) \
+  (&(b)->buffer[((s) - (b)->sector) * (b)->sectsize])
+#define bchlib_markdirty(b,s) \
+  ((b)->dirty |= (uint32_t)1 << ((s) - (b)->sector))
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -64,13 +90,15 @@ struct bchlib_s
   FAR struct inode *inode; /* I-node of the block driver */
   uint32_t sectsize;       /* The size of one sector on the device */
   size_t nsectors;         /* Number of sectors supported by the device */
-  size_t sector;           /* The current sector in the buffer */
+  size_t sector;           /* The first sector in the sector cache */
+  size_t nextoffset;       /* Offset where a sequential read would continue */
+  uint32_t dirty;          /* One bit per cached sector: Data has been written */
   sem_t sem;               /* For atomic accesses to this structure */
   uint8_t refs;            /* Number of references */
-  bool dirty;              /* true: Data has been written to the buffer */
+  uint8_t ncached;         /* Number of sectors in the sector cache */
   bool readonly;           /* true: Only read operations are supported */
   bool unlinked;           /* true: The driver has been unlinked */
-  FAR uint8_t *buffer;     /* One sector buffer */
+  FAR uint8_t *buffer;     /* Sector cache of CONFIG_BCH_NCACHE sectors */
 
 #if defined(CONFIG_BCH_ENCRYPTION)
   uint8_t key[CONFIG_BCH_ENCRYPTION_KEY_SIZE];  /* Encryption key */
@@ -97,7 +125,8 @@ EXTERN const struct file_operations bch_fops;
 
 EXTERN void bchlib_semtake(FAR struct bchlib_s *bch);
 EXTERN int  bchlib_flushsector(FAR struct bchlib_s *bch);
-EXTERN int  bchlib_readsector(FAR struct bchlib_s *bch, size_t sector);
+EXTERN int  bchlib_readsector(FAR struct bchlib_s *bch, size_t sector,
+                              bool readahead);
 
 #undef EXTERN
 #if defined(__cplusplus)
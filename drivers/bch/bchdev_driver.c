@@ -171,15 +171,18 @@ static int bch_close(FAR struct file *filep)
 {
   FAR struct inode *inode = filep->f_inode;
   FAR struct bchlib_s *bch;
+  int flushret;
   int ret = OK;
 
   DEBUGASSERT(inode && inode->i_private);
   bch = (FAR struct bchlib_s *)inode->i_private;
 
-  /* Flush any dirty pages remaining in the cache */
+  /* Flush any dirty pages remaining in the cache.  A failure is reported
+   * to the caller, but the close still completes.
+   */
 
   bchlib_semtake(bch);
-  (void)bchlib_flushsector(bch);
+  flushret = bchlib_flushsector(bch);
 
   /* Decrement the reference count (I don't use bchlib_decref() because I
    * want the entire close operation to be atomic wrt other driver
@@ -214,13 +217,13 @@ static int bch_close(FAR struct file *filep)
              {
                 /* Return without releasing the stale semaphore */
 
-                return OK;
+                return flushret;
              }
         }
     }
 
   bchlib_semgive(bch);
-  return ret;
+  return ret < 0 ? ret : flushret;
 }
 
 /****************************************************************************
@@ -409,6 +412,18 @@ static int bch_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         }
         break;
 
+      /* This is a request to write any modified sectors in the sector cache
+       * to the block driver.
+       */
+
+      case BIOC_FLUSH:
+        {
+          bchlib_semtake(bch);
+          ret = bchlib_flushsector(bch);
+          bchlib_semgive(bch);
+        }
+        break;
+
 #ifdef CONFIG_BCH_ENCRYPTION
       /* This is a request to set the encryption key? */
 
@@ -71,13 +71,18 @@ static void bch_xor(uint32_t *R, uint32_t *A, uint32_t *B)
 
 /****************************************************************************
  * Name: bch_cypher
+ *
+ * Description:
+ *   Encrypt or decrypt one sector of data in the sector cache
+ *
  ****************************************************************************/
 
 #if defined(CONFIG_BCH_ENCRYPTION)
-static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
+static int bch_cypher(FAR struct bchlib_s *bch, FAR uint8_t *sectbuf,
+                      size_t sector, int encrypt)
 {
   int blocks = bch->sectsize / 16;
-  FAR uint32_t *buffer = (FAR uint32_t *)bch->buffer;
+  FAR uint32_t *buffer = (FAR uint32_t *)sectbuf;
   int i;
 
   for (i = 0; i < blocks; i++, buffer += 16 / sizeof(uint32_t) )
@@ -85,7 +90,7 @@ static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
       uint32_t T[4];
       uint32_t X[4] =
       {
-        bch->sector, 0, 0, i
+        sector, 0, 0, i
       };
 
       aes_cypher(X, X, 16, NULL, bch->key, CONFIG_BCH_ENCRYPTION_KEY_SIZE,
@@ -111,7 +116,8 @@ static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
  * Name: bchlib_flushsector
  *
  * Description:
- *   Flush the current contents of the sector buffer (if dirty)
+ *   Flush all modified sectors in the sector cache.  Each run of adjacent,
+ *   modified sectors is written to the media with a single write.
  *
  * Assumptions:
  *   Caller must assume mutual exclusion
@@ -121,28 +127,67 @@ static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
 int bchlib_flushsector(FAR struct bchlib_s *bch)
 {
   FAR struct inode *inode;
+  FAR uint8_t *buffer;
+  ssize_t nwritten;
   ssize_t ret = OK;
+  uint32_t mask;
+  unsigned int nsect;
+  unsigned int i;
+#if defined(CONFIG_BCH_ENCRYPTION)
+  unsigned int j;
+#endif
 
-  /* Check if the sector has been modified and is out of synch with the
+  /* Check if any sectors have been modified and are out of synch with the
    * media.
    */
 
-  if (bch->dirty)
+  inode = bch->inode;
+  for (i = 0; bch->dirty != 0 && i < bch->ncached; i += nsect)
     {
-      inode = bch->inode;
+      /* Find the next run of modified sectors */
+
+      nsect = 1;
+      if ((bch->dirty & ((uint32_t)1 << i)) == 0)
+        {
+          continue;
+        }
+
+      while (i + nsect < bch->ncached &&
+             (bch->dirty & ((uint32_t)1 << (i + nsect))) != 0)
+        {
+          nsect++;
+        }
+
+      buffer = &bch->buffer[i * bch->sectsize];
 
 #if defined(CONFIG_BCH_ENCRYPTION)
       /* Encrypt data as necessary */
 
-      bch_cypher(bch, CYPHER_ENCRYPT);
+      for (j = 0; j < nsect; j++)
+        {
+          bch_cypher(bch, &buffer[j * bch->sectsize], bch->sector + i + j,
+                     CYPHER_ENCRYPT);
+        }
 #endif
 
-      /* Write the sector to the media */
+      /* Write the sectors to the media */
 
-      ret = inode->u.i_bops->write(inode, bch->buffer, bch->sector, 1);
-      if (ret < 0)
+      nwritten = inode->u.i_bops->write(inode, buffer, bch->sector + i,
+                                        nsect);
+      if (nwritten < 0)
+        {
+          ferr("Write failed: %d\n", (int)nwritten);
+          ret = nwritten;
+        }
+      else
         {
-          ferr("Write failed: %d\n");
+          /* These sectors are now in sync with the media.  Sectors that
+           * could not be written stay modified so that the data is not
+           * lost and the write is retried by the next flush.
+           */
+
+          mask        = nsect < 32 ? ((uint32_t)1 << nsect) - 1 : UINT32_MAX;
+          bch->dirty &= ~(mask << i);
         }
 
 #if defined(CONFIG_BCH_ENCRYPTION)
@@ -150,12 +195,12 @@ int bchlib_flushsector(FAR struct bchlib_s *bch)
        * TODO: Add configuration switch for extra sector buffer
        */
 
-      bch_cypher(bch, CYPHER_DECRYPT);
+      for (j = 0; j < nsect; j++)
+        {
+          bch_cypher(bch, &buffer[j * bch->sectsize], bch->sector + i + j,
+                     CYPHER_DECRYPT);
+        }
 #endif
-
-      /* The sector is now in sync with the media */
-
-      bch->dirty = false;
     }
 
   return (int)ret;
@@ -165,35 +210,100 @@ int bchlib_flushsector(FAR struct bchlib_s *bch)
  * Name: bchlib_readsector
  *
  * Description:
- *   Flush the current contents of the sector buffer (if dirty)
+ *   Make sure that the sector is in the sector cache.
+ *
+ *   If the sector immediately follows the cached sectors and there is room
+ *   in the cache, the sector is added to the cache.  This keeps modified
+ *   sectors of a sequential write in the cache together so that they can
+ *   be written back with one write.
+ *
+ *   Otherwise, the cache is flushed and refilled starting at the sector.
+ *   If 'readahead' is true, the cache is filled with as many sectors as it
+ *   will hold with a single read; otherwise, only the one sector is read.
  *
  * Assumptions:
  *   Caller must assume mutual exclusion
  *
  ****************************************************************************/
 
-int bchlib_readsector(FAR struct bchlib_s *bch, size_t sector)
+int bchlib_readsector(FAR struct bchlib_s *bch, size_t sector,
+                      bool readahead)
 {
   FAR struct inode *inode;
-  ssize_t ret = OK;
+  FAR uint8_t *buffer;
+  ssize_t ret;
+  size_t nsect;
+#if defined(CONFIG_BCH_ENCRYPTION)
+  size_t i;
+#endif
+
+  if (bchlib_cached(bch, sector))
+    {
+      return OK;
+    }
 
-  if (bch->sector != sector)
+  inode = bch->inode;
+
+  if (!readahead && bch->ncached > 0 && bch->ncached < CONFIG_BCH_NCACHE &&
+      sector == bch->sector + bch->ncached)
     {
-      inode = bch->inode;
+      /* Add the sector to the end of the cache */
 
-      (void)bchlib_flushsector(bch);
-      bch->sector = (size_t)-1;
+      buffer = &bch->buffer[bch->ncached * bch->sectsize];
+      nsect  = 1;
+    }
+  else
+    {
+      /* Replace the contents of the cache.  Modified sectors must be
+       * written back first; if that fails, they are kept in the cache.
+       */
 
-      ret = inode->u.i_bops->read(inode, bch->buffer, sector, 1);
+      ret = bchlib_flushsector(bch);
       if (ret < 0)
         {
-          ferr("Read failed: %d\n");
+          return (int)ret;
+        }
+
+      bch->sector  = sector;
+      bch->ncached = 0;
+
+      buffer = bch->buffer;
+      nsect  = 1;
+
+      if (readahead)
+        {
+          nsect = CONFIG_BCH_NCACHE;
+          if (sector + nsect > bch->nsectors)
+            {
+              nsect = bch->nsectors - sector;
+            }
         }
-      bch->sector = sector;
+    }
+
+  /* The driver may return fewer sectors than requested; only those that
+   * were actually read are cached.
+   */
+
+  ret = inode->u.i_bops->read(inode, buffer, sector, nsect);
+  if (ret <= 0)
+    {
+      ferr("Read failed: %d\n", (int)ret);
+      return ret < 0 ? (int)ret : -EIO;
+    }
+
+  if ((size_t)ret < nsect)
+    {
+      nsect = ret;
+    }
+
 #if defined(CONFIG_BCH_ENCRYPTION)
-      bch_cypher(bch, CYPHER_DECRYPT);
-#endif
+  for (i = 0; i < nsect; i++)
+    {
+      bch_cypher(bch, &buffer[i * bch->sectsize], sector + i,
+                 CYPHER_DECRYPT);
     }
-  return (int)ret;
-}
+#endif
 
+  bch->ncached += nsect;
+  return OK;
+}
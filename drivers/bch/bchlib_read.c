@@ -85,6 +85,7 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset, size_t le
   uint16_t sectoffset;
   size_t   nbytes;
   size_t   bytesread;
+  bool     sequential;
   int      ret;
 
   /* Get rid of this special case right away */
@@ -106,14 +107,24 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset, size_t le
       return 0;
     }
 
+  /* If this read continues where the last one ended, then fill the sector
+   * cache with the sectors that follow, too.
+   */
+
+  sequential = (offset == bch->nextoffset);
+
   /* Read the initial partial sector */
 
   bytesread = 0;
   if (sectoffset > 0)
     {
-      /* Read the sector into the sector buffer */
+      /* Read the sector into the sector cache */
 
-      bchlib_readsector(bch, sector);
+      ret = bchlib_readsector(bch, sector, sequential);
+      if (ret < 0)
+        {
+          return ret;
+        }
 
       /* Copy the tail end of the sector to the user buffer */
 
@@ -126,7 +137,7 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset, size_t le
           nbytes = len;
         }
 
-      memcpy(buffer, &bch->buffer[sectoffset], nbytes);
+      memcpy(buffer, bchlib_sectbuf(bch, sector) + sectoffset, nbytes);
 
       /* Adjust pointers and counts */
 
@@ -154,6 +165,20 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset, size_t le
           nsectors = bch->nsectors - sector;
         }
 
+      /* Make sure that the media holds any modified data in the sector
+       * cache that is about to be read.
+       */
+
+      if (bch->dirty != 0 && sector < bch->sector + bch->ncached &&
+          sector + nsectors > bch->sector)
+        {
+          ret = bchlib_flushsector(bch);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+
       ret = bch->inode->u.i_bops->read(bch->inode, (FAR uint8_t *)buffer,
                                        sector, nsectors);
       if (ret < 0)
@@ -181,18 +206,23 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset, size_t le
 
   if (len > 0)
     {
-      /* Read the sector into the sector buffer */
+      /* Read the sector into the sector cache */
 
-      bchlib_readsector(bch, sector);
+      ret = bchlib_readsector(bch, sector, sequential);
+      if (ret < 0)
+        {
+          return ret;
+        }
 
       /* Copy the head end of the sector to the user buffer */
 
-      memcpy(buffer, bch->buffer, len);
+      memcpy(buffer, bchlib_sectbuf(bch, sector), len);
 
       /* Adjust counts */
 
       bytesread += len;
     }
 
+  bch->nextoffset = offset + bytesread;
   return bytesread;
 }
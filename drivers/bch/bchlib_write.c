@@ -97,9 +97,13 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset,
   byteswritten = 0;
   if (sectoffset > 0)
     {
-      /* Read the full sector into the sector buffer */
+      /* Read the full sector into the sector cache */
 
-      bchlib_readsector(bch, sector);
+      ret = bchlib_readsector(bch, sector, false);
+      if (ret < 0)
+        {
+          return ret;
+        }
 
       /* Copy the tail end of the sector from the user buffer */
 
@@ -112,8 +116,8 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset,
           nbytes = len;
         }
 
-      memcpy(&bch->buffer[sectoffset], buffer, nbytes);
-      bch->dirty = true;
+      memcpy(bchlib_sectbuf(bch, sector) + sectoffset, buffer, nbytes);
+      bchlib_markdirty(bch, sector);
 
       /* Adjust pointers and counts */
 
@@ -141,6 +145,23 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset,
           nsectors = bch->nsectors - sector;
         }
 
+      /* If any of these sectors are in the sector cache, then write back
+       * the cache and discard it so that it does not hold stale data.
+       */
+
+      if (sector < bch->sector + bch->ncached &&
+          sector + nsectors > bch->sector)
+        {
+          ret = bchlib_flushsector(bch);
+          if (ret < 0)
+            {
+              return ret;
+            }
+
+          bch->sector  = (size_t)-1;
+          bch->ncached = 0;
+        }
+
       /* Write the contiguous sectors */
 
       ret = bch->inode->u.i_bops->write(bch->inode, (FAR uint8_t *)buffer,
@@ -170,20 +191,32 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset,
 
   if (len > 0)
     {
-      /* Read the sector into the sector buffer */
+      /* Read the sector into the sector cache */
 
-      bchlib_readsector(bch, sector);
+      ret = bchlib_readsector(bch, sector, false);
+      if (ret < 0)
+        {
+          return ret;
+        }
 
       /* Copy the head end of the sector from the user buffer */
 
-      memcpy(bch->buffer, buffer, len);
-      bch->dirty = true;
+      memcpy(bchlib_sectbuf(bch, sector), buffer, len);
+      bchlib_markdirty(bch, sector);
 
       /* Adjust counts */
 
       byteswritten += len;
     }
 
+#ifdef CONFIG_BCH_WRITEBACK
+  /* Modified sectors are left in the sector cache so that following writes
+   * to adjacent sectors can be combined with them.  They are written to the
+   * device when the cache is refilled, when the driver is closed, or on
+   * BIOC_FLUSH.
+   */
+
+#else
   /* Finally, flush any cached writes to the device as well */
 
   ret = bchlib_flushsector(bch);
@@ -192,6 +225,7 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset,
       ferr("ERROR: Flush failed: %d\n", ret);
       return ret;
     }
+#endif
 
   return byteswritten;
 }
@@ -42,6 +42,7 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <sys/ioctl.h>
+#include <sys/uio.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include <stdlib.h>
@@ -145,7 +146,7 @@ static void pipecommon_pollnotify(FAR struct pipe_dev_s *dev,
           if (fds->revents != 0)
             {
               finfo("Report events: %02x\n", fds->revents);
-              nxsem_post(fds->sem);
+              poll_notify(fds);
             }
         }
     }
@@ -154,6 +155,351 @@ static void pipecommon_pollnotify(FAR struct pipe_dev_s *dev,
 #  define pipecommon_pollnotify(dev,event)
 #endif
 
+/****************************************************************************
+ * Name: pipecommon_copyout
+ *
+ * Description:
+ *   Remove up to 'len' bytes from the circular buffer.  The data is copied
+ *   in at most two spans:  From the read index up to the end of the buffer
+ *   and then from the beginning of the buffer.
+ *
+ ****************************************************************************/
+
+static size_t pipecommon_copyout(FAR struct pipe_dev_s *dev,
+                                 FAR uint8_t *buffer, size_t len)
+{
+  size_t ncopied = 0;
+  size_t nspan;
+
+  while (ncopied < len && dev->d_wrndx != dev->d_rdndx)
+    {
+      /* Get the number of contiguous bytes from the read index */
+
+      if (dev->d_wrndx > dev->d_rdndx)
+        {
+          nspan = dev->d_wrndx - dev->d_rdndx;
+        }
+      else
+        {
+          nspan = dev->d_bufsize - dev->d_rdndx;
+        }
+
+      if (nspan > len - ncopied)
+        {
+          nspan = len - ncopied;
+        }
+
+      memcpy(buffer + ncopied, &dev->d_buffer[dev->d_rdndx], nspan);
+      ncopied += nspan;
+
+      dev->d_rdndx += nspan;
+      if (dev->d_rdndx >= dev->d_bufsize)
+        {
+          dev->d_rdndx = 0;
+        }
+    }
+
+  return ncopied;
+}
+
+/****************************************************************************
+ * Name: pipecommon_copyin
+ *
+ * Description:
+ *   Add up to 'len' bytes to the circular buffer.  The data is copied in at
+ *   most two spans.  One byte of the buffer always remains unused so that
+ *   a full buffer can be distinguished from an empty one.
+ *
+ ****************************************************************************/
+
+static size_t pipecommon_copyin(FAR struct pipe_dev_s *dev,
+                                FAR const uint8_t *buffer, size_t len)
+{
+  size_t ncopied = 0;
+  size_t nspan;
+
+  while (ncopied < len)
+    {
+      /* Get the number of contiguous free bytes from the write index */
+
+      if (dev->d_wrndx < dev->d_rdndx)
+        {
+          nspan = dev->d_rdndx - dev->d_wrndx - 1;
+        }
+      else if (dev->d_rdndx == 0)
+        {
+          nspan = dev->d_bufsize - dev->d_wrndx - 1;
+        }
+      else
+        {
+          nspan = dev->d_bufsize - dev->d_wrndx;
+        }
+
+      if (nspan == 0)
+        {
+          /* The buffer is full */
+
+          break;
+        }
+
+      if (nspan > len - ncopied)
+        {
+          nspan = len - ncopied;
+        }
+
+      memcpy(&dev->d_buffer[dev->d_wrndx], buffer + ncopied, nspan);
+      ncopied += nspan;
+
+      dev->d_wrndx += nspan;
+      if (dev->d_wrndx >= dev->d_bufsize)
+        {
+          dev->d_wrndx = 0;
+        }
+    }
+
+  return ncopied;
+}
+
+/****************************************************************************
+ * Name: pipecommon_readvec
+ *
+ * Description:
+ *   Common implementation of read() and readv().  Wait until the pipe is
+ *   not empty, then return as much of its content as fits into the I/O
+ *   vector.
+ *
+ ****************************************************************************/
+
+static ssize_t pipecommon_readvec(FAR struct file *filep,
+                                  FAR const struct iovec *iov, int iovcnt)
+{
+  FAR struct inode      *inode  = filep->f_inode;
+  FAR struct pipe_dev_s *dev    = inode->i_private;
+  ssize_t                nread  = 0;
+  size_t                 ncopied;
+  int                    sval;
+  int                    ret;
+  int                    i;
+
+  DEBUGASSERT(dev);
+
+  /* Make sure that we have exclusive access to the device structure */
+
+  ret = nxsem_wait(&dev->d_bfsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* If the pipe is empty, then wait for something to be written to it */
+
+  while (dev->d_wrndx == dev->d_rdndx)
+    {
+      /* If O_NONBLOCK was set, then return EGAIN */
+
+      if (filep->f_oflags & O_NONBLOCK)
+        {
+          nxsem_post(&dev->d_bfsem);
+          return -EAGAIN;
+        }
+
+      /* If there are no writers on the pipe, then return end of file */
+
+      if (dev->d_nwriters <= 0)
+        {
+          nxsem_post(&dev->d_bfsem);
+          return 0;
+        }
+
+      /* Otherwise, wait for something to be written to the pipe */
+
+      sched_lock();
+      nxsem_post(&dev->d_bfsem);
+      ret = nxsem_wait(&dev->d_rdsem);
+      sched_unlock();
+
+      if (ret < 0 || (ret = nxsem_wait(&dev->d_bfsem)) < 0)
+        {
+          return ret;
+        }
+    }
+
+  /* Then return whatever is available in the pipe (which is at least one
+   * byte).
+   */
+
+  for (i = 0; i < iovcnt && dev->d_wrndx != dev->d_rdndx; i++)
+    {
+      ncopied = pipecommon_copyout(dev, (FAR uint8_t *)iov[i].iov_base,
+                                   iov[i].iov_len);
+      pipe_dumpbuffer("From PIPE:", (FAR uint8_t *)iov[i].iov_base, ncopied);
+      nread  += ncopied;
+    }
+
+  /* Notify all waiting writers that bytes have been removed from the buffer */
+
+  while (nxsem_getvalue(&dev->d_wrsem, &sval) == 0 && sval < 0)
+    {
+      nxsem_post(&dev->d_wrsem);
+    }
+
+  /* Notify all poll/select waiters that they can write to the FIFO */
+
+  pipecommon_pollnotify(dev, POLLOUT);
+
+  nxsem_post(&dev->d_bfsem);
+  return nread;
+}
+
+/****************************************************************************
+ * Name: pipecommon_writevec
+ *
+ * Description:
+ *   Common implementation of write() and writev().  Copy the whole I/O
+ *   vector into the pipe, waiting for space as needed (unless O_NONBLOCK
+ *   is set).
+ *
+ ****************************************************************************/
+
+static ssize_t pipecommon_writevec(FAR struct file *filep,
+                                   FAR const struct iovec *iov, int iovcnt)
+{
+  FAR struct inode      *inode    = filep->f_inode;
+  FAR struct pipe_dev_s *dev      = inode->i_private;
+  ssize_t                nwritten = 0;
+  ssize_t                last;
+  size_t                 offset;
+  size_t                 ncopied;
+  int                    sval;
+  int                    ret;
+  int                    i;
+
+  DEBUGASSERT(dev);
+
+  /* At present, this method cannot be called from interrupt handlers.  That
+   * is because it calls nxsem_wait (via pipecommon_semtake below) and
+   * nxsem_wait cannot be called from interrupt level.  This actually
+   * happens fairly commonly IF [a-z]err() is called from interrupt handlers
+   * and stdout is being redirected via a pipe.  In that case, the debug
+   * output will try to go out the pipe (interrupt handlers should use the
+   * _err() APIs).
+   *
+   * On the other hand, it would be very valuable to be able to feed the pipe
+   * from an interrupt handler!  TODO:  Consider disabling interrupts instead
+   * of taking semaphores so that pipes can be written from interrupt handlers
+   */
+
+  DEBUGASSERT(up_interrupt_context() == false);
+
+  /* Make sure that we have exclusive access to the device structure */
+
+  ret = nxsem_wait(&dev->d_bfsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Loop until all of the bytes have been written */
+
+  last   = 0;
+  offset = 0;
+  i      = 0;
+
+  for (; ; )
+    {
+      /* Copy as much as will fit into the circular buffer.  'offset' is the
+       * number of bytes of iov[i] that have already been copied.
+       */
+
+      for (; i < iovcnt; i++, offset = 0)
+        {
+          ncopied = pipecommon_copyin(dev,
+                                      (FAR const uint8_t *)iov[i].iov_base +
+                                      offset, iov[i].iov_len - offset);
+          pipe_dumpbuffer("To PIPE:",
+                          (FAR const uint8_t *)iov[i].iov_base + offset,
+                          ncopied);
+          nwritten += ncopied;
+          offset   += ncopied;
+
+          if (offset < iov[i].iov_len)
+            {
+              /* The circular buffer is full */
+
+              break;
+            }
+        }
+
+      /* Is the write complete? */
+
+      if (i >= iovcnt)
+        {
+          /* Yes.. Notify all of the waiting readers that more data is
+           * available.
+           */
+
+          while (nxsem_getvalue(&dev->d_rdsem, &sval) == 0 && sval < 0)
+            {
+              nxsem_post(&dev->d_rdsem);
+            }
+
+          /* Notify all poll/select waiters that they can read from the FIFO */
+
+          pipecommon_pollnotify(dev, POLLIN);
+
+          /* Return the number of bytes written */
+
+          nxsem_post(&dev->d_bfsem);
+          return nwritten;
+        }
+
+      /* There is not enough room for the rest.  Was anything written in
+       * this pass?
+       */
+
+      if (last < nwritten)
+        {
+          /* Yes.. Notify all of the waiting readers that more data is
+           * available.
+           */
+
+          while (nxsem_getvalue(&dev->d_rdsem, &sval) == 0 && sval < 0)
+            {
+              nxsem_post(&dev->d_rdsem);
+            }
+
+          /* Notify all poll/select waiters that they can read from the FIFO */
+
+          pipecommon_pollnotify(dev, POLLIN);
+        }
+
+      last = nwritten;
+
+      /* If O_NONBLOCK was set, then return partial bytes written or EGAIN */
+
+      if (filep->f_oflags & O_NONBLOCK)
+        {
+          if (nwritten == 0)
+            {
+              nwritten = -EAGAIN;
+            }
+
+          nxsem_post(&dev->d_bfsem);
+          return nwritten;
+        }
+
+      /* There is more to be written.. wait for data to be removed from the
+       * pipe.
+       */
+
+      sched_lock();
+      nxsem_post(&dev->d_bfsem);
+      pipecommon_semtake(&dev->d_wrsem);
+      sched_unlock();
+      pipecommon_semtake(&dev->d_bfsem);
+    }
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -426,91 +772,16 @@ int pipecommon_close(FAR struct file *filep)
 
 ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
 {
-  FAR struct inode      *inode  = filep->f_inode;
-  FAR struct pipe_dev_s *dev    = inode->i_private;
-#ifdef CONFIG_DEV_PIPEDUMP
-  FAR uint8_t           *start  = (FAR uint8_t *)buffer;
-#endif
-  ssize_t                nread  = 0;
-  int                    sval;
-  int                    ret;
-
-  DEBUGASSERT(dev);
+  struct iovec iov;
 
   if (len == 0)
     {
       return 0;
     }
 
-  /* Make sure that we have exclusive access to the device structure */
-
-  ret = nxsem_wait(&dev->d_bfsem);
-  if (ret < 0)
-    {
-      return ret;
-    }
-
-  /* If the pipe is empty, then wait for something to be written to it */
-
-  while (dev->d_wrndx == dev->d_rdndx)
-    {
-      /* If O_NONBLOCK was set, then return EGAIN */
-
-      if (filep->f_oflags & O_NONBLOCK)
-        {
-          nxsem_post(&dev->d_bfsem);
-          return -EAGAIN;
-        }
-
-      /* If there are no writers on the pipe, then return end of file */
-
-      if (dev->d_nwriters <= 0)
-        {
-          nxsem_post(&dev->d_bfsem);
-          return 0;
-        }
-
-      /* Otherwise, wait for something to be written to the pipe */
-
-      sched_lock();
-      nxsem_post(&dev->d_bfsem);
-      ret = nxsem_wait(&dev->d_rdsem);
-      sched_unlock();
-
-      if (ret < 0 || (ret = nxsem_wait(&dev->d_bfsem)) < 0)
-        {
-          return ret;
-        }
-    }
-
-  /* Then return whatever is available in the pipe (which is at least one byte) */
-
-  nread = 0;
-  while ((size_t)nread < len && dev->d_wrndx != dev->d_rdndx)
-    {
-      *buffer++ = dev->d_buffer[dev->d_rdndx];
-      if (++dev->d_rdndx >= dev->d_bufsize)
-        {
-          dev->d_rdndx = 0;
-        }
-
-      nread++;
-    }
-
-  /* Notify all waiting writers that bytes have been removed from the buffer */
-
-  while (nxsem_getvalue(&dev->d_wrsem, &sval) == 0 && sval < 0)
-    {
-      nxsem_post(&dev->d_wrsem);
-    }
-
-  /* Notify all poll/select waiters that they can write to the FIFO */
-
-  pipecommon_pollnotify(dev, POLLOUT);
-
-  nxsem_post(&dev->d_bfsem);
-  pipe_dumpbuffer("From PIPE:", start, nread);
-  return nread;
+  iov.iov_base = buffer;
+  iov.iov_len  = len;
+  return pipecommon_readvec(filep, &iov, 1);
 }
 
 /****************************************************************************
@@ -520,131 +791,72 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
 ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
                          size_t len)
 {
-  FAR struct inode      *inode    = filep->f_inode;
-  FAR struct pipe_dev_s *dev      = inode->i_private;
-  ssize_t                nwritten = 0;
-  ssize_t                last;
-  int                    nxtwrndx;
-  int                    sval;
-  int                    ret;
-
-  DEBUGASSERT(dev);
-  pipe_dumpbuffer("To PIPE:", (FAR uint8_t *)buffer, len);
+  struct iovec iov;
 
   if (len == 0)
     {
       return 0;
     }
 
-  /* At present, this method cannot be called from interrupt handlers.  That
-   * is because it calls nxsem_wait (via pipecommon_semtake below) and
-   * nxsem_wait cannot be called from interrupt level.  This actually
-   * happens fairly commonly IF [a-z]err() is called from interrupt handlers
-   * and stdout is being redirected via a pipe.  In that case, the debug
-   * output will try to go out the pipe (interrupt handlers should use the
-   * _err() APIs).
-   *
-   * On the other hand, it would be very valuable to be able to feed the pipe
-   * from an interrupt handler!  TODO:  Consider disabling interrupts instead
-   * of taking semaphores so that pipes can be written from interrupt handlers
-   */
+  iov.iov_base = (FAR void *)buffer;
+  iov.iov_len  = len;
+  return pipecommon_writevec(filep, &iov, 1);
+}
 
-  DEBUGASSERT(up_interrupt_context() == false);
+/****************************************************************************
+ * Name: pipecommon_readv
+ *
+ * Description:
+ *   Scatter the pipe content into several buffers with a single wait and
+ *   a single wake-up of the writers.
+ *
+ ****************************************************************************/
 
-  /* Make sure that we have exclusive access to the device structure */
+ssize_t pipecommon_readv(FAR struct file *filep, FAR const struct iovec *iov,
+                         int iovcnt)
+{
+  size_t len = 0;
+  int i;
 
-  ret = nxsem_wait(&dev->d_bfsem);
-  if (ret < 0)
+  for (i = 0; i < iovcnt; i++)
     {
-      return ret;
+      len += iov[i].iov_len;
     }
 
-  /* Loop until all of the bytes have been written */
-
-  last = 0;
-  for (; ; )
+  if (len == 0)
     {
-      /* Calculate the write index AFTER the next byte is written */
-
-      nxtwrndx = dev->d_wrndx + 1;
-      if (nxtwrndx >= dev->d_bufsize)
-        {
-          nxtwrndx = 0;
-        }
-
-      /* Would the next write overflow the circular buffer? */
-
-      if (nxtwrndx != dev->d_rdndx)
-        {
-          /* No... copy the byte */
-
-          dev->d_buffer[dev->d_wrndx] = *buffer++;
-          dev->d_wrndx = nxtwrndx;
-
-          /* Is the write complete? */
-
-          nwritten++;
-          if ((size_t)nwritten >= len)
-            {
-              /* Yes.. Notify all of the waiting readers that more data is available */
-
-              while (nxsem_getvalue(&dev->d_rdsem, &sval) == 0 && sval < 0)
-                {
-                  nxsem_post(&dev->d_rdsem);
-                }
-
-              /* Notify all poll/select waiters that they can read from the FIFO */
-
-              pipecommon_pollnotify(dev, POLLIN);
-
-              /* Return the number of bytes written */
-
-              nxsem_post(&dev->d_bfsem);
-              return len;
-            }
-        }
-      else
-        {
-          /* There is not enough room for the next byte.  Was anything written in this pass? */
-
-          if (last < nwritten)
-            {
-              /* Yes.. Notify all of the waiting readers that more data is available */
-
-              while (nxsem_getvalue(&dev->d_rdsem, &sval) == 0 && sval < 0)
-                {
-                  nxsem_post(&dev->d_rdsem);
-                }
-
-              /* Notify all poll/select waiters that they can read from the FIFO */
-
-              pipecommon_pollnotify(dev, POLLIN);
-            }
-
-          last = nwritten;
+      return 0;
+    }
 
-          /* If O_NONBLOCK was set, then return partial bytes written or EGAIN */
+  return pipecommon_readvec(filep, iov, iovcnt);
+}
 
-          if (filep->f_oflags & O_NONBLOCK)
-            {
-              if (nwritten == 0)
-                {
-                  nwritten = -EAGAIN;
-                }
+/****************************************************************************
+ * Name: pipecommon_writev
+ *
+ * Description:
+ *   Gather several buffers into the pipe with a single wake-up of the
+ *   readers.
+ *
+ ****************************************************************************/
 
-              nxsem_post(&dev->d_bfsem);
-              return nwritten;
-            }
+ssize_t pipecommon_writev(FAR struct file *filep,
+                          FAR const struct iovec *iov, int iovcnt)
+{
+  size_t len = 0;
+  int i;
 
-          /* There is more to be written.. wait for data to be removed from the pipe */
+  for (i = 0; i < iovcnt; i++)
+    {
+      len += iov[i].iov_len;
+    }
 
-          sched_lock();
-          nxsem_post(&dev->d_bfsem);
-          pipecommon_semtake(&dev->d_wrsem);
-          sched_unlock();
-          pipecommon_semtake(&dev->d_bfsem);
-        }
+  if (len == 0)
+    {
+      return 0;
     }
+
+  return pipecommon_writevec(filep, iov, iovcnt);
 }
 
 /****************************************************************************
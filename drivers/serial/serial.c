@@ -210,7 +210,7 @@ static void uart_pollnotify(FAR uart_dev_t *dev, pollevent_t eventset)
           if (fds->revents != 0)
             {
               finfo("Report events: %02x\n", fds->revents);
-              nxsem_post(fds->sem);
+              poll_notify(fds);
             }
         }
     }
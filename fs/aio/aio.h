@@ -43,10 +43,12 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <stdbool.h>
 #include <string.h>
 #include <aio.h>
 #include <queue.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/wqueue.h>
 #include <nuttx/net/net.h>
 
@@ -63,6 +65,32 @@
 #  define CONFIG_FS_NAIOC 8
 #endif
 
+/* Dedicated AIO worker threads */
+
+#ifndef CONFIG_FS_AIO_NTHREADS
+#  define CONFIG_FS_AIO_NTHREADS 1
+#endif
+
+#ifndef CONFIG_FS_AIO_PRIORITY
+#  define CONFIG_FS_AIO_PRIORITY 50
+#endif
+
+#ifndef CONFIG_FS_AIO_STACKSIZE
+#  define CONFIG_FS_AIO_STACKSIZE 2048
+#endif
+
+/* Maximum number of adjacent requests combined into one transfer */
+
+#ifndef CONFIG_FS_AIO_NMERGE
+#  define CONFIG_FS_AIO_NMERGE 4
+#endif
+
+/* Operation types */
+
+#define AIO_OP_READ    0  /* aio_read() */
+#define AIO_OP_WRITE   1  /* aio_write() */
+#define AIO_OP_FSYNC   2  /* aio_fsync() */
+
 #undef AIO_HAVE_FILEP
 #undef AIO_HAVE_PSOCK
 
@@ -101,13 +129,29 @@ struct aio_container_s
 #endif
     FAR void *ptr;                 /* Generic pointer to FAR data */
   } u;
-  struct work_s aioc_work;         /* Used to defer I/O to the work thread */
+  worker_t aioc_worker;            /* Performs the I/O on the AIO thread */
+  systime_t aioc_qtime;            /* Time that the I/O was queued */
   pid_t aioc_pid;                  /* ID of the waiting task */
+  uint8_t aioc_op;                 /* See AIO_OP_* definitions */
 #ifdef CONFIG_PRIORITY_INHERITANCE
   uint8_t aioc_prio;               /* Priority of the waiting task */
 #endif
 };
 
+/* AIO queue statistics returned by aio_stats() */
+
+struct aio_stats_s
+{
+  uint32_t as_submitted;           /* Number of requests queued */
+  uint32_t as_completed;           /* Number of requests completed */
+  uint32_t as_transfers;           /* Number of transfers performed */
+  uint32_t as_merged;              /* Requests combined with a neighbor */
+  uint32_t as_latency;             /* Sum of queue-to-completion times */
+  uint32_t as_maxlatency;          /* Longest queue-to-completion time */
+  uint16_t as_depth;               /* Requests waiting for a worker */
+  uint16_t as_maxdepth;            /* Largest number of waiting requests */
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -121,8 +165,10 @@ extern "C"
 #define EXTERN extern
 #endif
 
-/* This is a list of pending asynchronous I/O.  The user must hold the
- * lock on this list in order to access the list.
+/* This is a list of pending asynchronous I/O that has not yet been taken
+ * by an AIO worker thread.  The list is kept in the order that the I/O was
+ * queued.  The user must hold the lock on this list in order to access the
+ * list.
  */
 
 EXTERN dq_queue_t g_aio_pending;
@@ -228,7 +274,8 @@ FAR struct aio_container_s *aio_contain(FAR struct aiocb *aiocbp);
  *
  * Description:
  *   Remove the AIO control block from the container and free all resources
- *   used by the container.
+ *   used by the container.  The container must already have been removed
+ *   from the pending list.
  *
  * Input Parameters:
  *   aioc - Pointer to the AIO control block container
@@ -244,11 +291,14 @@ FAR struct aiocb *aioc_decant(FAR struct aio_container_s *aioc);
  * Name: aio_queue
  *
  * Description:
- *   Schedule the asynchronous I/O on the low priority work queue
+ *   Add the asynchronous I/O to the pending list and wake up an AIO worker
+ *   thread to perform it.  The AIO worker threads are started when the
+ *   first I/O is queued.
  *
  * Input Parameters:
- *   arg - Worker argument.  In this case, a pointer to an instance of
- *     struct aiocb cast to void *.
+ *   aioc   - The AIO control block container
+ *   op     - The operation type.  See AIO_OP_* definitions.
+ *   worker - The function that performs the I/O on the worker thread.
  *
  * Returned Value:
  *   Zero (OK) on success.  Otherwise, -1 is returned and the errno is set
@@ -256,7 +306,60 @@ FAR struct aiocb *aioc_decant(FAR struct aio_container_s *aioc);
  *
  ****************************************************************************/
 
-int aio_queue(FAR struct aio_container_s *aioc, worker_t worker);
+int aio_queue(FAR struct aio_container_s *aioc, uint8_t op, worker_t worker);
+
+/****************************************************************************
+ * Name: aio_dequeue
+ *
+ * Description:
+ *   Remove I/O that has not yet been started from the pending list.  The
+ *   caller must hold the lock on the pending I/O list.
+ *
+ * Input Parameters:
+ *   aioc - The AIO control block container
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void aio_dequeue(FAR struct aio_container_s *aioc);
+
+/****************************************************************************
+ * Name: aio_busy
+ *
+ * Description:
+ *   Return true if an AIO worker thread is performing I/O on the file or
+ *   socket referred to by fildes.  That I/O has already been removed from
+ *   the pending list and cannot be canceled.  The caller must hold the lock
+ *   on the pending I/O list.
+ *
+ * Input Parameters:
+ *   fildes - The file or socket descriptor
+ *
+ * Returned Value:
+ *   True if I/O on fildes is in progress.
+ *
+ ****************************************************************************/
+
+bool aio_busy(int fildes);
+
+/****************************************************************************
+ * Name: aio_stats
+ *
+ * Description:
+ *   Return a snapshot of the AIO queue depth and latency statistics.
+ *   Latencies are in units of system clock ticks.
+ *
+ * Input Parameters:
+ *   stats - Location to return the statistics
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void aio_stats(FAR struct aio_stats_s *stats);
 
 /****************************************************************************
  * Name: aio_signal
@@ -44,8 +44,6 @@
 #include <assert.h>
 #include <errno.h>
 
-#include <nuttx/wqueue.h>
-
 #include "aio/aio.h"
 
 #ifdef CONFIG_FS_AIO
@@ -98,7 +96,6 @@ int aio_cancel(int fildes, FAR struct aiocb *aiocbp)
 {
   FAR struct aio_container_s *aioc;
   FAR struct aio_container_s *next;
-  int status;
   int ret;
 
   /* Check if a non-NULL aiocbp was provided */
@@ -123,40 +120,40 @@ int aio_cancel(int fildes, FAR struct aiocb *aiocbp)
                aioc && aioc->aioc_aiocbp != aiocbp;
                aioc = (FAR struct aio_container_s *)aioc->aioc_link.flink);
 
-          /* Did we find a container for this fildes?  We should; the aio_result says
-           * that the transfer is pending.  If not we return AIO_ALLDONE.
+          /* Did we find a container for this AIO control block?  The
+           * pending list holds only I/O that an AIO worker thread has not
+           * yet started.  If it is not there, then the I/O is in progress.
            */
 
           if (aioc)
             {
-              /* Yes... attempt to cancel the I/O.  There are two
-               * possibilities:* (1) the work has already been started and
-               * is no longer queued, or (2) the work has not been started
-               * and is still in the work queue.  Only the second case can
-               * be canceled.  work_cancel() will return -ENOENT in the
-               * first case.
+              /* Yes... remove the container from the list of pending
+               * transfers.
                */
 
-              status = work_cancel(LPWORK, &aioc->aioc_work);
-              if (status >= 0)
-                {
-                  aiocbp->aio_result = -ECANCELED;
-                  ret = AIO_CANCELED;
-                }
-              else
-                {
-                  ret = AIO_NOTCANCELED;
-                }
-
-              /* Remove the container from the list of pending transfers */
-
+              aio_dequeue(aioc);
               (void)aioc_decant(aioc);
+
+              aiocbp->aio_result = -ECANCELED;
+              ret = AIO_CANCELED;
+            }
+          else
+            {
+              ret = AIO_NOTCANCELED;
             }
         }
     }
   else
     {
-      /* No aiocbp.. cancel all outstanding I/O for the fildes */
+      /* No aiocbp.. cancel all outstanding I/O for the fildes.  I/O that an
+       * AIO worker thread has already started is no longer in the pending
+       * list and cannot be canceled.
+       */
+
+      if (aio_busy(fildes))
+        {
+          ret = AIO_NOTCANCELED;
+        }
 
       next = (FAR struct aio_container_s *)g_aio_pending.head;
       do
@@ -167,39 +164,26 @@ int aio_cancel(int fildes, FAR struct aiocb *aiocbp)
                aioc && aioc->aioc_aiocbp->aio_fildes != fildes;
                aioc = (FAR struct aio_container_s *)aioc->aioc_link.flink);
 
-          /* Did we find the container?  We should; the aio_result says
-           * that the transfer is pending.  If not we return AIO_ALLDONE.
+          /* Did we find the container?  The pending list holds only I/O
+           * that an AIO worker thread has not yet started, so it can always
+           * be canceled.
            */
 
           if (aioc)
             {
-              /* Yes... attempt to cancel the I/O.  There are two
-               * possibilities:* (1) the work has already been started and
-               * is no longer queued, or (2) the work has not been started
-               * and is still in the work queue.  Only the second case can
-               * be canceled.  work_cancel() will return -ENOENT in the
-               * first case.
+              /* Yes... remove the container from the list of pending
+               * transfers.
                */
 
-              status = work_cancel(LPWORK, &aioc->aioc_work);
-
-              /* Remove the container from the list of pending transfers */
-
               next   = (FAR struct aio_container_s *)aioc->aioc_link.flink;
+              aio_dequeue(aioc);
               aiocbp = aioc_decant(aioc);
               DEBUGASSERT(aiocbp);
 
-              if (status >= 0)
-                {
-                  aiocbp->aio_result = -ECANCELED;
-                  if (ret != AIO_NOTCANCELED)
-                    {
-                      ret = AIO_CANCELED;
-                    }
-                }
-              else
+              aiocbp->aio_result = -ECANCELED;
+              if (ret != AIO_NOTCANCELED)
                 {
-                  ret = AIO_NOTCANCELED;
+                  ret = AIO_CANCELED;
                 }
             }
         }
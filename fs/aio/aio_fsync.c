@@ -77,9 +77,6 @@ static void aio_fsync_worker(FAR void *arg)
   FAR struct aio_container_s *aioc = (FAR struct aio_container_s *)arg;
   FAR struct aiocb *aiocbp;
   pid_t pid;
-#ifdef CONFIG_PRIORITY_INHERITANCE
-  uint8_t prio;
-#endif
   int ret;
 
   /* Get the information from the container, decant the AIO control block,
@@ -89,9 +86,6 @@ static void aio_fsync_worker(FAR void *arg)
 
   DEBUGASSERT(aioc && aioc->aioc_aiocbp);
   pid    = aioc->aioc_pid;
-#ifdef CONFIG_PRIORITY_INHERITANCE
-  prio   = aioc->aioc_prio;
-#endif
   aiocbp = aioc_decant(aioc);
 
   /* Perform the fsync using u.aioc_filep */
@@ -110,12 +104,6 @@ static void aio_fsync_worker(FAR void *arg)
   /* Signal the client */
 
   (void)aio_signal(pid, aiocbp);
-
-#ifdef CONFIG_PRIORITY_INHERITANCE
-  /* Restore the low priority worker thread default priority */
-
-  lpwork_restorepriority(prio);
-#endif
 }
 
 /****************************************************************************
@@ -228,7 +216,7 @@ int aio_fsync(int op, FAR struct aiocb *aiocbp)
 
   /* Defer the work to the worker thread */
 
-  ret = aio_queue(aioc, aio_fsync_worker);
+  ret = aio_queue(aioc, AIO_OP_FSYNC, aio_fsync_worker);
   if (ret < 0)
     {
       /* The result and the errno have already been set */
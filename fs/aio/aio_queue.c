@@ -33,36 +33,546 @@
  *
  ****************************************************************************/
 
+
 /****************************************************************************
  * Included Files
  ****************************************************************************/
 
 #include <nuttx/config.h>
 
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
 #include <sched.h>
+#include <fcntl.h>
+#include <semaphore.h>
 #include <aio.h>
+#include <assert.h>
 #include <errno.h>
 #include <debug.h>
 
-#include <nuttx/wqueue.h>
+#include <nuttx/sched.h>
+#include <nuttx/kthread.h>
+#include <nuttx/clock.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/net/net.h>
 
 #include "aio/aio.h"
 
 #ifdef CONFIG_FS_AIO
 
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one AIO worker thread */
+
+struct aio_worker_s
+{
+  pid_t aw_pid;                    /* PID of the worker thread */
+  FAR void *aw_busy;               /* File or socket being accessed */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The AIO worker threads.  These are started when the first I/O is
+ * queued.
+ */
+
+static struct aio_worker_s g_aio_worker[CONFIG_FS_AIO_NTHREADS];
+
+/* Counts the number of times that I/O was queued.  The worker threads wait
+ * on this semaphore when there is no I/O that they can perform.
+ */
+
+static sem_t g_aio_worksem;
+
+/* AIO queue statistics */
+
+static struct aio_stats_s g_aio_stats;
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: aio_boostpriority and aio_restorepriority
+ *
+ * Description:
+ *   Make sure that the AIO worker threads run at at least the priority of
+ *   the thread waiting for the I/O.  The boost remains in effect until the
+ *   worker thread finds no more I/O to perform.  The caller must hold the
+ *   lock on the pending I/O list.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_PRIORITY_INHERITANCE
+static void aio_boostpriority(uint8_t reqprio)
+{
+  struct sched_param param;
+  int wndx;
+
+  for (wndx = 0; wndx < CONFIG_FS_AIO_NTHREADS; wndx++)
+    {
+      /* Skip workers that could not be started.  nxsched_getparam() would
+       * interpret the zero PID as the calling thread.
+       */
+
+      if (g_aio_worker[wndx].aw_pid != 0 &&
+          nxsched_getparam(g_aio_worker[wndx].aw_pid, &param) >= 0 &&
+          param.sched_priority < reqprio)
+        {
+          param.sched_priority = reqprio;
+          (void)nxsched_setparam(g_aio_worker[wndx].aw_pid, &param);
+        }
+    }
+}
+
+static void aio_restorepriority(void)
+{
+  struct sched_param param;
+
+  param.sched_priority = CONFIG_FS_AIO_PRIORITY;
+  (void)nxsched_setparam(0, &param);
+}
+#endif
+
+/****************************************************************************
+ * Name: aio_blocked
+ *
+ * Description:
+ *   I/O on the same file or socket must be performed in the order that it
+ *   was queued.  Return true if the I/O cannot be started because an AIO
+ *   worker thread is busy with the same file or socket, or because older
+ *   I/O for the same file or socket is still waiting.  The caller must hold
+ *   the lock on the pending I/O list.
+ *
+ ****************************************************************************/
+
+static bool aio_blocked(FAR struct aio_container_s *aioc)
+{
+  FAR struct aio_container_s *prev;
+  int wndx;
+
+  for (wndx = 0; wndx < CONFIG_FS_AIO_NTHREADS; wndx++)
+    {
+      if (g_aio_worker[wndx].aw_busy == aioc->u.ptr)
+        {
+          return true;
+        }
+    }
+
+  for (prev = (FAR struct aio_container_s *)g_aio_pending.head;
+       prev != aioc;
+       prev = (FAR struct aio_container_s *)prev->aioc_link.flink)
+    {
+      if (prev->u.ptr == aioc->u.ptr)
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: aio_dispatch
+ *
+ * Description:
+ *   Remove the oldest I/O that can be started from the pending list.  If it
+ *   is a file read or write, then the following reads or writes of the same
+ *   file that continue where it ends are removed with it so that they can
+ *   be performed as one transfer.  The caller must hold the lock on the
+ *   pending I/O list.
+ *
+ * Input Parameters:
+ *   wndx  - Index of the calling worker thread
+ *   batch - Location to return the I/O containers
+ *
+ * Returned Value:
+ *   The number of containers returned in batch.  Zero is returned if there
+ *   is no I/O that can be started.
+ *
+ ****************************************************************************/
+
+static int aio_dispatch(int wndx, FAR struct aio_container_s **batch)
+{
+  FAR struct aio_container_s *aioc;
+  int nbatch;
+  int i;
+
+  for (aioc = (FAR struct aio_container_s *)g_aio_pending.head;
+       aioc != NULL;
+       aioc = (FAR struct aio_container_s *)aioc->aioc_link.flink)
+    {
+      if (aio_blocked(aioc))
+        {
+          continue;
+        }
+
+      batch[0] = aioc;
+      nbatch   = 1;
+
+#ifdef AIO_HAVE_FILEP
+      if (aioc->aioc_op != AIO_OP_FSYNC
+#ifdef AIO_HAVE_PSOCK
+          && aioc->aioc_aiocbp->aio_fildes < CONFIG_NFILE_DESCRIPTORS
+#endif
+         )
+        {
+          FAR struct aio_container_s *next;
+          off_t end;
+
+          /* Collect the following I/O on this file while it is of the same
+           * type and continues where the previous one ends.
+           */
+
+          end = aioc->aioc_aiocbp->aio_offset +
+                aioc->aioc_aiocbp->aio_nbytes;
+
+          for (next = (FAR struct aio_container_s *)aioc->aioc_link.flink;
+               next != NULL && nbatch < CONFIG_FS_AIO_NMERGE;
+               next = (FAR struct aio_container_s *)next->aioc_link.flink)
+            {
+              if (next->u.ptr != aioc->u.ptr)
+                {
+                  continue;
+                }
+
+              if (next->aioc_op != aioc->aioc_op ||
+                  next->aioc_aiocbp->aio_offset != end)
+                {
+                  break;
+                }
+
+              batch[nbatch++] = next;
+              end += next->aioc_aiocbp->aio_nbytes;
+            }
+        }
+#endif
+
+      /* Take the I/O and mark the file or socket busy */
+
+      for (i = 0; i < nbatch; i++)
+        {
+          dq_rem(&batch[i]->aioc_link, &g_aio_pending);
+        }
+
+      g_aio_worker[wndx].aw_busy = aioc->u.ptr;
+
+      g_aio_stats.as_depth -= nbatch;
+      g_aio_stats.as_transfers++;
+      if (nbatch > 1)
+        {
+          g_aio_stats.as_merged += nbatch;
+        }
+
+      return nbatch;
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: aio_complete
+ *
+ * Description:
+ *   Update the statistics for one completed I/O
+ *
+ ****************************************************************************/
+
+static void aio_complete(systime_t qtime)
+{
+  uint32_t elapsed = (uint32_t)(clock_systimer() - qtime);
+
+  aio_lock();
+  g_aio_stats.as_completed++;
+  g_aio_stats.as_latency += elapsed;
+  if (elapsed > g_aio_stats.as_maxlatency)
+    {
+      g_aio_stats.as_maxlatency = elapsed;
+    }
+
+  aio_unlock();
+}
+
+/****************************************************************************
+ * Name: aio_transfer
+ *
+ * Description:
+ *   Perform several adjacent reads or writes of the same file as one
+ *   vectored transfer, then divide the result among the requests.
+ *
+ ****************************************************************************/
+
+#ifdef AIO_HAVE_FILEP
+static void aio_transfer(FAR struct aio_container_s **batch, int nbatch)
+{
+  FAR struct aiocb *aiocbp[CONFIG_FS_AIO_NMERGE];
+  struct iovec iov[CONFIG_FS_AIO_NMERGE];
+  systime_t qtime[CONFIG_FS_AIO_NMERGE];
+  pid_t pid[CONFIG_FS_AIO_NMERGE];
+  FAR struct file *filep;
+  off_t savepos;
+  off_t pos;
+  ssize_t remaining;
+  ssize_t ret;
+  uint8_t op;
+  int i;
+
+  /* Get the information from the containers and free them before starting
+   * the I/O.
+   */
+
+  filep = batch[0]->u.aioc_filep;
+  op    = batch[0]->aioc_op;
+
+  for (i = 0; i < nbatch; i++)
+    {
+      pid[i]          = batch[i]->aioc_pid;
+      qtime[i]        = batch[i]->aioc_qtime;
+      aiocbp[i]       = aioc_decant(batch[i]);
+      iov[i].iov_base = (FAR void *)aiocbp[i]->aio_buf;
+      iov[i].iov_len  = aiocbp[i]->aio_nbytes;
+    }
+
+  if (op == AIO_OP_WRITE && (filep->f_oflags & O_APPEND) != 0)
+    {
+      /* Append to the current file position */
+
+      ret = file_writev(filep, iov, nbatch);
+    }
+  else
+    {
+      /* Perform the transfer at the offset of the first request without
+       * disturbing the file position, as file_pread() does.
+       */
+
+      savepos = file_seek(filep, 0, SEEK_CUR);
+      ret     = savepos;
+
+      if (savepos >= 0)
+        {
+          ret = file_seek(filep, aiocbp[0]->aio_offset, SEEK_SET);
+        }
+
+      if (ret >= 0)
+        {
+          if (op == AIO_OP_READ)
+            {
+              ret = file_readv(filep, iov, nbatch);
+            }
+          else
+            {
+              ret = file_writev(filep, iov, nbatch);
+            }
+
+          pos = file_seek(filep, savepos, SEEK_SET);
+          if (pos < 0 && ret >= 0)
+            {
+              ret = pos;
+            }
+        }
+    }
+
+  if (ret < 0)
+    {
+      ferr("ERROR: Transfer failed: %d\n", (int)ret);
+    }
+
+  /* Each request gets its share of the bytes transferred, in order, and
+   * then the client is signalled.
+   */
+
+  remaining = ret;
+  for (i = 0; i < nbatch; i++)
+    {
+      if (ret < 0)
+        {
+          aiocbp[i]->aio_result = ret;
+        }
+      else if ((size_t)remaining > aiocbp[i]->aio_nbytes)
+        {
+          aiocbp[i]->aio_result = aiocbp[i]->aio_nbytes;
+          remaining -= aiocbp[i]->aio_nbytes;
+        }
+      else
+        {
+          aiocbp[i]->aio_result = remaining;
+          remaining = 0;
+        }
+
+      (void)aio_signal(pid[i], aiocbp[i]);
+      aio_complete(qtime[i]);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: aio_thread
+ *
+ * Description:
+ *   This is the main loop of each AIO worker thread.  It performs the
+ *   oldest I/O that is not blocked behind I/O on another worker thread and
+ *   waits for more I/O to be queued when there is none.
+ *
+ * Input Parameters:
+ *   argc, argv (not used)
+ *
+ * Returned Value:
+ *   Does not return
+ *
+ ****************************************************************************/
+
+static int aio_thread(int argc, FAR char *argv[])
+{
+  FAR struct aio_container_s *batch[CONFIG_FS_AIO_NMERGE];
+  systime_t qtime;
+  pid_t me = getpid();
+  int nbatch;
+  int wndx;
+
+  /* Find our thread index by searching the AIO workers */
+
+  for (wndx = 0; wndx < CONFIG_FS_AIO_NTHREADS; wndx++)
+    {
+      if (g_aio_worker[wndx].aw_pid == me)
+        {
+          break;
+        }
+    }
+
+  DEBUGASSERT(wndx < CONFIG_FS_AIO_NTHREADS);
+
+  for (; ; )
+    {
+      aio_lock();
+      nbatch = aio_dispatch(wndx, batch);
+      if (nbatch == 0)
+        {
+#ifdef CONFIG_PRIORITY_INHERITANCE
+          /* There is nothing more to do.  Drop any priority boost. */
+
+          aio_restorepriority();
+#endif
+          aio_unlock();
+
+          /* Wait for more I/O to be queued */
+
+          (void)nxsem_wait(&g_aio_worksem);
+          continue;
+        }
+
+      aio_unlock();
+
+      /* Perform the I/O */
+
+#ifdef AIO_HAVE_FILEP
+      if (nbatch > 1)
+        {
+          aio_transfer(batch, nbatch);
+        }
+      else
+#endif
+        {
+          qtime = batch[0]->aioc_qtime;
+          batch[0]->aioc_worker(batch[0]);
+          aio_complete(qtime);
+        }
+
+      /* I/O on this file or socket may now be started by any worker */
+
+      aio_lock();
+      g_aio_worker[wndx].aw_busy = NULL;
+      aio_unlock();
+    }
+
+  return OK; /* To keep some compilers happy */
+}
+
+/****************************************************************************
+ * Name: aio_start
+ *
+ * Description:
+ *   Start the AIO worker threads.  The caller must hold the lock on the
+ *   pending I/O list.
+ *
+ *   If not all of the worker threads can be created, then the I/O is
+ *   performed by those that were.  The PID of the others is left zero.
+ *   Failure is reported only if not even the first worker thread could be
+ *   created;  the start is then retried when the next I/O is queued.
+ *
+ ****************************************************************************/
+
+static int aio_start(void)
+{
+  pid_t pid;
+  int wndx;
+
+  (void)nxsem_init(&g_aio_worksem, 0, 0);
+
+  /* This semaphore is used for signaling and, hence, should not have
+   * priority inheritance enabled.
+   */
+
+  (void)nxsem_setprotocol(&g_aio_worksem, SEM_PRIO_NONE);
+
+  /* Don't permit any of the threads to run until all have been started */
+
+  sched_lock();
+
+  for (wndx = 0; wndx < CONFIG_FS_AIO_NTHREADS; wndx++)
+    {
+      pid = kthread_create("aio", CONFIG_FS_AIO_PRIORITY,
+                           CONFIG_FS_AIO_STACKSIZE,
+                           (main_t)aio_thread,
+                           (FAR char * const *)NULL);
+      if (pid < 0)
+        {
+          ferr("ERROR: kthread_create %d failed: %d\n", wndx, (int)pid);
+          if (wndx == 0)
+            {
+              sched_unlock();
+              (void)nxsem_destroy(&g_aio_worksem);
+              return (int)pid;
+            }
+
+          break;
+        }
+
+      g_aio_worker[wndx].aw_pid = pid;
+    }
+
+  sched_unlock();
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
 /****************************************************************************
  * Name: aio_queue
  *
  * Description:
- *   Schedule the asynchronous I/O on the low priority work queue
+ *   Add the asynchronous I/O to the pending list and wake up an AIO worker
+ *   thread to perform it.  The AIO worker threads are started when the
+ *   first I/O is queued.
+ *
+ *   lio_listio() queues its list of I/O with the scheduler locked so the
+ *   worker threads find the whole list pending when they run and adjacent
+ *   requests in it can be combined.
  *
  * Input Parameters:
- *   arg - Worker argument.  In this case, a pointer to an instance of
- *     struct aiocb cast to void *.
+ *   aioc   - The AIO control block container
+ *   op     - The operation type.  See AIO_OP_* definitions.
+ *   worker - The function that performs the I/O on the worker thread.
  *
  * Returned Value:
  *   Zero (OK) on success.  Otherwise, -1 is returned and the errno is set
@@ -70,41 +580,158 @@
  *
  ****************************************************************************/
 
-int aio_queue(FAR struct aio_container_s *aioc, worker_t worker)
+int aio_queue(FAR struct aio_container_s *aioc, uint8_t op, worker_t worker)
 {
   int ret;
 
-#ifdef CONFIG_PRIORITY_INHERITANCE
-  /* Prohibit context switches until we complete the queuing */
+  aio_lock();
 
-  sched_lock();
+  /* Start the worker threads if this is the first I/O */
+
+  if (g_aio_worker[0].aw_pid == 0)
+    {
+      ret = aio_start();
+      if (ret < 0)
+        {
+          FAR struct aiocb *aiocbp = aioc_decant(aioc);
 
-  /* Make sure that the low-priority worker thread is running at at least
-   * the priority specified for this action.
+          aio_unlock();
+          aiocbp->aio_result = ret;
+          set_errno(-ret);
+          return ERROR;
+        }
+    }
+
+  aioc->aioc_op     = op;
+  aioc->aioc_worker = worker;
+  aioc->aioc_qtime  = clock_systimer();
+
+  /* Add the container to the pending transfer list. */
+
+  dq_addlast(&aioc->aioc_link, &g_aio_pending);
+
+  g_aio_stats.as_submitted++;
+  if (++g_aio_stats.as_depth > g_aio_stats.as_maxdepth)
+    {
+      g_aio_stats.as_maxdepth = g_aio_stats.as_depth;
+    }
+
+#ifdef CONFIG_PRIORITY_INHERITANCE
+  /* Make sure that the worker threads are running at at least the
+   * priority of the waiting task.
    */
 
-  lpwork_boostpriority(aioc->aioc_prio);
+  aio_boostpriority(aioc->aioc_prio);
 #endif
 
-  /* Schedule the work on the low priority worker thread */
+  aio_unlock();
 
-  ret = work_queue(LPWORK, &aioc->aioc_work, worker, aioc, 0);
-  if (ret < 0)
+  /* Wake up a worker thread */
+
+  nxsem_post(&g_aio_worksem);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: aio_dequeue
+ *
+ * Description:
+ *   Remove I/O that has not yet been started from the pending list.  The
+ *   caller must hold the lock on the pending I/O list.
+ *
+ * Input Parameters:
+ *   aioc - The AIO control block container
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void aio_dequeue(FAR struct aio_container_s *aioc)
+{
+  dq_rem(&aioc->aioc_link, &g_aio_pending);
+  g_aio_stats.as_depth--;
+}
+
+/****************************************************************************
+ * Name: aio_busy
+ *
+ * Description:
+ *   Return true if an AIO worker thread is performing I/O on the file or
+ *   socket referred to by fildes.  The caller must hold the lock on the
+ *   pending I/O list.
+ *
+ * Input Parameters:
+ *   fildes - The file or socket descriptor
+ *
+ * Returned Value:
+ *   True if I/O on fildes is in progress.
+ *
+ ****************************************************************************/
+
+bool aio_busy(int fildes)
+{
+  FAR void *ptr = NULL;
+  int wndx;
+
+#if defined(AIO_HAVE_FILEP) && defined(AIO_HAVE_PSOCK)
+  if (fildes < CONFIG_NFILE_DESCRIPTORS)
+#endif
+#ifdef AIO_HAVE_FILEP
     {
-      FAR struct aiocb *aiocbp = aioc->aioc_aiocbp;
-      DEBUGASSERT(aiocbp);
+      FAR struct file *filep;
 
-      aiocbp->aio_result = ret;
-      set_errno(-ret);
-      ret = ERROR;
+      if (fs_getfilep(fildes, &filep) >= 0)
+        {
+          ptr = filep;
+        }
+    }
+#endif
+#if defined(AIO_HAVE_FILEP) && defined(AIO_HAVE_PSOCK)
+  else
+#endif
+#ifdef AIO_HAVE_PSOCK
+    {
+      ptr = sockfd_socket(fildes);
     }
+#endif
 
-#ifdef CONFIG_PRIORITY_INHERITANCE
-  /* Now the low-priority work queue might run at its new priority */
+  if (ptr == NULL)
+    {
+      return false;
+    }
 
-  sched_unlock();
-#endif
-  return ret;
+  for (wndx = 0; wndx < CONFIG_FS_AIO_NTHREADS; wndx++)
+    {
+      if (g_aio_worker[wndx].aw_busy == ptr)
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: aio_stats
+ *
+ * Description:
+ *   Return a snapshot of the AIO queue depth and latency statistics.
+ *   Latencies are in units of system clock ticks.
+ *
+ * Input Parameters:
+ *   stats - Location to return the statistics
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void aio_stats(FAR struct aio_stats_s *stats)
+{
+  aio_lock();
+  memcpy(stats, &g_aio_stats, sizeof(struct aio_stats_s));
+  aio_unlock();
 }
 
 #endif /* CONFIG_FS_AIO */
@@ -144,11 +144,10 @@ FAR struct aio_container_s *aio_contain(FAR struct aiocb *aiocbp)
   aioc->aioc_prio = param.sched_priority;
 #endif
 
-  /* Add the container to the pending transfer list. */
+  /* The container will be added to the pending transfer list by
+   * aio_queue().
+   */
 
-  aio_lock();
-  dq_addlast(&aioc->aioc_link, &g_aio_pending);
-  aio_unlock();
   return aioc;
 
 errout:
@@ -161,7 +160,8 @@ errout:
  *
  * Description:
  *   Remove the AIO control block from the container and free all resources
- *   used by the container.
+ *   used by the container.  The container must already have been removed
+ *   from the pending list.
  *
  * Input Parameters:
  *   aioc - Pointer to the AIO control block container
@@ -177,12 +177,9 @@ FAR struct aiocb *aioc_decant(FAR struct aio_container_s *aioc)
 
   DEBUGASSERT(aioc);
 
-  /* Remove the container to the pending transfer list. */
+  /* De-cant the AIO control block and return the container to the free list */
 
   aio_lock();
-  dq_rem(&aioc->aioc_link, &g_aio_pending);
-
-  /* De-cant the AIO control block and return the container to the free list */
 
   aiocbp = aioc->aioc_aiocbp;
   aioc_free(aioc);
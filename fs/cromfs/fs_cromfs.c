@@ -47,12 +47,16 @@
 #include <stdbool.h>
 #include <string.h>
 #include <fcntl.h>
+#include <semaphore.h>
+#include <queue.h>
 #include <lzf.h>
 #include <assert.h>
 #include <errno.h>
 #include <debug.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/wqueue.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/dirent.h>
 #include <nuttx/fs/ioctl.h>
@@ -62,6 +66,26 @@
 
 #if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_CROMFS)
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Configuration ************************************************************/
+
+#ifndef CONFIG_FS_CROMFS_NCACHE
+#  define CONFIG_FS_CROMFS_NCACHE 4
+#endif
+
+#ifdef CONFIG_FS_CROMFS_READAHEAD
+#  if defined(CONFIG_SCHED_LPWORK)
+#    define CROMFS_WORK LPWORK
+#  elif defined(CONFIG_SCHED_HPWORK)
+#    define CROMFS_WORK HPWORK
+#  else
+#    error Read-ahead requires CONFIG_SCHED_WORKQUEUE
+#  endif
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -71,9 +95,34 @@
 struct cromfs_file_s
 {
   FAR const struct cromfs_node_s *ff_node;  /* The open file node */
-  uint32_t ff_offset;                       /* Cached block offset (zero means none) */
-  uint16_t ff_ulen;                         /* Length of decompressed data in cache */
-  FAR uint8_t *ff_buffer;                   /* Cached, decompressed data */
+};
+
+/* This structure describes one decompressed block in the block cache */
+
+struct cromfs_cblock_s
+{
+  dq_entry_t cb_link;                       /* Supports a doubly linked list */
+  uint32_t cb_offset;                       /* Volume offset of the compressed
+                                             * data (zero means none) */
+  uint16_t cb_ulen;                         /* Length of decompressed data */
+  FAR uint8_t *cb_buffer;                   /* Decompressed data */
+};
+
+/* This structure describes the cache of decompressed blocks.  It is shared
+ * by all open files.
+ */
+
+struct cromfs_cache_s
+{
+  sem_t cc_sem;                             /* Assures mutually exclusive access */
+  uint16_t cc_nmounts;                      /* Number of mounts sharing the cache */
+  dq_queue_t cc_lru;                        /* Blocks, most recently used first */
+  FAR uint8_t *cc_buffer;                   /* Memory for decompressed data */
+  struct cromfs_cblock_s cc_blocks[CONFIG_FS_CROMFS_NCACHE];
+#ifdef CONFIG_FS_CROMFS_READAHEAD
+  struct work_s cc_work;                    /* Supports read-ahead */
+  FAR const struct lzf_header_s *cc_rahdr;  /* Next block to decompress */
+#endif
 };
 
 /* This is the form of the callback from cromfs_foreach_node(): */
@@ -115,6 +164,16 @@ static int      cromfs_comparenode(FAR const struct cromfs_volume_s *fs,
 static int      cromfs_findnode(FAR const struct cromfs_volume_s *fs,
                                 FAR const struct cromfs_node_s **node,
                                 FAR const char *relpath);
+static void     cromfs_semtake(void);
+static void     cromfs_semgive(void);
+static FAR struct cromfs_cblock_s *
+                cromfs_getblock(FAR const struct cromfs_volume_s *fs,
+                                FAR const uint8_t *src, uint16_t clen);
+#ifdef CONFIG_FS_CROMFS_READAHEAD
+static void     cromfs_readahead_worker(FAR void *arg);
+static void     cromfs_readahead(FAR const struct cromfs_volume_s *fs,
+                                 FAR const struct lzf_header_s *hdr);
+#endif
 
 /* Common file system methods */
 
@@ -194,6 +253,20 @@ const struct mountpt_operations cromfs_operations =
 
 extern const struct cromfs_volume_s g_cromfs_image;
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The cache of decompressed blocks.  Since there can only be a single
+ * CROMFS file system image, there is also only a single cache.  It is
+ * created when the file system is first mounted.
+ */
+
+static struct cromfs_cache_s g_cromfs_cache =
+{
+  SEM_INITIALIZER(1)
+};
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -478,6 +551,164 @@ static int cromfs_findnode(FAR const struct cromfs_volume_s *fs,
     }
 }
 
+/****************************************************************************
+ * Name: cromfs_semtake and cromfs_semgive
+ ****************************************************************************/
+
+static void cromfs_semtake(void)
+{
+  int ret;
+
+  do
+    {
+      /* Take the semaphore (perhaps waiting) */
+
+      ret = nxsem_wait(&g_cromfs_cache.cc_sem);
+
+      /* The only case that an error should occur here is if the wait was
+       * awakened by a signal.
+       */
+
+      DEBUGASSERT(ret == OK || ret == -EINTR);
+    }
+  while (ret == -EINTR);
+}
+
+static void cromfs_semgive(void)
+{
+  nxsem_post(&g_cromfs_cache.cc_sem);
+}
+
+/****************************************************************************
+ * Name: cromfs_getblock
+ *
+ * Description:
+ *   Return the cache block holding the decompressed data of the compressed
+ *   block at 'src'.  If the block is not in the cache, then the least
+ *   recently used cache block is replaced.  The caller must hold the cache
+ *   semaphore.
+ *
+ * Returned Value:
+ *   The cache block or NULL if the data could not be decompressed.
+ *
+ ****************************************************************************/
+
+static FAR struct cromfs_cblock_s *
+  cromfs_getblock(FAR const struct cromfs_volume_s *fs,
+                  FAR const uint8_t *src, uint16_t clen)
+{
+  FAR struct cromfs_cblock_s *blk;
+  unsigned int decomplen;
+  uint32_t voloffs;
+
+  /* Check if we already have the decompressed data in the cache */
+
+  voloffs = cromfs_addr2offset(fs, src);
+
+  for (blk = (FAR struct cromfs_cblock_s *)g_cromfs_cache.cc_lru.head;
+       blk != NULL;
+       blk = (FAR struct cromfs_cblock_s *)blk->cb_link.flink)
+    {
+      if (blk->cb_offset == voloffs)
+        {
+          break;
+        }
+    }
+
+  if (blk == NULL)
+    {
+      /* No.. replace the least recently used block */
+
+      blk = (FAR struct cromfs_cblock_s *)g_cromfs_cache.cc_lru.tail;
+      DEBUGASSERT(blk != NULL);
+
+      decomplen = lzf_decompress(src, clen, blk->cb_buffer, fs->cv_bsize);
+      if (decomplen == 0)
+        {
+          ferr("ERROR: lzf_decompress failed at %lu\n",
+               (unsigned long)voloffs);
+          blk->cb_offset = 0;
+          return NULL;
+        }
+
+      blk->cb_offset = voloffs;
+      blk->cb_ulen   = decomplen;
+    }
+
+  /* Make this the most recently used block */
+
+  dq_rem(&blk->cb_link, &g_cromfs_cache.cc_lru);
+  dq_addfirst(&blk->cb_link, &g_cromfs_cache.cc_lru);
+  return blk;
+}
+
+/****************************************************************************
+ * Name: cromfs_readahead_worker
+ *
+ * Description:
+ *   Decompress the next block of a file into the cache on the work queue
+ *   so that it is already available when the file is next read.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_CROMFS_READAHEAD
+static void cromfs_readahead_worker(FAR void *arg)
+{
+  FAR const struct cromfs_volume_s *fs =
+    (FAR const struct cromfs_volume_s *)arg;
+  FAR const struct lzf_type1_header_s *hdr1;
+  uint16_t clen;
+
+  cromfs_semtake();
+
+  /* The file system may have been unmounted while the work was pending */
+
+  if (g_cromfs_cache.cc_nmounts > 0 && g_cromfs_cache.cc_rahdr != NULL)
+    {
+      hdr1 = (FAR const struct lzf_type1_header_s *)g_cromfs_cache.cc_rahdr;
+      clen = (uint16_t)hdr1->lzf_clen[0] << 8 |
+             (uint16_t)hdr1->lzf_clen[1];
+
+      (void)cromfs_getblock(fs, (FAR const uint8_t *)hdr1 +
+                            LZF_TYPE1_HDR_SIZE, clen);
+      g_cromfs_cache.cc_rahdr = NULL;
+    }
+
+  cromfs_semgive();
+}
+#endif
+
+/****************************************************************************
+ * Name: cromfs_readahead
+ *
+ * Description:
+ *   Schedule decompression of the compressed block 'hdr' on the work queue.
+ *   Nothing is done if the block is stored uncompressed or if read-ahead of
+ *   another block is still pending.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_CROMFS_READAHEAD
+static void cromfs_readahead(FAR const struct cromfs_volume_s *fs,
+                             FAR const struct lzf_header_s *hdr)
+{
+  if (hdr->lzf_type != LZF_TYPE1_HDR)
+    {
+      return;
+    }
+
+  cromfs_semtake();
+  if (work_available(&g_cromfs_cache.cc_work))
+    {
+      g_cromfs_cache.cc_rahdr = hdr;
+      (void)work_queue(CROMFS_WORK, &g_cromfs_cache.cc_work,
+                       cromfs_readahead_worker, (FAR void *)fs, 0);
+    }
+
+  cromfs_semgive();
+}
+#endif
+
 /****************************************************************************
  * Name: cromfs_open
  ****************************************************************************/
@@ -546,15 +777,6 @@ static int cromfs_open(FAR struct file *filep, FAR const char *relpath,
       return -ENOMEM;
     }
 
-  /* Create a file buffer to support partial sector accesses */
-
-  ff->ff_buffer = (FAR uint8_t *)kmm_malloc(fs->cv_bsize);
-  if (!ff->ff_buffer)
-    {
-      kmm_free(ff);
-      return -ENOMEM;
-    }
-
   /* Save the node in the open file instance */
 
   ff->ff_node = node;
@@ -579,11 +801,10 @@ static int cromfs_close(FAR struct file *filep)
   /* Get the open file instance from the file structure */
 
   ff = filep->f_priv;
-  DEBUGASSERT(ff->ff_node != NULL && ff->ff_buffer != NULL);
+  DEBUGASSERT(ff->ff_node != NULL);
 
   /* Free all resources consumed by the opened file */
 
-  kmm_free(ff->ff_buffer);
   kmm_free(ff);
 
   return OK;
@@ -625,7 +846,7 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
   /* Get the open file instance from the file structure */
 
   ff = (FAR struct cromfs_file_s *)filep->f_priv;
-  DEBUGASSERT(ff->ff_node != NULL && ff->ff_buffer != NULL);
+  DEBUGASSERT(ff->ff_node != NULL);
 
   /* Check for a read past the end of the file */
 
@@ -728,82 +949,43 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
         }
       else
         {
-          /* If the source of the data is at the beginning of the compressed
-           * data buffer and if the uncompressed data would not overrun the
-           * buffer, then we can decompress directly into the user buffer.
-           */
-
-          if (filep->f_pos <= blkoffs && ulen <= remaining)
-            {
-              uint32_t voloffs;
-
-              copyoffs = 0;
-              copysize = ulen;
-
-              /* Get the address and offset in the CROMFS image to obtain
-               * the data.  Check if we already have this offset in the
-               * cache.
-               */
+          FAR struct cromfs_cblock_s *blk;
 
-              src     = (FAR const uint8_t *)currhdr + LZF_TYPE1_HDR_SIZE;
-              voloffs = cromfs_addr2offset(fs, src);
-              if (voloffs != ff->ff_offset)
-                {
-                  unsigned int decomplen;
-
-                  decomplen = lzf_decompress(src, clen, dest, fs->cv_bsize);
+          /* The data is compressed.  Get the decompressed block from the
+           * cache, decompressing it only if it is not already there.
+           */
 
-                  ff->ff_offset = voloffs;
-                  ff->ff_ulen   = decomplen;
-                }
+          copyoffs = (blkoffs >= filep->f_pos) ? 0 : filep->f_pos - blkoffs;
+          DEBUGASSERT(ulen > copyoffs);
+          copysize = ulen - copyoffs;
 
-              finfo("voloffs=%lu blkoffs=%lu ulen=%u ff_offset=%u copysize=%u\n",
-                    (unsigned long)voloffs, (unsigned long)blkoffs, ulen,
-                    ff->ff_offset, copysize);
-              DEBUGASSERT(ff->ff_ulen >= copysize);
-            }
-          else
+          if (copysize > remaining)  /* Clip to the size really needed */
             {
-              uint32_t voloffs;
-
-              /* No, we will need to decompress into the our intermediate
-               * decompression buffer.
-               */
-
-              copyoffs = (blkoffs >= filep->f_pos) ? 0 : filep->f_pos - blkoffs;
-              DEBUGASSERT(ulen > copyoffs);
-              copysize = ulen - copyoffs;
-
-              if (copysize > remaining)  /* Clip to the size really needed */
-                {
-                  copysize = remaining;
-                }
-
-              DEBUGASSERT((copyoffs + copysize) <=  fs->cv_bsize);
+              copysize = remaining;
+            }
 
-              src = (FAR const uint8_t *)currhdr + LZF_TYPE1_HDR_SIZE;
-              voloffs = cromfs_addr2offset(fs, src);
-              if (voloffs != ff->ff_offset)
-                {
-                  unsigned int decomplen;
+          DEBUGASSERT((copyoffs + copysize) <=  fs->cv_bsize);
 
-                  decomplen = lzf_decompress(src, clen, ff->ff_buffer,
-                                             fs->cv_bsize);
+          src = (FAR const uint8_t *)currhdr + LZF_TYPE1_HDR_SIZE;
 
-                  ff->ff_offset = voloffs;
-                  ff->ff_ulen   = decomplen;
-                }
+          cromfs_semtake();
+          blk = cromfs_getblock(fs, src, clen);
+          if (blk == NULL)
+            {
+              cromfs_semgive();
+              return -EIO;
+            }
 
-              finfo("voloffs=%lu blkoffs=%lu ulen=%u clen=%u ff_offset=%u "
-                    "copyoffs=%u copysize=%u\n",
-                    (unsigned long)voloffs, (unsigned long)blkoffs, ulen,
-                    clen, ff->ff_offset, copyoffs, copysize);
-              DEBUGASSERT(ff->ff_ulen >= (copyoffs + copysize));
+          finfo("voloffs=%lu blkoffs=%lu ulen=%u clen=%u "
+                "copyoffs=%u copysize=%u\n",
+                (unsigned long)blk->cb_offset, (unsigned long)blkoffs,
+                ulen, clen, copyoffs, copysize);
+          DEBUGASSERT(blk->cb_ulen >= (copyoffs + copysize));
 
-              /* Then copy to user buffer */
+          /* Then copy to user buffer */
 
-              memcpy(dest, &ff->ff_buffer[copyoffs], copysize);
-            }
+          memcpy(dest, &blk->cb_buffer[copyoffs], copysize);
+          cromfs_semgive();
         }
 
       /* Adjust pointers counts and offset */
@@ -813,6 +995,17 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
       fpos      += copysize;
     }
 
+#ifdef CONFIG_FS_CROMFS_READAHEAD
+  /* Start decompressing the block following the last one read, if there
+   * is one.
+   */
+
+  if (buflen > 0 && blkoffs + ulen < ff->ff_node->cn_size)
+    {
+      cromfs_readahead(fs, nexthdr);
+    }
+#endif
+
   /* Update the file pointer */
 
   filep->f_pos = fpos;
@@ -842,7 +1035,6 @@ static int cromfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
 static int cromfs_dup(FAR const struct file *oldp, FAR struct file *newp)
 {
-  FAR struct cromfs_volume_s *fs;
   FAR struct cromfs_file_s *oldff;
   FAR struct cromfs_file_s *newff;
 
@@ -850,15 +1042,10 @@ static int cromfs_dup(FAR const struct file *oldp, FAR struct file *newp)
   DEBUGASSERT(oldp->f_priv != NULL && oldp->f_inode != NULL &&
               newp->f_priv == NULL && newp->f_inode != NULL);
 
-  /* Recover our private data from the struct file instance */
-
-  fs = (FAR struct cromfs_volume_s *)oldp->f_inode->i_private;
-  DEBUGASSERT(fs != NULL);
-
   /* Get the open file instance from the file structure */
 
   oldff = oldp->f_priv;
-  DEBUGASSERT(oldff->ff_node != NULL && oldff->ff_buffer != NULL);
+  DEBUGASSERT(oldff->ff_node != NULL);
 
   /* Allocate and initialize an new open file instance referring to the
    * same node.
@@ -870,15 +1057,6 @@ static int cromfs_dup(FAR const struct file *oldp, FAR struct file *newp)
       return -ENOMEM;
     }
 
-  /* Create a file buffer to support partial sector accesses */
-
-  newff->ff_buffer = (FAR uint8_t *)kmm_malloc(fs->cv_bsize);
-  if (newff->ff_buffer == NULL)
-    {
-      kmm_free(newff);
-      return -ENOMEM;
-    }
-
   /* Save the node in the open file instance */
 
   newff->ff_node = oldff->ff_node;
@@ -915,7 +1093,7 @@ static int cromfs_fstat(FAR const struct file *filep, FAR struct stat *buf)
    */
 
   ff              = filep->f_priv;
-  DEBUGASSERT(ff->ff_node != NULL && ff->ff_buffer != NULL);
+  DEBUGASSERT(ff->ff_node != NULL);
 
   inode           = filep->f_inode;
   fs              = inode->i_private;
@@ -1102,6 +1280,37 @@ static int cromfs_bind(FAR struct inode *blkdriver, const void *data,
   DEBUGASSERT(blkdriver == NULL && handle != NULL);
   DEBUGASSERT(g_cromfs_image.cv_magic == CROMFS_MAGIC);
 
+  /* Create the block cache when the file system is first mounted */
+
+  cromfs_semtake();
+  if (g_cromfs_cache.cc_nmounts == 0)
+    {
+      int i;
+
+      g_cromfs_cache.cc_buffer = (FAR uint8_t *)
+        kmm_malloc(CONFIG_FS_CROMFS_NCACHE * g_cromfs_image.cv_bsize);
+      if (g_cromfs_cache.cc_buffer == NULL)
+        {
+          cromfs_semgive();
+          return -ENOMEM;
+        }
+
+      dq_init(&g_cromfs_cache.cc_lru);
+      for (i = 0; i < CONFIG_FS_CROMFS_NCACHE; i++)
+        {
+          FAR struct cromfs_cblock_s *blk = &g_cromfs_cache.cc_blocks[i];
+
+          blk->cb_offset = 0;
+          blk->cb_ulen   = 0;
+          blk->cb_buffer = &g_cromfs_cache.cc_buffer[i *
+                                                     g_cromfs_image.cv_bsize];
+          dq_addlast(&blk->cb_link, &g_cromfs_cache.cc_lru);
+        }
+    }
+
+  g_cromfs_cache.cc_nmounts++;
+  cromfs_semgive();
+
   /* Return the new file system handle */
 
   *handle = (FAR void *)&g_cromfs_image;
@@ -1121,6 +1330,23 @@ static int cromfs_unbind(FAR void *handle, FAR struct inode **blkdriver,
 {
   finfo("handle: %p blkdriver: %p flags: %02x\n",
         handle, blkdriver, flags);
+
+  /* Free the block cache when the last mount is removed */
+
+  cromfs_semtake();
+  DEBUGASSERT(g_cromfs_cache.cc_nmounts > 0);
+
+  if (--g_cromfs_cache.cc_nmounts == 0)
+    {
+#ifdef CONFIG_FS_CROMFS_READAHEAD
+      (void)work_cancel(CROMFS_WORK, &g_cromfs_cache.cc_work);
+      g_cromfs_cache.cc_rahdr = NULL;
+#endif
+      kmm_free(g_cromfs_cache.cc_buffer);
+      g_cromfs_cache.cc_buffer = NULL;
+    }
+
+  cromfs_semgive();
   return OK;
 }
 
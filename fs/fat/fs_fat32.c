@@ -349,6 +349,12 @@ static int fat_open(FAR struct file *filep, FAR const char *relpath,
   ff->ff_sectorsincluster = fs->fs_fatsecperclus;
   ff->ff_size             = DIR_GETFILESIZE(direntry);
 
+  /* Set up the cluster run map, re-using the map kept from the last time
+   * that the file was open if there is one.
+   */
+
+  fat_openruns(fs, ff);
+
   /* Attach the private date to the struct file instance */
 
   filep->f_priv = ff;
@@ -459,6 +465,25 @@ static int fat_close(FAR struct file *filep)
       fat_io_free(ff->ff_buffer, fs->fs_hwsectorsize);
     }
 
+  /* Keep or free the cluster run map.  Nothing can be kept if the volume
+   * has been unmounted.  Otherwise, the run hints in the mountpoint are
+   * shared with fat_openruns() and fat_runsupdate() and must only be
+   * modified while holding the mountpoint semaphore.
+   */
+
+#if CONFIG_FAT_NCLUSTERRUNS > 0
+  if ((ff->ff_bflags & UMOUNT_FORCED) == 0)
+    {
+      fat_semtake(fs);
+      fat_closeruns(fs, ff);
+      fat_semgive(fs);
+    }
+  else
+    {
+      fat_closeruns(NULL, ff);
+    }
+#endif
+
   /* Then free the file structure itself. */
 
   kmm_free(ff);
@@ -586,6 +611,7 @@ static ssize_t fat_read(FAR struct file *filep, FAR char *buffer,
           ff->ff_currentcluster   = cluster;
           ff->ff_currentsector    = fat_cluster2sector(fs, cluster);
           ff->ff_sectorsincluster = fs->fs_fatsecperclus;
+          fat_addrunpos(fs, ff, filep->f_pos, cluster);
         }
 
 #ifdef CONFIG_FAT_DIRECT_RETRY /* Warning avoidance */
@@ -793,6 +819,7 @@ static ssize_t fat_write(FAR struct file *filep, FAR const char *buffer,
           ff->ff_startcluster     = fat_createchain(fs);
           ff->ff_currentcluster   = ff->ff_startcluster;
           ff->ff_sectorsincluster = fs->fs_fatsecperclus;
+          fat_addrunpos(fs, ff, 0, ff->ff_startcluster);
         }
 
       /* The current sector can then be determined from the current cluster
@@ -846,6 +873,7 @@ static ssize_t fat_write(FAR struct file *filep, FAR const char *buffer,
           ff->ff_currentcluster   = cluster;
           ff->ff_sectorsincluster = fs->fs_fatsecperclus;
           ff->ff_currentsector    = fat_cluster2sector(fs, cluster);
+          fat_addrunpos(fs, ff, filep->f_pos, cluster);
         }
 
 #ifdef CONFIG_FAT_DIRECT_RETRY /* Warning avoidance */
@@ -1020,6 +1048,11 @@ static off_t fat_seek(FAR struct file *filep, off_t offset, int whence)
   int32_t cluster;
   off_t position;
   unsigned int clustersize;
+#if CONFIG_FAT_NCLUSTERRUNS > 0
+  uint32_t clusterndx;
+  uint32_t runndx;
+  uint32_t runcluster;
+#endif
   int ret;
 
   /* Sanity checks */
@@ -1145,6 +1178,22 @@ static off_t fat_seek(FAR struct file *filep, off_t offset, int whence)
        */
 
       clustersize = fs->fs_fatsecperclus * fs->fs_hwsectorsize;
+
+#if CONFIG_FAT_NCLUSTERRUNS > 0
+      /* Skip as much of the chain as the cluster run map already knows */
+
+      runndx     = position / clustersize;
+      runcluster = fat_findrun(ff, &runndx);
+      if (runcluster != 0)
+        {
+          cluster       = runcluster;
+          filep->f_pos  = (off_t)runndx * clustersize;
+          position     -= filep->f_pos;
+        }
+
+      clusterndx = runcluster != 0 ? runndx : 0;
+#endif
+
       for (; ; )
         {
           /* Skip over clusters prior to the one containing
@@ -1152,6 +1201,9 @@ static off_t fat_seek(FAR struct file *filep, off_t offset, int whence)
            */
 
           ff->ff_currentcluster = cluster;
+#if CONFIG_FAT_NCLUSTERRUNS > 0
+          fat_addrun(ff, clusterndx, cluster);
+#endif
           if (position < clustersize)
             {
               break;
@@ -1215,6 +1267,9 @@ static off_t fat_seek(FAR struct file *filep, off_t offset, int whence)
 
           filep->f_pos += clustersize;
           position     -= clustersize;
+#if CONFIG_FAT_NCLUSTERRUNS > 0
+          clusterndx++;
+#endif
         }
 
       /* We get here after we have found the sector containing
@@ -1508,6 +1563,10 @@ static int fat_dup(FAR const struct file *oldp, FAR struct file *newp)
   newff->ff_currentsector    = oldff->ff_currentsector;    /* Current sector */
   newff->ff_cachesector      = 0;                          /* Sector in file buffer */
 
+  /* The new file gets its own cluster run map */
+
+  fat_openruns(fs, newff);
+
   /* Attach the private date to the struct file instance */
 
   newp->f_priv = newff;
@@ -2191,9 +2250,10 @@ static int fat_unbind(FAR void *handle, FAR struct inode **blkdriver,
 
   if (fs->fs_buffer)
     {
-      fat_io_free(fs->fs_buffer, fs->fs_hwsectorsize);
+      fat_io_free(FAT_CACHEBASE(fs), FAT_CACHESIZE(fs));
     }
 
+  fat_freeruns(fs);
   nxsem_destroy(&fs->fs_sem);
   kmm_free(fs);
   return OK;
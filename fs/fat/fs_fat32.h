@@ -720,10 +720,86 @@
 #  define fat_io_free(m,s) kmm_free(m)
 #endif
 
+/****************************************************************************
+ * Mountpoint sector cache and per-file cluster run map
+ *
+ * The mountpoint holds CONFIG_FAT_NCACHESECTORS sectors of FAT table and
+ * directory data in one I/O buffer allocation.  fs_buffer always refers to
+ * the sector that was most recently requested with fat_fscacheread().
+ *
+ * Each open file may map up to CONFIG_FAT_NCLUSTERRUNS runs of contiguous
+ * clusters so that fat_seek() need not follow the whole FAT chain from the
+ * start of the file.  Up to CONFIG_FAT_NRUNHINTS maps are kept after their
+ * files are closed so that the chain need not be followed again when the
+ * file is re-opened.
+ */
+
+#ifndef CONFIG_FAT_NCACHESECTORS
+#  define CONFIG_FAT_NCACHESECTORS 1
+#endif
+
+#ifndef CONFIG_FAT_NCLUSTERRUNS
+#  define CONFIG_FAT_NCLUSTERRUNS 0
+#endif
+
+#if CONFIG_FAT_NCLUSTERRUNS == 0 || !defined(CONFIG_FAT_NRUNHINTS)
+#  undef  CONFIG_FAT_NRUNHINTS
+#  define CONFIG_FAT_NRUNHINTS 0
+#endif
+
+#define FAT_CACHESIZE(f)   ((f)->fs_hwsectorsize * CONFIG_FAT_NCACHESECTORS)
+
+#if CONFIG_FAT_NCACHESECTORS > 1
+#  define FAT_CACHEBASE(f) ((f)->fs_cache[0].cs_buffer)
+#else
+#  define FAT_CACHEBASE(f) ((f)->fs_buffer)
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
 
+/* This structure describes one sector of the mountpoint sector cache.
+ * The state of the sector currently referenced by fs_buffer is held in
+ * fs_currentsector and fs_dirty; the other fields are brought up to date
+ * when fs_buffer moves to a different sector.
+ */
+
+#if CONFIG_FAT_NCACHESECTORS > 1
+struct fat_cachesect_s
+{
+  off_t    cs_sector;              /* Sector number held in cs_buffer */
+  uint32_t cs_age;                 /* Time of last access (for LRU replacement) */
+  bool     cs_valid;               /* true: cs_buffer holds cs_sector */
+  bool     cs_dirty;               /* true: cs_buffer must be written back */
+  uint8_t *cs_buffer;              /* Sector buffer */
+};
+#endif
+
+/* This structure describes one run of contiguous clusters in a file */
+
+#if CONFIG_FAT_NCLUSTERRUNS > 0
+struct fat_clusterrun_s
+{
+  uint32_t cr_index;               /* Index of the first cluster in the file */
+  uint32_t cr_cluster;             /* First cluster of the run */
+  uint32_t cr_count;               /* Number of clusters in the run */
+};
+
+/* This structure maps the start of a file's cluster chain.  The runs are
+ * in file order and cover clusters 0 through N-1 of the file without gaps.
+ */
+
+struct fat_runmap_s
+{
+  uint32_t rm_startcluster;        /* First cluster of the file */
+  uint16_t rm_nruns;               /* Number of valid entries in rm_runs[] */
+  uint16_t rm_maxruns;             /* Allocated number of entries in rm_runs[] */
+  uint16_t rm_hint;                /* Run found by the last lookup */
+  struct fat_clusterrun_s *rm_runs;
+};
+#endif
+
 /* This structure represents the overall mountpoint state.  An instance of this
  * structure is retained as inode private data on each mountpoint that is
  * mounted with a fat32 filesystem.
@@ -758,6 +834,15 @@ struct fat_mountpt_s
   uint8_t  fs_fatsecperclus;       /* MBR: Sectors per allocation unit: 2**n, n=0..7 */
   uint8_t *fs_buffer;              /* This is an allocated buffer to hold one sector
                                     * from the device */
+#if CONFIG_FAT_NCACHESECTORS > 1
+  uint8_t  fs_cacheslot;           /* Index of the fs_cache[] entry in fs_buffer */
+  uint32_t fs_cacheclock;          /* Incremented on each cache access */
+  struct fat_cachesect_s fs_cache[CONFIG_FAT_NCACHESECTORS];
+#endif
+#if CONFIG_FAT_NRUNHINTS > 0
+  uint8_t  fs_nexthint;            /* Next entry of fs_runhints[] to replace */
+  struct fat_runmap_s fs_runhints[CONFIG_FAT_NRUNHINTS];
+#endif
 };
 
 /* This structure represents on open file under the mountpoint.  An instance
@@ -779,6 +864,9 @@ struct fat_file_s
   off_t    ff_currentsector;       /* Current sector being operated on */
   off_t    ff_cachesector;         /* Current sector in the file buffer */
   uint8_t *ff_buffer;              /* File buffer (for partial sector accesses) */
+#if CONFIG_FAT_NCLUSTERRUNS > 0
+  struct fat_runmap_s ff_runmap;   /* Cluster run map */
+#endif
 };
 
 /* This structure holds the sequence of directory entries used by one
@@ -943,6 +1031,23 @@ EXTERN int    fat_ffcacheflush(struct fat_mountpt_s *fs, struct fat_file_s *ff);
 EXTERN int    fat_ffcacheread(struct fat_mountpt_s *fs, struct fat_file_s *ff, off_t sector);
 EXTERN int    fat_ffcacheinvalidate(struct fat_mountpt_s *fs, struct fat_file_s *ff);
 
+/* Per-file cluster run map */
+
+#if CONFIG_FAT_NCLUSTERRUNS > 0
+EXTERN uint32_t fat_findrun(struct fat_file_s *ff, FAR uint32_t *index);
+EXTERN void   fat_addrun(struct fat_file_s *ff, uint32_t index, uint32_t cluster);
+EXTERN void   fat_addrunpos(struct fat_mountpt_s *fs, struct fat_file_s *ff,
+                            off_t position, uint32_t cluster);
+EXTERN void   fat_openruns(struct fat_mountpt_s *fs, struct fat_file_s *ff);
+EXTERN void   fat_closeruns(struct fat_mountpt_s *fs, struct fat_file_s *ff);
+EXTERN void   fat_freeruns(struct fat_mountpt_s *fs);
+#else
+#  define fat_addrunpos(fs,ff,p,c)
+#  define fat_openruns(fs,ff)
+#  define fat_closeruns(fs,ff)
+#  define fat_freeruns(fs)
+#endif
+
 /* FSINFO sector support */
 
 EXTERN int    fat_updatefsinfo(struct fat_mountpt_s *fs);
@@ -68,6 +68,328 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: fat_writesector
+ *
+ * Description:
+ *   Write one sector from the mountpoint sector cache back to the media.
+ *   If the sector lies in the FAT region, the change is made in every copy
+ *   of the FAT.
+ *
+ ****************************************************************************/
+
+static int fat_writesector(struct fat_mountpt_s *fs, uint8_t *buffer,
+                           off_t sector)
+{
+  int ret;
+
+  /* Write the dirty sector */
+
+  ret = fat_hwwrite(fs, buffer, sector, 1);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Does the sector lie in the FAT region? */
+
+  if (sector >= fs->fs_fatbase &&
+      sector < fs->fs_fatbase + fs->fs_nfatsects)
+    {
+      int i;
+
+      /* Yes, then make the change in the FAT copy as well */
+
+      for (i = fs->fs_fatnumfats; i >= 2; i--)
+        {
+          sector += fs->fs_nfatsects;
+          ret = fat_hwwrite(fs, buffer, sector, 1);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fat_fscachesave
+ *
+ * Description:
+ *   Save the state of the sector referenced by fs_buffer in its cache
+ *   entry.  Callers may have re-purposed fs_buffer for a different sector
+ *   by setting fs_currentsector directly;  any other copy of that sector in
+ *   the cache is then stale and is discarded.
+ *
+ ****************************************************************************/
+
+#if CONFIG_FAT_NCACHESECTORS > 1
+static void fat_fscachesave(struct fat_mountpt_s *fs)
+{
+  FAR struct fat_cachesect_s *cs;
+  int i;
+
+  for (i = 0; i < CONFIG_FAT_NCACHESECTORS; i++)
+    {
+      cs = &fs->fs_cache[i];
+      if (i == fs->fs_cacheslot)
+        {
+          cs->cs_sector = fs->fs_currentsector;
+          cs->cs_dirty  = fs->fs_dirty;
+          cs->cs_valid  = true;
+        }
+      else if (cs->cs_valid && cs->cs_sector == fs->fs_currentsector)
+        {
+          cs->cs_valid  = false;
+          cs->cs_dirty  = false;
+        }
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: fat_fscachecoherent
+ *
+ * Description:
+ *   Keep the mountpoint sector cache coherent with a transfer that did not
+ *   go through the cache.  On a write, cached copies of the written sectors
+ *   are updated.  On a read, dirty cached copies replace the stale data
+ *   that was read from the media.
+ *
+ ****************************************************************************/
+
+#if CONFIG_FAT_NCACHESECTORS > 1
+static void fat_fscachecoherent(struct fat_mountpt_s *fs, uint8_t *buffer,
+                                off_t sector, unsigned int nsectors,
+                                bool write)
+{
+  FAR struct fat_cachesect_s *cs;
+  FAR uint8_t *cached;
+  FAR uint8_t *xfer;
+  off_t cachedsector;
+  bool dirty;
+  int i;
+
+  for (i = 0; i < CONFIG_FAT_NCACHESECTORS; i++)
+    {
+      cs = &fs->fs_cache[i];
+
+      /* The entry in fs_buffer is described by fs_currentsector and
+       * fs_dirty.
+       */
+
+      if (i == fs->fs_cacheslot)
+        {
+          cached       = fs->fs_buffer;
+          cachedsector = fs->fs_currentsector;
+          dirty        = fs->fs_dirty;
+        }
+      else if (cs->cs_valid)
+        {
+          cached       = cs->cs_buffer;
+          cachedsector = cs->cs_sector;
+          dirty        = cs->cs_dirty;
+        }
+      else
+        {
+          continue;
+        }
+
+      if (cachedsector < sector || cachedsector >= sector + nsectors)
+        {
+          continue;
+        }
+
+      xfer = &buffer[(cachedsector - sector) * fs->fs_hwsectorsize];
+      if (xfer != cached)
+        {
+          if (write)
+            {
+              memcpy(cached, xfer, fs->fs_hwsectorsize);
+              if (i == fs->fs_cacheslot)
+                {
+                  fs->fs_dirty = false;
+                }
+              else
+                {
+                  cs->cs_dirty = false;
+                }
+            }
+          else if (dirty)
+            {
+              memcpy(xfer, cached, fs->fs_hwsectorsize);
+            }
+        }
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: fat_mapaddrun
+ *
+ * Description:
+ *   Record that the cluster at the given index in the file is 'cluster'.
+ *   See fat_addrun().
+ *
+ ****************************************************************************/
+
+#if CONFIG_FAT_NCLUSTERRUNS > 0
+static void fat_mapaddrun(FAR struct fat_runmap_s *map, uint32_t index,
+                          uint32_t cluster)
+{
+  FAR struct fat_clusterrun_s *run;
+  FAR struct fat_clusterrun_s *runs;
+  unsigned int maxruns;
+
+  if (map->rm_nruns > 0)
+    {
+      run = &map->rm_runs[map->rm_nruns - 1];
+      if (index != run->cr_index + run->cr_count)
+        {
+          return;
+        }
+
+      /* Extend the last run if the cluster is contiguous with it */
+
+      if (cluster == run->cr_cluster + run->cr_count)
+        {
+          run->cr_count++;
+          return;
+        }
+    }
+  else if (index != 0)
+    {
+      return;
+    }
+  else
+    {
+      map->rm_startcluster = cluster;
+    }
+
+  /* A new run is needed.  Grow the run array if it is full.  If it cannot
+   * grow, the map just stops here and the rest of the chain has to be
+   * followed in the FAT.
+   */
+
+  if (map->rm_nruns >= map->rm_maxruns)
+    {
+      if (map->rm_maxruns >= CONFIG_FAT_NCLUSTERRUNS)
+        {
+          return;
+        }
+
+      maxruns = map->rm_maxruns > 0 ? 2 * map->rm_maxruns : 4;
+      if (maxruns > CONFIG_FAT_NCLUSTERRUNS)
+        {
+          maxruns = CONFIG_FAT_NCLUSTERRUNS;
+        }
+
+      runs = (FAR struct fat_clusterrun_s *)
+        kmm_realloc(map->rm_runs, maxruns * sizeof(struct fat_clusterrun_s));
+      if (runs == NULL)
+        {
+          return;
+        }
+
+      map->rm_runs    = runs;
+      map->rm_maxruns = maxruns;
+    }
+
+  run             = &map->rm_runs[map->rm_nruns++];
+  run->cr_index   = index;
+  run->cr_cluster = cluster;
+  run->cr_count   = 1;
+}
+#endif
+
+/****************************************************************************
+ * Name: fat_mapupdate
+ *
+ * Description:
+ *   Keep one cluster run map coherent with a change to the FAT.  If
+ *   'newcluster' is non-zero, it has just been linked after 'cluster' at
+ *   the end of a chain.  Otherwise, 'cluster' and all clusters after it
+ *   are about to be removed from their chain.
+ *
+ ****************************************************************************/
+
+#if CONFIG_FAT_NCLUSTERRUNS > 0
+static void fat_mapupdate(FAR struct fat_runmap_s *map, uint32_t cluster,
+                          uint32_t newcluster)
+{
+  FAR struct fat_clusterrun_s *run;
+  int i;
+
+  if (map->rm_nruns == 0)
+    {
+      return;
+    }
+
+  if (newcluster != 0)
+    {
+      /* Extend the map if it covers the chain up to 'cluster' */
+
+      run = &map->rm_runs[map->rm_nruns - 1];
+      if (run->cr_cluster + run->cr_count - 1 == cluster)
+        {
+          fat_mapaddrun(map, run->cr_index + run->cr_count, newcluster);
+        }
+
+      return;
+    }
+
+  /* Truncate the map at 'cluster' if it contains it */
+
+  for (i = 0; i < map->rm_nruns; i++)
+    {
+      run = &map->rm_runs[i];
+      if (cluster >= run->cr_cluster &&
+          cluster - run->cr_cluster < run->cr_count)
+        {
+          run->cr_count = cluster - run->cr_cluster;
+          map->rm_nruns = run->cr_count > 0 ? i + 1 : i;
+          map->rm_hint  = 0;
+          return;
+        }
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: fat_runsupdate
+ *
+ * Description:
+ *   Keep the cluster run maps of all open files, and of all files whose
+ *   maps were kept after closing, coherent with a change to the FAT.  See
+ *   fat_mapupdate().
+ *
+ ****************************************************************************/
+
+#if CONFIG_FAT_NCLUSTERRUNS > 0
+static void fat_runsupdate(struct fat_mountpt_s *fs, uint32_t cluster,
+                           uint32_t newcluster)
+{
+  FAR struct fat_file_s *ff;
+#if CONFIG_FAT_NRUNHINTS > 0
+  int i;
+#endif
+
+  for (ff = fs->fs_head; ff != NULL; ff = ff->ff_next)
+    {
+      fat_mapupdate(&ff->ff_runmap, cluster, newcluster);
+    }
+
+#if CONFIG_FAT_NRUNHINTS > 0
+  for (i = 0; i < CONFIG_FAT_NRUNHINTS; i++)
+    {
+      fat_mapupdate(&fs->fs_runhints[i], cluster, newcluster);
+    }
+#endif
+}
+#endif
+
 /****************************************************************************
  * Name: fat_checkfsinfo
  *
@@ -510,6 +832,9 @@ int fat_mount(struct fat_mountpt_s *fs, bool writeable)
   FAR struct inode *inode;
   struct geometry geo;
   int ret;
+#if CONFIG_FAT_NCACHESECTORS > 1
+  int i;
+#endif
 
   /* Assume that the mount is successful */
 
@@ -538,15 +863,32 @@ int fat_mount(struct fat_mountpt_s *fs, bool writeable)
   fs->fs_hwsectorsize = geo.geo_sectorsize;
   fs->fs_hwnsectors   = geo.geo_nsectors;
 
-  /* Allocate a buffer to hold one hardware sector */
+  /* Allocate a buffer to hold the sector cache */
 
-  fs->fs_buffer = (FAR uint8_t *)fat_io_alloc(fs->fs_hwsectorsize);
+  fs->fs_buffer = (FAR uint8_t *)fat_io_alloc(FAT_CACHESIZE(fs));
   if (!fs->fs_buffer)
     {
       ret = -ENOMEM;
       goto errout;
     }
 
+#if CONFIG_FAT_NCACHESECTORS > 1
+  /* Carve the allocation into sectors.  fs_buffer starts out referring to
+   * the first of them.
+   */
+
+  for (i = 0; i < CONFIG_FAT_NCACHESECTORS; i++)
+    {
+      fs->fs_cache[i].cs_buffer = &fs->fs_buffer[i * fs->fs_hwsectorsize];
+      fs->fs_cache[i].cs_valid  = false;
+      fs->fs_cache[i].cs_dirty  = false;
+      fs->fs_cache[i].cs_age    = 0;
+    }
+
+  fs->fs_cacheslot  = 0;
+  fs->fs_cacheclock = 0;
+#endif
+
   /* Search FAT boot record on the drive.  First check at sector zero.  This
    * could be either the boot record or a partition that refers to the boot
    * record.
@@ -635,6 +977,10 @@ int fat_mount(struct fat_mountpt_s *fs, bool writeable)
         }
     }
 
+  /* The sector buffer now holds the boot record */
+
+  fs->fs_currentsector = fs->fs_fatbase;
+
   /* We have what appears to be a valid FAT filesystem! Now read the
    * FSINFO sector (FAT32 only)
    */
@@ -670,7 +1016,7 @@ int fat_mount(struct fat_mountpt_s *fs, bool writeable)
   return OK;
 
 errout_with_buffer:
-  fat_io_free(fs->fs_buffer, fs->fs_hwsectorsize);
+  fat_io_free(FAT_CACHEBASE(fs), FAT_CACHESIZE(fs));
   fs->fs_buffer = 0;
 
 errout:
@@ -743,6 +1089,9 @@ int fat_hwread(struct fat_mountpt_s *fs, uint8_t *buffer,  off_t sector,
                                                        sector, nsectors);
           if (nSectorsRead == nsectors)
             {
+#if CONFIG_FAT_NCACHESECTORS > 1
+              fat_fscachecoherent(fs, buffer, sector, nsectors, false);
+#endif
               ret = OK;
             }
           else if (nSectorsRead < 0)
@@ -777,6 +1126,9 @@ int fat_hwwrite(struct fat_mountpt_s *fs, uint8_t *buffer, off_t sector,
 
           if (nSectorsWritten == nsectors)
             {
+#if CONFIG_FAT_NCACHESECTORS > 1
+              fat_fscachecoherent(fs, buffer, sector, nsectors, true);
+#endif
               ret = OK;
             }
           else if (nSectorsWritten < 0)
@@ -1117,6 +1469,12 @@ int fat_removechain(struct fat_mountpt_s *fs, uint32_t cluster)
   int32_t nextcluster;
   int    ret;
 
+#if CONFIG_FAT_NCLUSTERRUNS > 0
+  /* Forget the removed clusters in the cluster run maps */
+
+  fat_runsupdate(fs, cluster, 0);
+#endif
+
   /* Loop while there are clusters in the chain */
 
   while (cluster >= 2 && cluster < fs->fs_nclusters)
@@ -1302,6 +1660,12 @@ int32_t fat_extendchain(struct fat_mountpt_s *fs, uint32_t cluster)
         {
           return ret;
         }
+
+#if CONFIG_FAT_NCLUSTERRUNS > 0
+      /* Add the new cluster to the cluster run maps that end at 'cluster' */
+
+      fat_runsupdate(fs, cluster, newcluster);
+#endif
     }
 
   /* And update the FINSINFO for the next time we have to search */
@@ -1617,6 +1981,7 @@ int fat_dirextend(FAR struct fat_mountpt_s *fs, FAR struct fat_file_s *ff,
           ff->ff_startcluster     = fat_createchain(fs);
           ff->ff_currentcluster   = ff->ff_startcluster;
           ff->ff_sectorsincluster = fs->fs_fatsecperclus;
+          fat_addrunpos(fs, ff, 0, ff->ff_startcluster);
         }
 
       /* The current sector can then be determined from the current cluster
@@ -1755,12 +2120,42 @@ int fat_dirextend(FAR struct fat_mountpt_s *fs, FAR struct fat_file_s *ff,
  * Name: fat_fscacheflush
  *
  * Description:
- *   Flush any dirty sector if fs_buffer as necessary
+ *   Flush any dirty sectors in the mountpoint sector cache as necessary
  *
  ****************************************************************************/
 
 int fat_fscacheflush(struct fat_mountpt_s *fs)
 {
+#if CONFIG_FAT_NCACHESECTORS > 1
+  FAR struct fat_cachesect_s *cs;
+  int ret;
+  int i;
+
+  /* Write back every dirty sector in the cache */
+
+  fat_fscachesave(fs);
+
+  for (i = 0; i < CONFIG_FAT_NCACHESECTORS; i++)
+    {
+      cs = &fs->fs_cache[i];
+      if (cs->cs_valid && cs->cs_dirty)
+        {
+          ret = fat_writesector(fs, cs->cs_buffer, cs->cs_sector);
+          if (ret < 0)
+            {
+              return ret;
+            }
+
+          cs->cs_dirty = false;
+        }
+    }
+
+  /* None of them is dirty now, including the one in fs_buffer */
+
+  fs->fs_dirty = false;
+  return OK;
+
+#else
   int ret;
 
   /* Check if the fs_buffer is dirty.  In this case, we will write back the
@@ -1769,53 +2164,117 @@ int fat_fscacheflush(struct fat_mountpt_s *fs)
 
   if (fs->fs_dirty)
     {
-      /* Write the dirty sector */
-
-      ret = fat_hwwrite(fs, fs->fs_buffer, fs->fs_currentsector, 1);
+      ret = fat_writesector(fs, fs->fs_buffer, fs->fs_currentsector);
       if (ret < 0)
         {
           return ret;
         }
 
-      /* Does the sector lie in the FAT region? */
-
-      if (fs->fs_currentsector >= fs->fs_fatbase &&
-          fs->fs_currentsector < fs->fs_fatbase + fs->fs_nfatsects)
-        {
-          int i;
-
-          /* Yes, then make the change in the FAT copy as well */
-
-          for (i = fs->fs_fatnumfats; i >= 2; i--)
-            {
-              fs->fs_currentsector += fs->fs_nfatsects;
-              ret = fat_hwwrite(fs, fs->fs_buffer, fs->fs_currentsector, 1);
-              if (ret < 0)
-                {
-                  return ret;
-                }
-            }
-        }
-
       /* No longer dirty */
 
       fs->fs_dirty = false;
     }
 
   return OK;
+#endif
 }
 
 /****************************************************************************
  * Name: fat_fscacheread
  *
  * Description:
- *   Read the specified sector into the sector cache, flushing any existing
- *   dirty sectors as necessary.
+ *   Make the specified sector the one in fs_buffer, reading it into the
+ *   sector cache and writing back a dirty sector that it replaces as
+ *   necessary.
  *
  ****************************************************************************/
 
 int fat_fscacheread(struct fat_mountpt_s *fs, off_t sector)
 {
+#if CONFIG_FAT_NCACHESECTORS > 1
+  FAR struct fat_cachesect_s *cs;
+  int victim;
+  int ret;
+  int i;
+
+  /* fs->fs_currentsector holds the sector that is buffered in fs->fs_buffer.
+   * If the requested sector is the same as this sector, then we do nothing.
+   */
+
+  if (fs->fs_currentsector == sector)
+    {
+      fs->fs_cache[fs->fs_cacheslot].cs_age = ++fs->fs_cacheclock;
+      return OK;
+    }
+
+  /* Otherwise, look for the sector elsewhere in the cache.  While doing
+   * that, pick the entry to replace if the sector is not found:  an unused
+   * entry or else the least recently used one.  The entry in fs_buffer is
+   * never replaced;  callers may still be using its contents.
+   */
+
+  fat_fscachesave(fs);
+
+  victim = -1;
+  for (i = 0; i < CONFIG_FAT_NCACHESECTORS; i++)
+    {
+      cs = &fs->fs_cache[i];
+      if (cs->cs_valid && cs->cs_sector == sector)
+        {
+          goto found;
+        }
+
+      if (i != fs->fs_cacheslot &&
+          (victim < 0 || !cs->cs_valid ||
+           (fs->fs_cache[victim].cs_valid &&
+            (int32_t)(cs->cs_age - fs->fs_cache[victim].cs_age) < 0)))
+        {
+          victim = i;
+        }
+    }
+
+  /* Not found.  Write back the old contents of the replaced entry if they
+   * are dirty.
+   */
+
+  i  = victim;
+  cs = &fs->fs_cache[i];
+
+  if (cs->cs_valid && cs->cs_dirty)
+    {
+      ret = fat_writesector(fs, cs->cs_buffer, cs->cs_sector);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  /* Then read the specified sector into the cache */
+
+  cs->cs_valid = false;
+  cs->cs_dirty = false;
+
+  ret = fat_hwread(fs, cs->cs_buffer, sector, 1);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  cs->cs_sector = sector;
+  cs->cs_valid  = true;
+
+found:
+
+  /* Make this the sector in fs_buffer */
+
+  cs->cs_age           = ++fs->fs_cacheclock;
+  fs->fs_cacheslot     = i;
+  fs->fs_buffer        = cs->cs_buffer;
+  fs->fs_currentsector = sector;
+  fs->fs_dirty         = cs->cs_dirty;
+  return OK;
+
+#else
   int ret;
 
   /* fs->fs_currentsector holds the current sector that is buffered in
@@ -1849,6 +2308,7 @@ int fat_fscacheread(struct fat_mountpt_s *fs, off_t sector)
     }
 
   return OK;
+#endif
 }
 
 /****************************************************************************
@@ -1967,6 +2427,262 @@ int fat_ffcacheinvalidate(struct fat_mountpt_s *fs, struct fat_file_s *ff)
   return OK;
 }
 
+/****************************************************************************
+ * Name: fat_findrun
+ *
+ * Description:
+ *   Look up a cluster of the file in its cluster run map.  On entry, *index
+ *   is the index of the wanted cluster within the file.  If that cluster is
+ *   beyond the part of the chain that is mapped, the last mapped cluster is
+ *   returned instead.  On return, *index is the index of the returned
+ *   cluster.
+ *
+ * Returned Value:
+ *   The cluster number or zero if nothing is mapped.
+ *
+ ****************************************************************************/
+
+#if CONFIG_FAT_NCLUSTERRUNS > 0
+uint32_t fat_findrun(struct fat_file_s *ff, FAR uint32_t *index)
+{
+  FAR struct fat_runmap_s *map = &ff->ff_runmap;
+  FAR struct fat_clusterrun_s *run;
+  uint32_t offset;
+  unsigned int lower;
+  unsigned int upper;
+  unsigned int mid;
+
+  if (map->rm_nruns == 0)
+    {
+      return 0;
+    }
+
+  /* Check the run found by the last lookup first.  Sequential accesses
+   * stay in the same run for a long time.
+   */
+
+  lower = map->rm_hint;
+  if (lower < map->rm_nruns &&
+      map->rm_runs[lower].cr_index <= *index &&
+      (lower + 1 == map->rm_nruns ||
+       map->rm_runs[lower + 1].cr_index > *index))
+    {
+      goto found;
+    }
+
+  /* Otherwise, binary search for the last run starting at or before the
+   * wanted cluster.  The first run always starts at index zero.
+   */
+
+  lower = 0;
+  upper = map->rm_nruns - 1;
+
+  while (lower < upper)
+    {
+      mid = (lower + upper + 1) >> 1;
+      if (map->rm_runs[mid].cr_index <= *index)
+        {
+          lower = mid;
+        }
+      else
+        {
+          upper = mid - 1;
+        }
+    }
+
+  map->rm_hint = lower;
+
+found:
+  run    = &map->rm_runs[lower];
+  offset = *index - run->cr_index;
+  if (offset >= run->cr_count)
+    {
+      offset = run->cr_count - 1;
+    }
+
+  *index = run->cr_index + offset;
+  return run->cr_cluster + offset;
+}
+#endif
+
+/****************************************************************************
+ * Name: fat_addrun
+ *
+ * Description:
+ *   Record that the cluster at the given index in the file is 'cluster'.
+ *   The run map only grows at its end:  the cluster is ignored unless it
+ *   immediately follows the part of the chain that is already mapped.
+ *
+ ****************************************************************************/
+
+#if CONFIG_FAT_NCLUSTERRUNS > 0
+void fat_addrun(struct fat_file_s *ff, uint32_t index, uint32_t cluster)
+{
+  fat_mapaddrun(&ff->ff_runmap, index, cluster);
+}
+#endif
+
+/****************************************************************************
+ * Name: fat_addrunpos
+ *
+ * Description:
+ *   Same as fat_addrun() but the cluster is identified by the file position
+ *   of its first byte.  Nothing is recorded if the position is not at the
+ *   start of a cluster.
+ *
+ ****************************************************************************/
+
+#if CONFIG_FAT_NCLUSTERRUNS > 0
+void fat_addrunpos(struct fat_mountpt_s *fs, struct fat_file_s *ff,
+                   off_t position, uint32_t cluster)
+{
+  off_t clustersize = fs->fs_fatsecperclus * fs->fs_hwsectorsize;
+
+  if ((position % clustersize) == 0)
+    {
+      fat_mapaddrun(&ff->ff_runmap, position / clustersize, cluster);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: fat_openruns
+ *
+ * Description:
+ *   Set up the cluster run map of a newly opened file.  If the map of the
+ *   file was kept when it was last closed, it is re-used.
+ *
+ ****************************************************************************/
+
+#if CONFIG_FAT_NCLUSTERRUNS > 0
+void fat_openruns(struct fat_mountpt_s *fs, struct fat_file_s *ff)
+{
+  FAR struct fat_runmap_s *map = &ff->ff_runmap;
+#if CONFIG_FAT_NRUNHINTS > 0
+  FAR struct fat_runmap_s *hint;
+  int i;
+#endif
+
+  memset(map, 0, sizeof(struct fat_runmap_s));
+
+  if (ff->ff_startcluster == 0)
+    {
+      return;
+    }
+
+#if CONFIG_FAT_NRUNHINTS > 0
+  for (i = 0; i < CONFIG_FAT_NRUNHINTS; i++)
+    {
+      hint = &fs->fs_runhints[i];
+      if (hint->rm_nruns > 0 && hint->rm_startcluster == ff->ff_startcluster)
+        {
+          /* Take over the kept map */
+
+          *map = *hint;
+          memset(hint, 0, sizeof(struct fat_runmap_s));
+          return;
+        }
+    }
+#endif
+
+  fat_mapaddrun(map, 0, ff->ff_startcluster);
+}
+#endif
+
+/****************************************************************************
+ * Name: fat_closeruns
+ *
+ * Description:
+ *   Dispose of the cluster run map of a file that is being closed.  The
+ *   map is kept for re-use if CONFIG_FAT_NRUNHINTS > 0 and fs is not NULL.
+ *
+ ****************************************************************************/
+
+#if CONFIG_FAT_NCLUSTERRUNS > 0
+void fat_closeruns(struct fat_mountpt_s *fs, struct fat_file_s *ff)
+{
+  FAR struct fat_runmap_s *map = &ff->ff_runmap;
+#if CONFIG_FAT_NRUNHINTS > 0
+  FAR struct fat_runmap_s *hint = NULL;
+  int i;
+
+  if (fs != NULL && map->rm_nruns > 0)
+    {
+      /* Replace an older map of the same file, else an unused entry, else
+       * the entries in turn.
+       */
+
+      for (i = 0; i < CONFIG_FAT_NRUNHINTS; i++)
+        {
+          if (fs->fs_runhints[i].rm_nruns > 0 &&
+              fs->fs_runhints[i].rm_startcluster == map->rm_startcluster)
+            {
+              hint = &fs->fs_runhints[i];
+              break;
+            }
+
+          if (hint == NULL && fs->fs_runhints[i].rm_nruns == 0)
+            {
+              hint = &fs->fs_runhints[i];
+            }
+        }
+
+      if (hint == NULL)
+        {
+          hint = &fs->fs_runhints[fs->fs_nexthint];
+          if (++fs->fs_nexthint >= CONFIG_FAT_NRUNHINTS)
+            {
+              fs->fs_nexthint = 0;
+            }
+        }
+
+      if (hint->rm_runs != NULL)
+        {
+          kmm_free(hint->rm_runs);
+        }
+
+      *hint = *map;
+      memset(map, 0, sizeof(struct fat_runmap_s));
+      return;
+    }
+#endif
+
+  if (map->rm_runs != NULL)
+    {
+      kmm_free(map->rm_runs);
+    }
+
+  memset(map, 0, sizeof(struct fat_runmap_s));
+}
+#endif
+
+/****************************************************************************
+ * Name: fat_freeruns
+ *
+ * Description:
+ *   Free the cluster run maps that were kept after their files were closed.
+ *
+ ****************************************************************************/
+
+#if CONFIG_FAT_NCLUSTERRUNS > 0
+void fat_freeruns(struct fat_mountpt_s *fs)
+{
+#if CONFIG_FAT_NRUNHINTS > 0
+  int i;
+
+  for (i = 0; i < CONFIG_FAT_NRUNHINTS; i++)
+    {
+      if (fs->fs_runhints[i].rm_runs != NULL)
+        {
+          kmm_free(fs->fs_runhints[i].rm_runs);
+        }
+
+      memset(&fs->fs_runhints[i], 0, sizeof(struct fat_runmap_s));
+    }
+#endif
+}
+#endif
+
 /****************************************************************************
  * Name: fat_updatefsinfo
  *
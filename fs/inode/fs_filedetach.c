@@ -131,10 +131,16 @@ int file_detach(int fd, FAR struct file *filep)
   list = sched_getfiles();
   DEBUGASSERT(list != NULL);
 
+  /* The descriptor is released below:  Remove it from any epoll interest
+   * list while it still refers to the open file.
+   */
+
+  parent = &list->fl_files[fd];
+  epoll_detach(&parent->f_epoll);
+
   /* If the file was properly opened, there should be an inode assigned */
 
   _files_semtake(list);
-  parent = &list->fl_files[fd];
   if (parent->f_inode == NULL)
     {
       /* File is not open */
@@ -151,6 +157,9 @@ int file_detach(int fd, FAR struct file *filep)
   filep->f_pos     = parent->f_pos;
   filep->f_inode   = parent->f_inode;
   filep->f_priv    = parent->f_priv;
+#ifndef CONFIG_DISABLE_POLL
+  filep->f_epoll   = NULL;
+#endif
 
   /* Release the file descriptore *without* calling the drive close method
    * and without decrementing the inode reference count.  That will be done
@@ -105,6 +105,12 @@ static int _files_close(FAR struct file *filep)
 
   if (inode)
     {
+      /* Remove the file from any epoll interest list first.  The driver
+       * must not keep a pollfd that refers to the epoll instance.
+       */
+
+      epoll_detach(&filep->f_epoll);
+
       /* Close the file, driver, or mountpoint. */
 
       if (inode->u.i_ops && inode->u.i_ops->close)
@@ -0,0 +1,249 @@
+/****************************************************************************
+ * fs/inode/fs_inodecache.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <nuttx/fs/fs.h>
+
+#include "inode/inode.h"
+
+#ifdef CONFIG_FS_DCACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_FS_DCACHE_NENTRIES
+#  define CONFIG_FS_DCACHE_NENTRIES 32
+#endif
+
+#ifndef CONFIG_FS_DCACHE_NAMELEN
+#  define CONFIG_FS_DCACHE_NAMELEN 16
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One entry in the directory entry cache.  This is the result of looking
+ * up one path segment among the children of one inode.
+ */
+
+struct inode_dentry_s
+{
+  uint32_t de_generation;          /* Cache generation of the entry */
+  FAR struct inode *de_parent;     /* The parent inode (NULL at top level) */
+  FAR struct inode *de_node;       /* The inode found (NULL if none) */
+  FAR struct inode *de_peer;       /* The inode to the "left" of the name */
+  uint8_t de_namelen;              /* Length of the name */
+  char de_name[CONFIG_FS_DCACHE_NAMELEN];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The cache is direct mapped:  Each (parent, name) pair can only be held in
+ * the entry selected by its hash.  Entries from an older generation are
+ * invalid so the whole cache is discarded just by incrementing
+ * g_dcache_generation.
+ */
+
+static struct inode_dentry_s g_dcache[CONFIG_FS_DCACHE_NENTRIES];
+static uint32_t g_dcache_generation = 1;
+static struct inode_dcachestats_s g_dcache_stats;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: inode_dcache_hash
+ *
+ * Description:
+ *   Return the cache entry for the first segment of 'name' under 'parent'
+ *   and the length of that segment.
+ *
+ ****************************************************************************/
+
+static FAR struct inode_dentry_s *
+inode_dcache_hash(FAR struct inode *parent, FAR const char *name,
+                  FAR size_t *namelen)
+{
+  uint32_t hash = (uint32_t)((uintptr_t)parent >> 2);
+  size_t len;
+
+  for (len = 0; name[len] != '\0' && name[len] != '/'; len++)
+    {
+      hash = hash * 31 + (uint8_t)name[len];
+    }
+
+  *namelen = len;
+  return &g_dcache[hash % CONFIG_FS_DCACHE_NENTRIES];
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: inode_dcache_lookup
+ *
+ * Description:
+ *   Look up the first segment of 'name' under the inode 'parent' (NULL at
+ *   the top level) in the directory entry cache.  On a hit, the inode
+ *   found (NULL for a negative entry) is returned in 'node' and the inode
+ *   to its "left" in 'peer'.
+ *
+ * Returned Value:
+ *   true on a cache hit; false on a miss.
+ *
+ * Assumptions:
+ *   The caller holds the g_inode_sem semaphore
+ *
+ ****************************************************************************/
+
+bool inode_dcache_lookup(FAR struct inode *parent, FAR const char *name,
+                         FAR struct inode **node, FAR struct inode **peer)
+{
+  FAR struct inode_dentry_s *entry;
+  size_t namelen;
+
+  entry = inode_dcache_hash(parent, name, &namelen);
+  if (entry->de_generation != g_dcache_generation ||
+      entry->de_parent != parent || entry->de_namelen != namelen ||
+      memcmp(entry->de_name, name, namelen) != 0)
+    {
+      g_dcache_stats.ds_misses++;
+      return false;
+    }
+
+  if (entry->de_node != NULL)
+    {
+      g_dcache_stats.ds_hits++;
+    }
+  else
+    {
+      g_dcache_stats.ds_neghits++;
+    }
+
+  *node = entry->de_node;
+  *peer = entry->de_peer;
+  return true;
+}
+
+/****************************************************************************
+ * Name: inode_dcache_add
+ *
+ * Description:
+ *   Add the result of a search of the peer list to the directory entry
+ *   cache.  'node' is NULL if the name was not found.
+ *
+ * Assumptions:
+ *   The caller holds the g_inode_sem semaphore
+ *
+ ****************************************************************************/
+
+void inode_dcache_add(FAR struct inode *parent, FAR const char *name,
+                      FAR struct inode *node, FAR struct inode *peer)
+{
+  FAR struct inode_dentry_s *entry;
+  size_t namelen;
+
+  /* Names that are too long are simply not cached */
+
+  entry = inode_dcache_hash(parent, name, &namelen);
+  if (namelen > CONFIG_FS_DCACHE_NAMELEN)
+    {
+      return;
+    }
+
+  entry->de_generation = g_dcache_generation;
+  entry->de_parent     = parent;
+  entry->de_node       = node;
+  entry->de_peer       = peer;
+  entry->de_namelen    = namelen;
+  memcpy(entry->de_name, name, namelen);
+}
+
+/****************************************************************************
+ * Name: inode_dcache_invalidate
+ *
+ * Description:
+ *   Discard all entries in the directory entry cache.  This must be called
+ *   whenever an inode is linked into or unlinked from the inode tree.
+ *
+ * Assumptions:
+ *   The caller holds the g_inode_sem semaphore
+ *
+ ****************************************************************************/
+
+void inode_dcache_invalidate(void)
+{
+  /* If the generation number wraps around, old entries could become valid
+   * again.  Clear them out in that (very unlikely) case.
+   */
+
+  if (++g_dcache_generation == 0)
+    {
+      memset(g_dcache, 0, sizeof(g_dcache));
+      g_dcache_generation = 1;
+    }
+
+  g_dcache_stats.ds_invalidations++;
+}
+
+/****************************************************************************
+ * Name: inode_dcache_stats
+ *
+ * Description:
+ *   Return the statistics of the directory entry cache.
+ *
+ ****************************************************************************/
+
+void inode_dcache_stats(FAR struct inode_dcachestats_s *stats)
+{
+  memcpy(stats, &g_dcache_stats, sizeof(struct inode_dcachestats_s));
+}
+
+#endif /* CONFIG_FS_DCACHE */
@@ -117,6 +117,10 @@ FAR struct inode *inode_unlink(FAR const char *path)
         }
 
       node->i_peer = NULL;
+
+      /* Cached search results may no longer be valid */
+
+      inode_dcache_invalidate();
     }
 
   RELEASE_SEARCH(&desc);
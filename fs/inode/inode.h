@@ -142,6 +142,18 @@ struct inode_search_s
 #endif
 };
 
+#ifdef CONFIG_FS_DCACHE
+/* Statistics of the directory entry cache */
+
+struct inode_dcachestats_s
+{
+  uint32_t ds_hits;          /* Lookups that found the inode in the cache */
+  uint32_t ds_neghits;       /* Lookups that found a negative entry */
+  uint32_t ds_misses;        /* Lookups that had to search the peer list */
+  uint32_t ds_invalidations; /* Number of times the cache was invalidated */
+};
+#endif
+
 /* Callback used by foreach_inode to traverse all inodes in the pseudo-
  * file system.
  */
@@ -226,6 +238,75 @@ void inode_semgive(void);
 
 int inode_search(FAR struct inode_search_s *desc);
 
+/****************************************************************************
+ * Name: inode_dcache_lookup
+ *
+ * Description:
+ *   Look up the first segment of 'name' under the inode 'parent' (NULL at
+ *   the top level) in the directory entry cache.  On a hit, the inode
+ *   found (NULL for a negative entry) is returned in 'node' and the inode
+ *   to its "left" in 'peer'.
+ *
+ * Returned Value:
+ *   true on a cache hit; false on a miss.
+ *
+ * Assumptions:
+ *   The caller holds the g_inode_sem semaphore
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_DCACHE
+bool inode_dcache_lookup(FAR struct inode *parent, FAR const char *name,
+                         FAR struct inode **node, FAR struct inode **peer);
+#endif
+
+/****************************************************************************
+ * Name: inode_dcache_add
+ *
+ * Description:
+ *   Add the result of a search of the peer list to the directory entry
+ *   cache.  'node' is NULL if the name was not found.
+ *
+ * Assumptions:
+ *   The caller holds the g_inode_sem semaphore
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_DCACHE
+void inode_dcache_add(FAR struct inode *parent, FAR const char *name,
+                      FAR struct inode *node, FAR struct inode *peer);
+#endif
+
+/****************************************************************************
+ * Name: inode_dcache_invalidate
+ *
+ * Description:
+ *   Discard all entries in the directory entry cache.  This must be called
+ *   whenever an inode is linked into or unlinked from the inode tree.
+ *
+ * Assumptions:
+ *   The caller holds the g_inode_sem semaphore
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_DCACHE
+void inode_dcache_invalidate(void);
+#else
+#  define inode_dcache_invalidate()
+#endif
+
+/****************************************************************************
+ * Name: inode_dcache_stats
+ *
+ * Description:
+ *   Return the statistics of the directory entry cache.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_DCACHE
+void inode_dcache_stats(FAR struct inode_dcachestats_s *stats);
+#endif
+
 /****************************************************************************
  * Name: inode_find
  *
@@ -80,6 +80,11 @@ extern const struct procfs_operations proc_operations;
 extern const struct procfs_operations irq_operations;
 extern const struct procfs_operations cpuload_operations;
 extern const struct procfs_operations meminfo_operations;
+extern const struct procfs_operations heap_operations;
+extern const struct procfs_operations dcache_operations;
+extern const struct procfs_operations aioinfo_operations;
+extern const struct procfs_operations smp_operations;
+extern const struct procfs_operations locks_operations;
 extern const struct procfs_operations module_operations;
 extern const struct procfs_operations uptime_operations;
 
@@ -125,10 +130,19 @@ static const struct procfs_entry_s g_procfs_entries[] =
   { "cpuload",       &cpuload_operations,         PROCFS_FILE_TYPE   },
 #endif
 
+#if defined(CONFIG_MM_HEAPINFO) && !defined(CONFIG_FS_PROCFS_EXCLUDE_HEAP)
+  { "heap",          &heap_operations,            PROCFS_FILE_TYPE   },
+#endif
+
 #ifdef CONFIG_SCHED_IRQMONITOR
   { "irqs",          &irq_operations,             PROCFS_FILE_TYPE   },
 #endif
 
+#if (defined(CONFIG_SPINLOCK_HOLDTIME) || defined(CONFIG_SCHED_LOCKPROF)) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_LOCKS)
+  { "locks",         &locks_operations,           PROCFS_FILE_TYPE   },
+#endif
+
 #ifndef CONFIG_FS_PROCFS_EXCLUDE_MEMINFO
   { "meminfo",       &meminfo_operations,         PROCFS_FILE_TYPE   },
 #endif
@@ -137,6 +151,18 @@ static const struct procfs_entry_s g_procfs_entries[] =
   { "modules",       &module_operations,          PROCFS_FILE_TYPE   },
 #endif
 
+#if defined(CONFIG_SMP_STATS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SMP)
+  { "smp",           &smp_operations,             PROCFS_FILE_TYPE   },
+#endif
+
+#if defined(CONFIG_FS_AIO) && !defined(CONFIG_FS_PROCFS_EXCLUDE_AIO)
+  { "fs/aio",        &aioinfo_operations,         PROCFS_FILE_TYPE   },
+#endif
+
+#if defined(CONFIG_FS_DCACHE) && !defined(CONFIG_FS_PROCFS_EXCLUDE_DCACHE)
+  { "fs/dcache",     &dcache_operations,          PROCFS_FILE_TYPE   },
+#endif
+
 #ifndef CONFIG_FS_PROCFS_EXCLUDE_BLOCKS
   { "fs/blocks",     &mount_procfsoperations,     PROCFS_FILE_TYPE   },
 #endif
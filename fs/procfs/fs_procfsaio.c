@@ -0,0 +1,335 @@
+/****************************************************************************
+ * fs/procfs/fs_procfsaio.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/clock.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#include "aio/aio.h"
+
+#if defined(CONFIG_FS_AIO) && !defined(CONFIG_FS_PROCFS_EXCLUDE_AIO)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+/* Determines the size of an intermediate buffer that must be large enough
+ * to hold all of the output generated by this logic.
+ */
+
+#define AIOINFO_LINELEN 320
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct aioinfo_file_s
+{
+  struct procfs_file_s base;      /* Base open file structure */
+  unsigned int linesize;          /* Number of valid characters in line[] */
+  char line[AIOINFO_LINELEN];     /* Pre-allocated buffer for formatted lines */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     aioinfo_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     aioinfo_close(FAR struct file *filep);
+static ssize_t aioinfo_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static int     aioinfo_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     aioinfo_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations aioinfo_operations =
+{
+  aioinfo_open,   /* open */
+  aioinfo_close,  /* close */
+  aioinfo_read,   /* read */
+  NULL,           /* write */
+  aioinfo_dup,    /* dup */
+  NULL,           /* opendir */
+  NULL,           /* closedir */
+  NULL,           /* readdir */
+  NULL,           /* rewinddir */
+  aioinfo_stat    /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: aioinfo_open
+ ****************************************************************************/
+
+static int aioinfo_open(FAR struct file *filep, FAR const char *relpath,
+                        int oflags, mode_t mode)
+{
+  FAR struct aioinfo_file_s *procfile;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* "fs/aio" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "fs/aio") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  procfile = (FAR struct aioinfo_file_s *)
+    kmm_zalloc(sizeof(struct aioinfo_file_s));
+  if (!procfile)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)procfile;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: aioinfo_close
+ ****************************************************************************/
+
+static int aioinfo_close(FAR struct file *filep)
+{
+  FAR struct aioinfo_file_s *procfile;
+
+  /* Recover our private data from the struct file instance */
+
+  procfile = (FAR struct aioinfo_file_s *)filep->f_priv;
+  DEBUGASSERT(procfile);
+
+  /* Release the file attributes structure */
+
+  kmm_free(procfile);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: aioinfo_read
+ *
+ * Description:
+ *   Return the asynchronous I/O queue statistics.  These are sampled when
+ *   the file position is zero so that they remain consistent if the file
+ *   is read in pieces.
+ *
+ ****************************************************************************/
+
+static ssize_t aioinfo_read(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen)
+{
+  FAR struct aioinfo_file_s *procfile;
+  struct aio_stats_s stats;
+  unsigned long avglatency;
+  off_t offset;
+  ssize_t ret;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  DEBUGASSERT(filep != NULL && buffer != NULL && buflen > 0);
+
+  /* Recover our private data from the struct file instance */
+
+  procfile = (FAR struct aioinfo_file_s *)filep->f_priv;
+  DEBUGASSERT(procfile);
+
+  if (filep->f_pos == 0)
+    {
+      aio_stats(&stats);
+
+      avglatency = 0;
+      if (stats.as_completed > 0)
+        {
+          avglatency = TICK2MSEC((uint64_t)stats.as_latency) /
+                       stats.as_completed;
+        }
+
+      procfile->linesize =
+        snprintf(procfile->line, AIOINFO_LINELEN,
+                 "Threads:          %10u\n"
+                 "Queued:           %10u\n"
+                 "Max queued:       %10u\n"
+                 "Submitted:        %10lu\n"
+                 "Completed:        %10lu\n"
+                 "Transfers:        %10lu\n"
+                 "Merged:           %10lu\n"
+                 "Avg latency (ms): %10lu\n"
+                 "Max latency (ms): %10lu\n",
+                 CONFIG_FS_AIO_NTHREADS, stats.as_depth, stats.as_maxdepth,
+                 (unsigned long)stats.as_submitted,
+                 (unsigned long)stats.as_completed,
+                 (unsigned long)stats.as_transfers,
+                 (unsigned long)stats.as_merged, avglatency,
+                 (unsigned long)TICK2MSEC((uint64_t)stats.as_maxlatency));
+    }
+
+  /* Transfer the statistics to the user receive buffer */
+
+  offset = filep->f_pos;
+  ret    = procfs_memcpy(procfile->line, procfile->linesize, buffer, buflen,
+                         &offset);
+
+  /* Update the file offset */
+
+  if (ret > 0)
+    {
+      filep->f_pos += ret;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: aioinfo_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int aioinfo_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct aioinfo_file_s *oldattr;
+  FAR struct aioinfo_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct aioinfo_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = (FAR struct aioinfo_file_s *)
+    kmm_malloc(sizeof(struct aioinfo_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct aioinfo_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: aioinfo_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int aioinfo_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "fs/aio" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "fs/aio") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* "fs/aio" is the name for a read-only file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+#endif /* CONFIG_FS_AIO && !CONFIG_FS_PROCFS_EXCLUDE_AIO */
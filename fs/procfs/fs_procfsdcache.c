@@ -0,0 +1,332 @@
+/****************************************************************************
+ * fs/procfs/fs_procfsdcache.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#include "inode/inode.h"
+
+#if defined(CONFIG_FS_DCACHE) && !defined(CONFIG_FS_PROCFS_EXCLUDE_DCACHE)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+/* Determines the size of an intermediate buffer that must be large enough
+ * to hold all of the output generated by this logic.
+ */
+
+#define DCACHE_LINELEN 160
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct dcache_file_s
+{
+  struct procfs_file_s base;      /* Base open file structure */
+  unsigned int linesize;          /* Number of valid characters in line[] */
+  char line[DCACHE_LINELEN];      /* Pre-allocated buffer for formatted lines */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     dcache_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     dcache_close(FAR struct file *filep);
+static ssize_t dcache_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static int     dcache_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     dcache_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations dcache_operations =
+{
+  dcache_open,    /* open */
+  dcache_close,   /* close */
+  dcache_read,    /* read */
+  NULL,           /* write */
+  dcache_dup,     /* dup */
+  NULL,           /* opendir */
+  NULL,           /* closedir */
+  NULL,           /* readdir */
+  NULL,           /* rewinddir */
+  dcache_stat     /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dcache_open
+ ****************************************************************************/
+
+static int dcache_open(FAR struct file *filep, FAR const char *relpath,
+                       int oflags, mode_t mode)
+{
+  FAR struct dcache_file_s *procfile;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* "fs/dcache" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "fs/dcache") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  procfile = (FAR struct dcache_file_s *)
+    kmm_zalloc(sizeof(struct dcache_file_s));
+  if (!procfile)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)procfile;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: dcache_close
+ ****************************************************************************/
+
+static int dcache_close(FAR struct file *filep)
+{
+  FAR struct dcache_file_s *procfile;
+
+  /* Recover our private data from the struct file instance */
+
+  procfile = (FAR struct dcache_file_s *)filep->f_priv;
+  DEBUGASSERT(procfile);
+
+  /* Release the file attributes structure */
+
+  kmm_free(procfile);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: dcache_read
+ *
+ * Description:
+ *   Return the directory entry cache statistics.  These are sampled when
+ *   the file position is zero so that they remain consistent if the file
+ *   is read in pieces.
+ *
+ ****************************************************************************/
+
+static ssize_t dcache_read(FAR struct file *filep, FAR char *buffer,
+                           size_t buflen)
+{
+  FAR struct dcache_file_s *procfile;
+  struct inode_dcachestats_s stats;
+  uint32_t lookups;
+  off_t offset;
+  ssize_t ret;
+  int hitrate;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  DEBUGASSERT(filep != NULL && buffer != NULL && buflen > 0);
+
+  /* Recover our private data from the struct file instance */
+
+  procfile = (FAR struct dcache_file_s *)filep->f_priv;
+  DEBUGASSERT(procfile);
+
+  if (filep->f_pos == 0)
+    {
+      inode_dcache_stats(&stats);
+
+      lookups = stats.ds_hits + stats.ds_neghits + stats.ds_misses;
+      hitrate = 0;
+      if (lookups > 0)
+        {
+          hitrate = (int)(((uint64_t)(lookups - stats.ds_misses) * 100) /
+                          lookups);
+        }
+
+      procfile->linesize =
+        snprintf(procfile->line, DCACHE_LINELEN,
+                 "Entries:       %10u\n"
+                 "Hits:          %10lu\n"
+                 "Negative hits: %10lu\n"
+                 "Misses:        %10lu\n"
+                 "Invalidations: %10lu\n"
+                 "Hit rate:      %9d%%\n",
+                 CONFIG_FS_DCACHE_NENTRIES,
+                 (unsigned long)stats.ds_hits,
+                 (unsigned long)stats.ds_neghits,
+                 (unsigned long)stats.ds_misses,
+                 (unsigned long)stats.ds_invalidations, hitrate);
+    }
+
+  /* Transfer the statistics to the user receive buffer */
+
+  offset = filep->f_pos;
+  ret    = procfs_memcpy(procfile->line, procfile->linesize, buffer, buflen,
+                         &offset);
+
+  /* Update the file offset */
+
+  if (ret > 0)
+    {
+      filep->f_pos += ret;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: dcache_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int dcache_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct dcache_file_s *oldattr;
+  FAR struct dcache_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct dcache_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = (FAR struct dcache_file_s *)
+    kmm_malloc(sizeof(struct dcache_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct dcache_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: dcache_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int dcache_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "fs/dcache" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "fs/dcache") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* "fs/dcache" is the name for a read-only file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+#endif /* CONFIG_FS_DCACHE && !CONFIG_FS_PROCFS_EXCLUDE_DCACHE */
@@ -0,0 +1,433 @@
+/****************************************************************************
+ * fs/procfs/fs_procfsheap.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/mm/mm.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#if defined(CONFIG_MM_HEAPINFO) && !defined(CONFIG_FS_PROCFS_EXCLUDE_HEAP)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define HEAP_LINELEN 80
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct heap_file_s
+{
+  struct procfs_file_s base;      /* Base open file structure */
+  char line[HEAP_LINELEN];        /* Pre-allocated buffer for formatted lines */
+};
+
+/* This structure holds the state of one read() while the allocated chunks
+ * are being enumerated.
+ */
+
+struct heap_walk_s
+{
+  FAR struct heap_file_s *procfile;
+  FAR char *buffer;               /* Remaining user buffer */
+  size_t buflen;                  /* Size of the remaining user buffer */
+  size_t totalsize;               /* Number of bytes returned so far */
+  off_t offset;                   /* Bytes to skip before returning data */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* Helpers */
+
+static void    heap_copy(FAR struct heap_walk_s *walk, size_t linesize);
+static int     heap_chunk(FAR struct mm_allocnode_s *node, FAR void *arg);
+
+/* File system methods */
+
+static int     heap_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     heap_close(FAR struct file *filep);
+static ssize_t heap_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static int     heap_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     heap_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations heap_operations =
+{
+  heap_open,      /* open */
+  heap_close,     /* close */
+  heap_read,      /* read */
+  NULL,           /* write */
+  heap_dup,       /* dup */
+  NULL,           /* opendir */
+  NULL,           /* closedir */
+  NULL,           /* readdir */
+  NULL,           /* rewinddir */
+  heap_stat       /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: heap_copy
+ *
+ * Description:
+ *   Copy the formatted line into the user buffer, skipping the part of the
+ *   output that precedes the file position.
+ *
+ ****************************************************************************/
+
+static void heap_copy(FAR struct heap_walk_s *walk, size_t linesize)
+{
+  size_t copysize;
+
+  if (walk->totalsize < walk->buflen)
+    {
+      copysize = procfs_memcpy(walk->procfile->line, linesize,
+                               walk->buffer + walk->totalsize,
+                               walk->buflen - walk->totalsize,
+                               &walk->offset);
+      walk->totalsize += copysize;
+    }
+}
+
+/****************************************************************************
+ * Name: heap_chunk
+ *
+ * Description:
+ *   Called by mm_heapinfo_walk() for each allocated chunk.
+ *
+ ****************************************************************************/
+
+static int heap_chunk(FAR struct mm_allocnode_s *node, FAR void *arg)
+{
+  FAR struct heap_walk_s *walk = (FAR struct heap_walk_s *)arg;
+  size_t linesize;
+
+  linesize = snprintf(walk->procfile->line, HEAP_LINELEN,
+                      "%10p%11lu%7d %p\n",
+                      (FAR char *)node + SIZEOF_MM_ALLOCNODE,
+                      (unsigned long)node->size, (int)node->pid,
+                      node->caller);
+  heap_copy(walk, linesize);
+
+  /* Stop the traversal when the user buffer is full */
+
+  return walk->totalsize < walk->buflen ? 0 : 1;
+}
+
+/****************************************************************************
+ * Name: heap_open
+ ****************************************************************************/
+
+static int heap_open(FAR struct file *filep, FAR const char *relpath,
+                     int oflags, mode_t mode)
+{
+  FAR struct heap_file_s *procfile;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* "heap" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "heap") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  procfile = (FAR struct heap_file_s *)
+    kmm_zalloc(sizeof(struct heap_file_s));
+  if (!procfile)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)procfile;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: heap_close
+ ****************************************************************************/
+
+static int heap_close(FAR struct file *filep)
+{
+  FAR struct heap_file_s *procfile;
+
+  /* Recover our private data from the struct file instance */
+
+  procfile = (FAR struct heap_file_s *)filep->f_priv;
+  DEBUGASSERT(procfile);
+
+  /* Release the file attributes structure */
+
+  kmm_free(procfile);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: heap_read
+ *
+ * Description:
+ *   Generate the heap profile:  A summary line, the per-size class
+ *   statistics, and then one line for each allocated chunk.  The output is
+ *   regenerated on each read and the part preceding the file position is
+ *   discarded.
+ *
+ ****************************************************************************/
+
+static ssize_t heap_read(FAR struct file *filep, FAR char *buffer,
+                         size_t buflen)
+{
+  FAR struct heap_file_s *procfile;
+  struct heap_walk_s walk;
+  struct mm_heapinfo_s info;
+  struct mallinfo mem;
+  size_t linesize;
+  int frag;
+  int ndx;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  DEBUGASSERT(filep != NULL && buffer != NULL && buflen > 0);
+
+  /* Recover our private data from the struct file instance */
+
+  procfile = (FAR struct heap_file_s *)filep->f_priv;
+  DEBUGASSERT(procfile);
+
+  walk.procfile  = procfile;
+  walk.buffer    = buffer;
+  walk.buflen    = buflen;
+  walk.totalsize = 0;
+  walk.offset    = filep->f_pos;
+
+  /* Get a snapshot of the heap profile and of the free chunk statistics.
+   * Fragmentation is the fraction of the free memory that is not in the
+   * largest free chunk.
+   */
+
+  mm_heapinfo(&g_mmheap, &info);
+  (void)mm_mallinfo(&g_mmheap, &mem);
+
+  frag = 0;
+  if (mem.fordblks > 0)
+    {
+      frag = 100 - (int)(((uint64_t)mem.mxordblk * 100) / mem.fordblks);
+    }
+
+  /* The first lines are the summary */
+
+  linesize = snprintf(procfile->line, HEAP_LINELEN,
+                      "             total       used       peak       free"
+                      "    largest  frag\n");
+  heap_copy(&walk, linesize);
+
+  linesize = snprintf(procfile->line, HEAP_LINELEN,
+                      "Umem:  %11lu%11lu%11lu%11lu%11lu  %3d%%\n",
+                      (unsigned long)mem.arena,
+                      (unsigned long)info.hi_curused,
+                      (unsigned long)info.hi_maxused,
+                      (unsigned long)mem.fordblks,
+                      (unsigned long)mem.mxordblk, frag);
+  heap_copy(&walk, linesize);
+
+  /* Followed by the size classes that have been used.  Each class holds
+   * the chunks from 'size' up to (but not including) twice 'size'.
+   */
+
+  linesize = snprintf(procfile->line, HEAP_LINELEN,
+                      "\n      size       live       peak     allocs"
+                      "      frees\n");
+  heap_copy(&walk, linesize);
+
+  for (ndx = 0; ndx < MM_NNODES && walk.totalsize < buflen; ndx++)
+    {
+      if (info.hi_nalloc[ndx] > 0)
+        {
+          linesize = snprintf(procfile->line, HEAP_LINELEN,
+                              "%10lu%11lu%11lu%11lu%11lu\n",
+                              (unsigned long)MM_MIN_CHUNK << ndx,
+                              (unsigned long)(info.hi_nalloc[ndx] -
+                                              info.hi_nfree[ndx]),
+                              (unsigned long)info.hi_maxlive[ndx],
+                              (unsigned long)info.hi_nalloc[ndx],
+                              (unsigned long)info.hi_nfree[ndx]);
+          heap_copy(&walk, linesize);
+        }
+    }
+
+  /* And finally the allocated chunks */
+
+  linesize = snprintf(procfile->line, HEAP_LINELEN,
+                      "\n   address       size    pid caller\n");
+  heap_copy(&walk, linesize);
+
+  if (walk.totalsize < buflen)
+    {
+      (void)mm_heapinfo_walk(&g_mmheap, heap_chunk, &walk);
+    }
+
+  /* Update the file offset */
+
+  filep->f_pos += walk.totalsize;
+  return walk.totalsize;
+}
+
+/****************************************************************************
+ * Name: heap_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int heap_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct heap_file_s *oldattr;
+  FAR struct heap_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct heap_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = (FAR struct heap_file_s *)
+    kmm_malloc(sizeof(struct heap_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct heap_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: heap_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int heap_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "heap" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "heap") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* "heap" is the name for a read-only file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+#endif /* CONFIG_MM_HEAPINFO && !CONFIG_FS_PROCFS_EXCLUDE_HEAP */
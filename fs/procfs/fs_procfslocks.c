@@ -0,0 +1,467 @@
+/****************************************************************************
+ * fs/procfs/fs_procfslocks.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/lockprof.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#if (defined(CONFIG_SPINLOCK_HOLDTIME) || defined(CONFIG_SCHED_LOCKPROF)) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_LOCKS)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define LOCKS_LINELEN 128
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct locks_file_s
+{
+  struct procfs_file_s base;      /* Base open file structure */
+  char line[LOCKS_LINELEN];       /* Pre-allocated buffer for formatted lines */
+};
+
+/* This structure holds the state of one read() */
+
+struct locks_read_s
+{
+  FAR struct locks_file_s *procfile; /* The open file */
+  FAR char *buffer;                  /* The user receive buffer */
+  size_t buflen;                     /* Size of the user receive buffer */
+  size_t totalsize;                  /* Number of bytes transferred */
+  off_t offset;                      /* Offset of the next line in the file */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     locks_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     locks_close(FAR struct file *filep);
+static ssize_t locks_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static int     locks_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     locks_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations locks_operations =
+{
+  locks_open,   /* open */
+  locks_close,  /* close */
+  locks_read,   /* read */
+  NULL,         /* write */
+  locks_dup,    /* dup */
+  NULL,         /* opendir */
+  NULL,         /* closedir */
+  NULL,         /* readdir */
+  NULL,         /* rewinddir */
+  locks_stat    /* stat */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_LOCKPROF
+/* Names of the LOCKPROF_* lock types */
+
+static FAR const char *g_locktype[] =
+{
+  "csection", "spinlock", "semaphore", "mutex"
+};
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: locks_copyline
+ *
+ * Description:
+ *   Transfer the line formatted in procfile->line to the user receive
+ *   buffer, skipping the part of the file that was already read.
+ *
+ ****************************************************************************/
+
+static void locks_copyline(FAR struct locks_read_s *rd, size_t linesize)
+{
+  if (rd->totalsize < rd->buflen)
+    {
+      if (linesize >= LOCKS_LINELEN)
+        {
+          linesize = LOCKS_LINELEN - 1;
+        }
+
+      rd->totalsize += procfs_memcpy(rd->procfile->line, linesize,
+                                     &rd->buffer[rd->totalsize],
+                                     rd->buflen - rd->totalsize,
+                                     &rd->offset);
+    }
+}
+
+/****************************************************************************
+ * Name: locks_holdtime
+ *
+ * Description:
+ *   Format the hold time statistics of one lock.  Called by
+ *   spin_holdtime_foreach().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPINLOCK_HOLDTIME
+static void locks_holdtime(FAR struct spinlock_holdtime_s *ht,
+                           FAR void *arg)
+{
+  FAR struct locks_read_s *rd = (FAR struct locks_read_s *)arg;
+  uint32_t avg;
+
+  avg = ht->ht_count > 0 ? (uint32_t)(ht->ht_total / ht->ht_count) : 0;
+
+  locks_copyline(rd, snprintf(rd->procfile->line, LOCKS_LINELEN,
+                              "%-12s %10lu %10lu %10lu\n", ht->ht_name,
+                              (unsigned long)ht->ht_count,
+                              (unsigned long)avg,
+                              (unsigned long)ht->ht_max));
+}
+#endif
+
+/****************************************************************************
+ * Name: locks_profile
+ *
+ * Description:
+ *   Format the lock contention profile.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_LOCKPROF
+static void locks_profile(FAR struct locks_read_s *rd)
+{
+  struct lockprof_s entry;
+  uint32_t avgwait;
+  uint32_t avghold;
+  int index;
+
+  locks_copyline(rd, snprintf(rd->procfile->line, LOCKS_LINELEN,
+                              "TYPE      LOCK       CALLER          COUNT"
+                              "  CONTENDED    AVGWAIT    MAXWAIT    AVGHOLD"
+                              "    MAXHOLD    EVICTED\n"));
+
+  for (index = 0;
+       rd->totalsize < rd->buflen &&
+       sched_lockprof_get(index, &entry) >= 0;
+       index++)
+    {
+      if (entry.lp_lock == NULL)
+        {
+          continue;
+        }
+
+      avgwait = entry.lp_contended > 0 ?
+        (uint32_t)(entry.lp_totalwait / entry.lp_contended) : 0;
+      avghold = entry.lp_nholds > 0 ?
+        (uint32_t)(entry.lp_totalhold / entry.lp_nholds) : 0;
+
+      /* The hold times of the critical section and of spinlocks are
+       * reported with the hold time statistics above.
+       */
+
+      if (entry.lp_type == LOCKPROF_CSECTION ||
+          entry.lp_type == LOCKPROF_SPINLOCK)
+        {
+          locks_copyline(rd, snprintf(rd->procfile->line, LOCKS_LINELEN,
+                                      "%-9s 0x%08lx 0x%08lx %10lu %10lu "
+                                      "%10lu %10lu %10s %10s %10s\n",
+                                      g_locktype[entry.lp_type & 3],
+                                      (unsigned long)(uintptr_t)entry.lp_lock,
+                                      (unsigned long)(uintptr_t)
+                                        entry.lp_caller,
+                                      (unsigned long)entry.lp_count,
+                                      (unsigned long)entry.lp_contended,
+                                      (unsigned long)avgwait,
+                                      (unsigned long)entry.lp_maxwait,
+                                      "-", "-", "-"));
+          continue;
+        }
+
+      locks_copyline(rd, snprintf(rd->procfile->line, LOCKS_LINELEN,
+                                  "%-9s 0x%08lx 0x%08lx %10lu %10lu %10lu "
+                                  "%10lu %10lu %10lu %10lu\n",
+                                  g_locktype[entry.lp_type & 3],
+                                  (unsigned long)(uintptr_t)entry.lp_lock,
+                                  (unsigned long)(uintptr_t)entry.lp_caller,
+                                  (unsigned long)entry.lp_count,
+                                  (unsigned long)entry.lp_contended,
+                                  (unsigned long)avgwait,
+                                  (unsigned long)entry.lp_maxwait,
+                                  (unsigned long)avghold,
+                                  (unsigned long)entry.lp_maxhold,
+                                  (unsigned long)entry.lp_evicted));
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: locks_open
+ ****************************************************************************/
+
+static int locks_open(FAR struct file *filep, FAR const char *relpath,
+                        int oflags, mode_t mode)
+{
+  FAR struct locks_file_s *procfile;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* "locks" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "locks") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  procfile = (FAR struct locks_file_s *)
+    kmm_zalloc(sizeof(struct locks_file_s));
+  if (!procfile)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)procfile;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: locks_close
+ ****************************************************************************/
+
+static int locks_close(FAR struct file *filep)
+{
+  FAR struct locks_file_s *procfile;
+
+  /* Recover our private data from the struct file instance */
+
+  procfile = (FAR struct locks_file_s *)filep->f_priv;
+  DEBUGASSERT(procfile);
+
+  /* Release the file attributes structure */
+
+  kmm_free(procfile);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: locks_read
+ *
+ * Description:
+ *   Return the lock hold time statistics and the lock contention profile.
+ *   The statistics are sampled line by line as the file is read.
+ *
+ ****************************************************************************/
+
+static ssize_t locks_read(FAR struct file *filep, FAR char *buffer,
+                          size_t buflen)
+{
+  struct locks_read_s rd;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  DEBUGASSERT(filep != NULL && buffer != NULL && buflen > 0);
+
+  /* Recover our private data from the struct file instance */
+
+  rd.procfile  = (FAR struct locks_file_s *)filep->f_priv;
+  rd.buffer    = buffer;
+  rd.buflen    = buflen;
+  rd.totalsize = 0;
+  rd.offset    = filep->f_pos;
+  DEBUGASSERT(rd.procfile);
+
+  /* The first line gives the unit of all times */
+
+  locks_copyline(&rd, snprintf(rd.procfile->line, LOCKS_LINELEN,
+                               "Times in units of 1/%lu seconds\n",
+                               (unsigned long)up_perf_getfreq()));
+
+#ifdef CONFIG_SPINLOCK_HOLDTIME
+  /* Followed by the hold times of the instrumented spinlocks */
+
+  locks_copyline(&rd, snprintf(rd.procfile->line, LOCKS_LINELEN,
+                               "\nLOCK              COUNT    AVGHOLD"
+                               "    MAXHOLD\n"));
+  spin_holdtime_foreach(locks_holdtime, &rd);
+#endif
+
+#ifdef CONFIG_SCHED_LOCKPROF
+  /* And by the lock contention profile */
+
+  locks_copyline(&rd, snprintf(rd.procfile->line, LOCKS_LINELEN, "\n"));
+  locks_profile(&rd);
+#endif
+
+  /* Update the file offset */
+
+  filep->f_pos += rd.totalsize;
+  return rd.totalsize;
+}
+
+/****************************************************************************
+ * Name: locks_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int locks_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct locks_file_s *oldattr;
+  FAR struct locks_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct locks_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = (FAR struct locks_file_s *)
+    kmm_malloc(sizeof(struct locks_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct locks_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: locks_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int locks_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "locks" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "locks") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* "locks" is the name for a read-only file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+#endif /* CONFIG_SPINLOCK_HOLDTIME || CONFIG_SCHED_LOCKPROF */
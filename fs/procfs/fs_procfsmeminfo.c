@@ -68,7 +68,11 @@
  * to handle the longest line generated by this logic.
  */
 
-#define MEMINFO_LINELEN 54
+#ifdef CONFIG_MM_CACHE
+#  define MEMINFO_LINELEN 65
+#else
+#  define MEMINFO_LINELEN 54
+#endif
 
 /****************************************************************************
  * Private Types
@@ -295,8 +299,14 @@ static ssize_t meminfo_read(FAR struct file *filep, FAR char *buffer,
 
   /* The first line is the headers */
 
+#ifdef CONFIG_MM_CACHE
+  linesize  = snprintf(procfile->line, MEMINFO_LINELEN,
+                       "             total       used       free    largest"
+                       "     cached\n");
+#else
   linesize  = snprintf(procfile->line, MEMINFO_LINELEN,
                        "             total       used       free    largest\n");
+#endif
   copysize  = procfs_memcpy(procfile->line, linesize, buffer, buflen,
                             &offset);
   totalsize = copysize;
@@ -317,12 +327,22 @@ static ssize_t meminfo_read(FAR struct file *filep, FAR char *buffer,
       (void)kmm_mallinfo(&mem);
 #endif
 
+#ifdef CONFIG_MM_CACHE
+      linesize   = snprintf(procfile->line, MEMINFO_LINELEN,
+                            "Kmem:  %11lu%11lu%11lu%11lu%11lu\n",
+                            (unsigned long)mem.arena,
+                            (unsigned long)mem.uordblks,
+                            (unsigned long)mem.fordblks,
+                            (unsigned long)mem.mxordblk,
+                            (unsigned long)mem.fsmblks);
+#else
       linesize   = snprintf(procfile->line, MEMINFO_LINELEN,
                             "Kmem:  %11lu%11lu%11lu%11lu\n",
                             (unsigned long)mem.arena,
                             (unsigned long)mem.uordblks,
                             (unsigned long)mem.fordblks,
                             (unsigned long)mem.mxordblk);
+#endif
       copysize   = procfs_memcpy(procfile->line, linesize, buffer, buflen,
                                  &offset);
       totalsize += copysize;
@@ -343,12 +363,22 @@ static ssize_t meminfo_read(FAR struct file *filep, FAR char *buffer,
       (void)kumm_mallinfo(&mem);
 #endif
 
+#ifdef CONFIG_MM_CACHE
+      linesize   = snprintf(procfile->line, MEMINFO_LINELEN,
+                            "Umem:  %11lu%11lu%11lu%11lu%11lu\n",
+                            (unsigned long)mem.arena,
+                            (unsigned long)mem.uordblks,
+                            (unsigned long)mem.fordblks,
+                            (unsigned long)mem.mxordblk,
+                            (unsigned long)mem.fsmblks);
+#else
       linesize   = snprintf(procfile->line, MEMINFO_LINELEN,
                             "Umem:  %11lu%11lu%11lu%11lu\n",
                             (unsigned long)mem.arena,
                             (unsigned long)mem.uordblks,
                             (unsigned long)mem.fordblks,
                             (unsigned long)mem.mxordblk);
+#endif
       copysize   = procfs_memcpy(procfile->line, linesize, buffer, buflen,
                                  &offset);
       totalsize += copysize;
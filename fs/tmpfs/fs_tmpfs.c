@@ -80,6 +80,10 @@
 #define tmpfs_unlock_directory(tdo) \
            (tmpfs_unlock_object((FAR struct tmpfs_object_s *)tdo))
 
+#ifndef CONFIG_FS_TMPFS_CHUNKED
+#  define tmpfs_free_file(tfo) kmm_free(tfo)
+#endif
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -95,6 +99,13 @@ static int  tmpfs_realloc_directory(FAR struct tmpfs_directory_s **tdo,
               unsigned int nentries);
 static int  tmpfs_realloc_file(FAR struct tmpfs_file_s **tfo,
               size_t newsize);
+#ifdef CONFIG_FS_TMPFS_CHUNKED
+static void tmpfs_read_pages(FAR struct tmpfs_file_s *tfo,
+              FAR char *buffer, off_t pos, size_t nbytes);
+static ssize_t tmpfs_write_pages(FAR struct tmpfs_file_s *tfo,
+              FAR const char *buffer, off_t pos, size_t nbytes);
+static void tmpfs_free_file(FAR struct tmpfs_file_s *tfo);
+#endif
 static void tmpfs_release_lockedobject(FAR struct tmpfs_object_s *to);
 static void tmpfs_release_lockedfile(FAR struct tmpfs_file_s *tfo);
 static int  tmpfs_find_dirent(FAR struct tmpfs_directory_s *tdo,
@@ -375,6 +386,226 @@ static int tmpfs_realloc_directory(FAR struct tmpfs_directory_s **tdo,
  * Name: tmpfs_realloc_file
  ****************************************************************************/
 
+#ifdef CONFIG_FS_TMPFS_CHUNKED
+static int tmpfs_realloc_file(FAR struct tmpfs_file_s **tfo,
+                              size_t newsize)
+{
+  FAR struct tmpfs_file_s *tmptfo = *tfo;
+  FAR uint8_t **newpages;
+  unsigned int npages;
+  unsigned int nslots;
+  unsigned int i;
+  size_t offset;
+
+  /* The file object itself never moves.  Only the page table is resized;
+   * data pages are allocated when they are first written.
+   */
+
+  npages = TMPFS_NPAGES(newsize);
+
+  if (newsize < tmptfo->tfo_size)
+    {
+      /* Shrinking ... Free all pages that lie wholly beyond the new end of
+       * the file.
+       */
+
+      for (i = npages; i < tmptfo->tfo_nslots; i++)
+        {
+          if (tmptfo->tfo_pages[i] != NULL)
+            {
+              kmm_free(tmptfo->tfo_pages[i]);
+              tmptfo->tfo_pages[i] = NULL;
+              tmptfo->tfo_alloc   -= TMPFS_PAGESIZE;
+            }
+        }
+
+      /* Zero the tail of the new last page so that the file reads as zeros
+       * if it is later extended.
+       */
+
+      offset = TMPFS_PAGEOFFSET(newsize);
+      if (offset > 0 && tmptfo->tfo_pages[npages - 1] != NULL)
+        {
+          memset(&tmptfo->tfo_pages[npages - 1][offset], 0,
+                 TMPFS_PAGESIZE - offset);
+        }
+
+      /* Release the page table too if the file is now empty */
+
+      if (newsize == 0 && tmptfo->tfo_pages != NULL)
+        {
+          kmm_free(tmptfo->tfo_pages);
+          tmptfo->tfo_alloc -= tmptfo->tfo_nslots * sizeof(FAR uint8_t *);
+          tmptfo->tfo_pages  = NULL;
+          tmptfo->tfo_nslots = 0;
+        }
+    }
+  else if (npages > tmptfo->tfo_nslots)
+    {
+      /* Growing beyond the page table.  Double its size so that appending
+       * to the file takes amortized constant time.
+       */
+
+      nslots = tmptfo->tfo_nslots > 0 ? tmptfo->tfo_nslots : 4;
+      while (nslots < npages)
+        {
+          nslots <<= 1;
+        }
+
+      newpages = (FAR uint8_t **)
+        kmm_realloc(tmptfo->tfo_pages, nslots * sizeof(FAR uint8_t *));
+      if (newpages == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      /* New page table entries are holes */
+
+      memset(&newpages[tmptfo->tfo_nslots], 0,
+             (nslots - tmptfo->tfo_nslots) * sizeof(FAR uint8_t *));
+
+      tmptfo->tfo_alloc += (nslots - tmptfo->tfo_nslots) *
+                           sizeof(FAR uint8_t *);
+      tmptfo->tfo_pages  = newpages;
+      tmptfo->tfo_nslots = nslots;
+    }
+
+  tmptfo->tfo_size = newsize;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: tmpfs_read_pages
+ *
+ * Description:
+ *   Copy file data into the user buffer.  The range must lie within the
+ *   file.  Holes read as zeros.
+ *
+ ****************************************************************************/
+
+static void tmpfs_read_pages(FAR struct tmpfs_file_s *tfo,
+                             FAR char *buffer, off_t pos, size_t nbytes)
+{
+  FAR uint8_t *page;
+  size_t offset;
+  size_t ncopy;
+
+  while (nbytes > 0)
+    {
+      page   = tfo->tfo_pages[TMPFS_PAGE(pos)];
+      offset = TMPFS_PAGEOFFSET(pos);
+      ncopy  = TMPFS_PAGESIZE - offset;
+
+      if (ncopy > nbytes)
+        {
+          ncopy = nbytes;
+        }
+
+      if (page == NULL)
+        {
+          memset(buffer, 0, ncopy);
+        }
+      else
+        {
+          memcpy(buffer, &page[offset], ncopy);
+        }
+
+      buffer += ncopy;
+      pos    += ncopy;
+      nbytes -= ncopy;
+    }
+}
+
+/****************************************************************************
+ * Name: tmpfs_write_pages
+ *
+ * Description:
+ *   Copy user data into the file, allocating pages as needed.  The page
+ *   table must already cover the range.
+ *
+ * Returned Value:
+ *   The number of bytes written, which is less than nbytes only if a page
+ *   could not be allocated.  -ENOMEM if nothing could be written.
+ *
+ ****************************************************************************/
+
+static ssize_t tmpfs_write_pages(FAR struct tmpfs_file_s *tfo,
+                                 FAR const char *buffer, off_t pos,
+                                 size_t nbytes)
+{
+  FAR uint8_t *page;
+  ssize_t nwritten = 0;
+  size_t offset;
+  size_t ncopy;
+
+  while (nbytes > 0)
+    {
+      page   = tfo->tfo_pages[TMPFS_PAGE(pos)];
+      offset = TMPFS_PAGEOFFSET(pos);
+      ncopy  = TMPFS_PAGESIZE - offset;
+
+      if (ncopy > nbytes)
+        {
+          ncopy = nbytes;
+        }
+
+      if (page == NULL)
+        {
+          page = (FAR uint8_t *)kmm_malloc(TMPFS_PAGESIZE);
+          if (page == NULL)
+            {
+              return nwritten > 0 ? nwritten : -ENOMEM;
+            }
+
+          /* Zero whatever part of the new page is not about to be
+           * written.
+           */
+
+          if (ncopy < TMPFS_PAGESIZE)
+            {
+              memset(page, 0, TMPFS_PAGESIZE);
+            }
+
+          tfo->tfo_pages[TMPFS_PAGE(pos)] = page;
+          tfo->tfo_alloc += TMPFS_PAGESIZE;
+        }
+
+      memcpy(&page[offset], buffer, ncopy);
+
+      buffer   += ncopy;
+      pos      += ncopy;
+      nbytes   -= ncopy;
+      nwritten += ncopy;
+    }
+
+  return nwritten;
+}
+
+/****************************************************************************
+ * Name: tmpfs_free_file
+ ****************************************************************************/
+
+static void tmpfs_free_file(FAR struct tmpfs_file_s *tfo)
+{
+  unsigned int i;
+
+  for (i = 0; i < tfo->tfo_nslots; i++)
+    {
+      if (tfo->tfo_pages[i] != NULL)
+        {
+          kmm_free(tfo->tfo_pages[i]);
+        }
+    }
+
+  if (tfo->tfo_pages != NULL)
+    {
+      kmm_free(tfo->tfo_pages);
+    }
+
+  kmm_free(tfo);
+}
+
+#else
 static int tmpfs_realloc_file(FAR struct tmpfs_file_s **tfo,
                               size_t newsize)
 {
@@ -439,6 +670,7 @@ static int tmpfs_realloc_file(FAR struct tmpfs_file_s **tfo,
   *tfo              = newtfo;
   return OK;
 }
+#endif
 
 /****************************************************************************
  * Name: tmpfs_release_lockedobject
@@ -476,7 +708,7 @@ static void tmpfs_release_lockedfile(FAR struct tmpfs_file_s *tfo)
   if (tfo->tfo_refs == 1 && (tfo->tfo_flags & TFO_FLAG_UNLINKED) != 0)
     {
       nxsem_destroy(&tfo->tfo_exclsem.ts_sem);
-      kmm_free(tfo);
+      tmpfs_free_file(tfo);
     }
 
   /* Otherwise, just decrement the reference count on the file object */
@@ -642,6 +874,10 @@ static FAR struct tmpfs_file_s *tmpfs_alloc_file(void)
   tfo->tfo_refs  = 1;
   tfo->tfo_flags = 0;
   tfo->tfo_size  = 0;
+#ifdef CONFIG_FS_TMPFS_CHUNKED
+  tfo->tfo_nslots = 0;
+  tfo->tfo_pages  = NULL;
+#endif
 
   tfo->tfo_exclsem.ts_holder = getpid();
   tfo->tfo_exclsem.ts_count  = 1;
@@ -1280,7 +1516,16 @@ static int tmpfs_free_callout(FAR struct tmpfs_directory_s *tdo,
   /* Free the object now */
 
   nxsem_destroy(&to->to_exclsem.ts_sem);
-  kmm_free(to);
+
+  if (to->to_type == TMPFS_REGULAR)
+    {
+      tmpfs_free_file((FAR struct tmpfs_file_s *)to);
+    }
+  else
+    {
+      kmm_free(to);
+    }
+
   return TMPFS_DELETED;
 }
 
@@ -1543,7 +1788,7 @@ static int tmpfs_close(FAR struct file *filep)
        * have any other references.
        */
 
-      kmm_free(tfo);
+      tmpfs_free_file(tfo);
       return OK;
     }
 
@@ -1583,7 +1828,11 @@ static ssize_t tmpfs_read(FAR struct file *filep, FAR char *buffer,
   nread    = buflen;
   endpos   = startpos + buflen;
 
-  if (endpos > tfo->tfo_size)
+  if (startpos >= (off_t)tfo->tfo_size)
+    {
+      nread = 0;
+    }
+  else if (endpos > tfo->tfo_size)
     {
       endpos = tfo->tfo_size;
       nread  = endpos - startpos;
@@ -1591,7 +1840,11 @@ static ssize_t tmpfs_read(FAR struct file *filep, FAR char *buffer,
 
   /* Copy data from the memory object to the user buffer */
 
+#ifdef CONFIG_FS_TMPFS_CHUNKED
+  tmpfs_read_pages(tfo, buffer, startpos, nread);
+#else
   memcpy(buffer, &tfo->tfo_data[startpos], nread);
+#endif
   filep->f_pos += nread;
 
   /* Release the lock on the file */
@@ -1611,6 +1864,9 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
   ssize_t nwritten;
   off_t startpos;
   off_t endpos;
+#ifdef CONFIG_FS_TMPFS_CHUNKED
+  off_t oldsize;
+#endif
   int ret;
 
   finfo("filep: %p buffer: %p buflen: %lu\n",
@@ -1630,6 +1886,9 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
   startpos = filep->f_pos;
   nwritten = buflen;
   endpos   = startpos + buflen;
+#ifdef CONFIG_FS_TMPFS_CHUNKED
+  oldsize  = tfo->tfo_size;
+#endif
 
   if (endpos > tfo->tfo_size)
     {
@@ -1644,9 +1903,29 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
       filep->f_priv = tfo;
     }
 
-  /* Copy data from the memory object to the user buffer */
+  /* Copy data from the user buffer to the memory object */
+
+#ifdef CONFIG_FS_TMPFS_CHUNKED
+  nwritten = tmpfs_write_pages(tfo, buffer, startpos, buflen);
+  if (nwritten < (ssize_t)buflen && endpos > oldsize)
+    {
+      /* Out of memory part way through.  Trim the file back to what was
+       * actually written.
+       */
 
+      endpos = startpos + (nwritten > 0 ? nwritten : 0);
+      (void)tmpfs_realloc_file(&tfo, endpos > oldsize ? endpos : oldsize);
+    }
+
+  if (nwritten < 0)
+    {
+      ret = nwritten;
+      goto errout_with_lock;
+    }
+#else
   memcpy(&tfo->tfo_data[startpos], buffer, nwritten);
+#endif
+
   filep->f_pos += nwritten;
 
   /* Release the lock on the file */
@@ -1733,7 +2012,7 @@ static int tmpfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
   /* Recover our private data from the struct file instance */
 
-  tfo = filep->f_inode->i_private;
+  tfo = filep->f_priv;
 
   DEBUGASSERT(tfo != NULL);
 
@@ -1741,12 +2020,51 @@ static int tmpfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
   if (cmd == FIOC_MMAP && ppv != NULL)
     {
+#ifdef CONFIG_FS_TMPFS_CHUNKED
+      int ret = -ENOTTY;
+
+      /* The file data is contiguous only if it fits within the first page.
+       * Otherwise, fail so that mmap() can fall back to copying the file
+       * into memory (CONFIG_FS_RAMMAP).
+       */
+
+      tmpfs_lock_file(tfo);
+      if (tfo->tfo_size > 0 && tfo->tfo_size <= TMPFS_PAGESIZE)
+        {
+          /* The page table has at least one slot since the file is not
+           * empty.  Fill a hole so that the returned address is stable.
+           */
+
+          if (tfo->tfo_pages[0] == NULL)
+            {
+              tfo->tfo_pages[0] = (FAR uint8_t *)kmm_zalloc(TMPFS_PAGESIZE);
+              if (tfo->tfo_pages[0] != NULL)
+                {
+                  tfo->tfo_alloc += TMPFS_PAGESIZE;
+                }
+            }
+
+          if (tfo->tfo_pages[0] != NULL)
+            {
+              *ppv = (FAR void *)tfo->tfo_pages[0];
+              ret  = OK;
+            }
+          else
+            {
+              ret  = -ENOMEM;
+            }
+        }
+
+      tmpfs_unlock_file(tfo);
+      return ret;
+#else
       /* Return the address on the media corresponding to the start of
        * the file.
        */
 
       *ppv = (FAR void *)tfo->tfo_data;
       return OK;
+#endif
     }
 
   ferr("ERROR: Invalid cmd: %d\n", cmd);
@@ -1862,10 +2180,12 @@ static int tmpfs_truncate(FAR struct file *filep, off_t length)
        * memory.
        */
 
+#ifndef CONFIG_FS_TMPFS_CHUNKED
       if (length > oldsize)
         {
           memset(&tfo->tfo_data[oldsize], 0, length - oldsize);
         }
+#endif
 
       ret = OK;
     }
@@ -2276,7 +2596,7 @@ static int tmpfs_unlink(FAR struct inode *mountpt, FAR const char *relpath)
   else
     {
       nxsem_destroy(&tfo->tfo_exclsem.ts_sem);
-      kmm_free(tfo);
+      tmpfs_free_file(tfo);
     }
 
   /* Release the reference and lock on the parent directory */
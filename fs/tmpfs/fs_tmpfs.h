@@ -58,6 +58,15 @@
 
 #define TFO_FLAG_UNLINKED (1 << 0)  /* Bit 0: File is unlinked */
 
+/* Page-chunked file storage */
+
+#ifdef CONFIG_FS_TMPFS_CHUNKED
+#  define TMPFS_PAGESIZE        CONFIG_FS_TMPFS_PAGESIZE
+#  define TMPFS_PAGE(o)         ((size_t)(o) / TMPFS_PAGESIZE)
+#  define TMPFS_PAGEOFFSET(o)   ((size_t)(o) % TMPFS_PAGESIZE)
+#  define TMPFS_NPAGES(s)       (((size_t)(s) + TMPFS_PAGESIZE - 1) / TMPFS_PAGESIZE)
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -137,6 +146,11 @@ struct tmpfs_directory_s
  * state.  The file memory object also serves as the open file object,
  * saving an allocation.  This has the negative side effect that no per-
  * open state can be retained (such as open flags).
+ *
+ * With CONFIG_FS_TMPFS_CHUNKED, the file data is not part of the file
+ * object.  Instead, tfo_pages[] holds one pointer for each TMPFS_PAGESIZE
+ * page of the file.  A NULL pointer is a hole that reads as zeros.  Bytes
+ * beyond tfo_size in an allocated page are always zero.
  */
 
 struct tmpfs_file_s
@@ -154,10 +168,19 @@ struct tmpfs_file_s
 
   uint8_t  tfo_flags;    /* See TFO_FLAG_* definitions */
   size_t   tfo_size;     /* Valid file size */
+#ifdef CONFIG_FS_TMPFS_CHUNKED
+  unsigned int tfo_nslots; /* Number of entries in tfo_pages[] */
+  FAR uint8_t **tfo_pages; /* Page table */
+#else
   uint8_t  tfo_data[1];  /* File data starts here */
+#endif
 };
 
-#define SIZEOF_TMPFS_FILE(n) (sizeof(struct tmpfs_file_s) + (n) - 1)
+#ifdef CONFIG_FS_TMPFS_CHUNKED
+#  define SIZEOF_TMPFS_FILE(n) (sizeof(struct tmpfs_file_s))
+#else
+#  define SIZEOF_TMPFS_FILE(n) (sizeof(struct tmpfs_file_s) + (n) - 1)
+#endif
 
 /* This structure represents one instance of a TMPFS file system */
 
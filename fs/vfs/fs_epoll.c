@@ -42,15 +42,719 @@
 #include <sys/epoll.h>
 
 #include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
 #include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <queue.h>
 #include <errno.h>
-#include <string.h>
 #include <debug.h>
 
+#include <nuttx/irq.h>
+#include <nuttx/clock.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/cancelpt.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/net/net.h>
+
+#include "inode/inode.h"
 
 #ifndef CONFIG_DISABLE_POLL
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The interest list is indexed by descriptor number */
+
+#if defined(CONFIG_NET) && CONFIG_NSOCKET_DESCRIPTORS > 0
+#  define EPOLL_NFDS (CONFIG_NFILE_DESCRIPTORS + CONFIG_NSOCKET_DESCRIPTORS)
+#else
+#  define EPOLL_NFDS CONFIG_NFILE_DESCRIPTORS
+#endif
+
+/* Values of the epoll_item_s flags field */
+
+#define EPOLL_ARMED    (1 << 0)  /* The poll is set up with the driver */
+#define EPOLL_READY    (1 << 1)  /* The item is in the ready list */
+#define EPOLL_RECHECK  (1 << 2)  /* Re-poll before reporting the item again */
+#define EPOLL_DISABLED (1 << 3)  /* EPOLLONESHOT item has been reported */
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct epoll_head_s;
+
+/* One descriptor in the interest list of an epoll instance.  The pollfd
+ * stays set up with the driver for as long as the descriptor is in the
+ * interest list.  Instead of posting a semaphore, the driver notification
+ * adds the item to the ready list.
+ */
+
+struct epoll_item_s
+{
+  dq_entry_t node;                  /* Link in the ready list */
+  FAR struct epoll_item_s *oflink;  /* Next item of the same file/socket */
+  FAR struct epoll_item_s *oblink;  /* Previous item of the same file/socket */
+  struct pollfd pfd;                /* Persistent poll set up */
+  FAR void *obj;                    /* struct file or struct socket of fd */
+  FAR struct epoll_head_s *eph;     /* The epoll instance */
+  epoll_data_t data;                /* User data returned with the events */
+  uint32_t events;                  /* Requested events, EPOLLET, ... */
+  uint8_t flags;                    /* See EPOLL_* definitions */
+};
+
+/* The state of one epoll instance.  This is the private data of the epoll
+ * file descriptor.  exclsem serializes epoll_ctl(), epoll_wait() and the
+ * removal of closed descriptors on this instance.  crefs counts the epoll
+ * file descriptor plus each epoll_detach() that is waiting for exclsem.
+ */
+
+struct epoll_head_s
+{
+  sem_t exclsem;                    /* Protects the interest list */
+  sem_t sem;                        /* Posted when an item becomes ready */
+  int16_t crefs;                    /* References to this structure */
+  dq_queue_t ready;                 /* Items with pending events */
+  unsigned int nnotify;             /* Posts of sem by epoll_notify() */
+  bool scan;                        /* sem was posted by a driver */
+  FAR struct epoll_item_s *items[EPOLL_NFDS]; /* Interest list */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int epoll_file_close(FAR struct file *filep);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_epoll_ops =
+{
+  NULL,                 /* open */
+  epoll_file_close, /* close */
+  NULL,                 /* read */
+  NULL,                 /* write */
+  NULL,                 /* seek */
+  NULL                  /* ioctl */
+#ifndef CONFIG_DISABLE_POLL
+  , NULL                /* poll */
+#endif
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  , NULL                /* unlink */
+#endif
+};
+
+/* All epoll file descriptors refer to this inode.  It is not part of the
+ * pseudo-file system tree and is never freed.
+ */
+
+static struct inode g_epoll_inode;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: epoll_semtake
+ *
+ * Description:
+ *   Take the exclsem of an epoll instance, ignoring signals.  Used on the
+ *   close paths which cannot fail.
+ *
+ ****************************************************************************/
+
+static void epoll_semtake(FAR struct epoll_head_s *eph)
+{
+  int ret;
+
+  do
+    {
+      ret = nxsem_wait(&eph->exclsem);
+      DEBUGASSERT(ret == OK || ret == -EINTR);
+    }
+  while (ret < 0);
+}
+
+/****************************************************************************
+ * Name: epoll_release
+ *
+ * Description:
+ *   Drop one reference to an epoll instance and free it with the last one.
+ *
+ ****************************************************************************/
+
+static void epoll_release(FAR struct epoll_head_s *eph)
+{
+  irqstate_t flags;
+  int16_t crefs;
+
+  flags = enter_critical_section();
+  crefs = --eph->crefs;
+  leave_critical_section(flags);
+
+  if (crefs <= 0)
+    {
+      nxsem_destroy(&eph->exclsem);
+      nxsem_destroy(&eph->sem);
+      kmm_free(eph);
+    }
+}
+
+/****************************************************************************
+ * Name: epoll_objlist
+ *
+ * Description:
+ *   Return the list of the epoll items registered for the file or socket of
+ *   an item.
+ *
+ ****************************************************************************/
+
+static FAR struct epoll_item_s **epoll_objlist(FAR struct epoll_item_s *item)
+{
+#if defined(CONFIG_NET) && CONFIG_NSOCKET_DESCRIPTORS > 0
+  if (item->pfd.fd >= CONFIG_NFILE_DESCRIPTORS)
+    {
+      return &((FAR struct socket *)item->obj)->s_epoll;
+    }
+#endif
+
+  return &((FAR struct file *)item->obj)->f_epoll;
+}
+
+/****************************************************************************
+ * Name: epoll_objlink and epoll_objunlink
+ *
+ * Description:
+ *   Add an item to, or remove it from, the list of the epoll items of its
+ *   file or socket.  These lists are shared by all epoll instances and are
+ *   only modified in a critical section.
+ *
+ ****************************************************************************/
+
+static void epoll_objlink(FAR struct epoll_item_s *item)
+{
+  FAR struct epoll_item_s **list = epoll_objlist(item);
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  item->oblink = NULL;
+  item->oflink = *list;
+  if (*list != NULL)
+    {
+      (*list)->oblink = item;
+    }
+
+  *list = item;
+  leave_critical_section(flags);
+}
+
+static void epoll_objunlink(FAR struct epoll_item_s *item)
+{
+  FAR struct epoll_item_s **list = epoll_objlist(item);
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  if (item->oblink != NULL)
+    {
+      item->oblink->oflink = item->oflink;
+    }
+  else
+    {
+      *list = item->oflink;
+    }
+
+  if (item->oflink != NULL)
+    {
+      item->oflink->oblink = item->oblink;
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: epoll_getobj
+ *
+ * Description:
+ *   Get the struct file or struct socket that a descriptor refers to.
+ *
+ ****************************************************************************/
+
+static int epoll_getobj(int fd, FAR void **obj)
+{
+  FAR struct file *filep;
+  int ret;
+
+#if defined(CONFIG_NET) && CONFIG_NSOCKET_DESCRIPTORS > 0
+  if (fd >= CONFIG_NFILE_DESCRIPTORS)
+    {
+      FAR struct socket *psock = sockfd_socket(fd);
+
+      if (psock == NULL || psock->s_crefs <= 0)
+        {
+          return -EBADF;
+        }
+
+      *obj = psock;
+      return OK;
+    }
+#endif
+
+  ret = fs_getfilep(fd, &filep);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  *obj = filep;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: epoll_fdsetup
+ *
+ * Description:
+ *   Set up (or tear down) the poll on the file or socket of an item.  The
+ *   struct file or struct socket is used rather than the descriptor number
+ *   so that the descriptor table of the caller does not matter.
+ *
+ ****************************************************************************/
+
+static int epoll_fdsetup(FAR struct epoll_item_s *item, bool setup)
+{
+#if defined(CONFIG_NET) && CONFIG_NSOCKET_DESCRIPTORS > 0
+  if (item->pfd.fd >= CONFIG_NFILE_DESCRIPTORS)
+    {
+      return psock_poll((FAR struct socket *)item->obj, &item->pfd, setup);
+    }
+#endif
+
+  return file_poll((FAR struct file *)item->obj, &item->pfd, setup);
+}
+
+/****************************************************************************
+ * Name: epoll_enqueue
+ *
+ * Description:
+ *   Add an item to the tail of the ready list if it is not already there.
+ *   Returns true if the item was added.
+ *
+ * Assumptions:
+ *   Called in a critical section.
+ *
+ ****************************************************************************/
+
+static bool epoll_enqueue(FAR struct epoll_item_s *item)
+{
+  if ((item->flags & (EPOLL_READY | EPOLL_DISABLED)) == 0)
+    {
+      dq_addlast(&item->node, &item->eph->ready);
+      item->flags |= EPOLL_READY;
+      return true;
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: epoll_dequeue
+ *
+ * Description:
+ *   Remove an item from the ready list if it is there.
+ *
+ * Assumptions:
+ *   Called in a critical section.
+ *
+ ****************************************************************************/
+
+static void epoll_dequeue(FAR struct epoll_item_s *item)
+{
+  if ((item->flags & EPOLL_READY) != 0)
+    {
+      dq_rem(&item->node, &item->eph->ready);
+      item->flags &= ~EPOLL_READY;
+    }
+}
+
+/****************************************************************************
+ * Name: epoll_notify
+ *
+ * Description:
+ *   The pollfd notification callback.  Called by poll_notify() (possibly
+ *   from an interrupt handler) when the driver has updated revents.
+ *
+ ****************************************************************************/
+
+static void epoll_notify(FAR struct pollfd *fds)
+{
+  FAR struct epoll_item_s *item = (FAR struct epoll_item_s *)fds->arg;
+  FAR struct epoll_head_s *eph = item->eph;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+
+  /* Some drivers set up "shadow" pollfds that share our callback */
+
+  if (fds != &item->pfd)
+    {
+      item->pfd.revents |= fds->revents;
+    }
+
+  /* Add the item to the ready list and wake up epoll_wait() */
+
+  if (epoll_enqueue(item))
+    {
+      eph->nnotify++;
+      nxsem_post(&eph->sem);
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: epoll_account
+ *
+ * Description:
+ *   Account for one count taken from eph->sem.  Drivers that have not been
+ *   converted to poll_notify() post the semaphore directly.  In that case,
+ *   the ready list is not updated and the interest list must be scanned.
+ *
+ * Assumptions:
+ *   Called in a critical section.
+ *
+ ****************************************************************************/
+
+static void epoll_account(FAR struct epoll_head_s *eph)
+{
+  if (eph->nnotify > 0)
+    {
+      eph->nnotify--;
+    }
+  else
+    {
+      eph->scan = true;
+    }
+}
+
+/****************************************************************************
+ * Name: epoll_arm
+ *
+ * Description:
+ *   (Re-)set up the poll of an item with its driver.  Events that are
+ *   already pending are reported in the pfd.revents.
+ *
+ ****************************************************************************/
+
+static int epoll_arm(FAR struct epoll_item_s *item)
+{
+  irqstate_t flags;
+  int ret;
+
+  if ((item->flags & EPOLL_ARMED) != 0)
+    {
+      (void)epoll_fdsetup(item, false);
+    }
+
+  flags = enter_critical_section();
+  item->flags       &= ~EPOLL_ARMED;
+  item->pfd.revents  = 0;
+  item->pfd.priv     = NULL;
+  leave_critical_section(flags);
+
+  ret = epoll_fdsetup(item, true);
+
+  flags = enter_critical_section();
+  if (ret < 0)
+    {
+      item->pfd.revents |= POLLERR;
+    }
+  else
+    {
+      item->flags |= EPOLL_ARMED;
+    }
+
+  /* Drivers that post the semaphore directly do not add the item to the
+   * ready list.
+   */
+
+  if (item->pfd.revents != 0)
+    {
+      (void)epoll_enqueue(item);
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: epoll_disarm
+ *
+ * Description:
+ *   Tear down the poll of an item with its driver and remove it from the
+ *   ready list.
+ *
+ ****************************************************************************/
+
+static void epoll_disarm(FAR struct epoll_item_s *item)
+{
+  irqstate_t flags;
+
+  if ((item->flags & EPOLL_ARMED) != 0)
+    {
+      (void)epoll_fdsetup(item, false);
+    }
+
+  flags = enter_critical_section();
+  item->flags &= ~EPOLL_ARMED;
+  epoll_dequeue(item);
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: epoll_remove
+ *
+ * Description:
+ *   Tear down the poll of an item, remove it from the interest list of its
+ *   epoll instance and free it.
+ *
+ * Assumptions:
+ *   The caller holds the exclsem of the epoll instance.
+ *
+ ****************************************************************************/
+
+static void epoll_remove(FAR struct epoll_item_s *item)
+{
+  epoll_disarm(item);
+  epoll_objunlink(item);
+  item->eph->items[item->pfd.fd] = NULL;
+  kmm_free(item);
+}
+
+/****************************************************************************
+ * Name: epoll_scan
+ *
+ * Description:
+ *   Add all items with pending events to the ready list.  This is only
+ *   necessary if a driver posted the semaphore directly.
+ *
+ ****************************************************************************/
+
+static void epoll_scan(FAR struct epoll_head_s *eph)
+{
+  FAR struct epoll_item_s *item;
+  irqstate_t flags;
+  int fd;
+
+  for (fd = 0; fd < EPOLL_NFDS; fd++)
+    {
+      item = eph->items[fd];
+      if (item != NULL)
+        {
+          flags = enter_critical_section();
+          if (item->pfd.revents != 0)
+            {
+              (void)epoll_enqueue(item);
+            }
+
+          leave_critical_section(flags);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: epoll_harvest
+ *
+ * Description:
+ *   Report the events of the items in the ready list.  Only the ready
+ *   items are visited.  Returns the number of events reported.
+ *
+ ****************************************************************************/
+
+static int epoll_harvest(FAR struct epoll_head_s *eph,
+                         FAR struct epoll_event *evs, int maxevents)
+{
+  FAR struct epoll_item_s *item;
+  FAR dq_entry_t *node;
+  dq_queue_t ready;
+  pollevent_t revents;
+  irqstate_t flags;
+  int nevents = 0;
+
+  /* Take the current ready list.  Items that become ready while it is
+   * processed go to the new ready list and are reported next time.
+   */
+
+  flags = enter_critical_section();
+  ready = eph->ready;
+  dq_init(&eph->ready);
+  leave_critical_section(flags);
+
+  while (nevents < maxevents)
+    {
+      flags = enter_critical_section();
+      item  = (FAR struct epoll_item_s *)dq_remfirst(&ready);
+      if (item == NULL)
+        {
+          leave_critical_section(flags);
+          break;
+        }
+
+      item->flags &= ~EPOLL_READY;
+      leave_critical_section(flags);
+
+      /* A level-triggered item that was reported by the last epoll_wait()
+       * is polled again to see if it is still ready.
+       */
+
+      if ((item->flags & EPOLL_RECHECK) != 0)
+        {
+          flags = enter_critical_section();
+          item->flags &= ~EPOLL_RECHECK;
+          leave_critical_section(flags);
+
+          (void)epoll_arm(item);
+        }
+
+      flags = enter_critical_section();
+      revents = item->pfd.revents;
+      item->pfd.revents = 0;
+      epoll_dequeue(item);
+      leave_critical_section(flags);
+
+      if (revents == 0)
+        {
+          continue;
+        }
+
+      evs[nevents].events = revents;
+      evs[nevents].data   = item->data;
+      nevents++;
+
+      if ((item->events & EPOLLONESHOT) != 0)
+        {
+          /* Disable the item until it is re-armed with EPOLL_CTL_MOD */
+
+          epoll_disarm(item);
+
+          flags = enter_critical_section();
+          item->flags |= EPOLL_DISABLED;
+          leave_critical_section(flags);
+        }
+      else if ((item->events & EPOLLET) != 0)
+        {
+          /* Some drivers stop notifying after the first event, so re-arm
+           * the poll now.  The caller will consume all pending data, so
+           * only events that occur from now on are reported.
+           */
+
+          if (epoll_arm(item) >= 0)
+            {
+              flags = enter_critical_section();
+              item->pfd.revents = 0;
+              epoll_dequeue(item);
+              leave_critical_section(flags);
+            }
+        }
+      else
+        {
+          /* Level-triggered:  Keep the item in the ready list so that it
+           * is re-polled and reported as long as it stays ready.
+           */
+
+          flags = enter_critical_section();
+          item->flags |= EPOLL_RECHECK;
+          (void)epoll_enqueue(item);
+          leave_critical_section(flags);
+        }
+    }
+
+  /* Return any items that were not processed to the head of the ready
+   * list.
+   */
+
+  flags = enter_critical_section();
+  while ((node = dq_remlast(&ready)) != NULL)
+    {
+      dq_addfirst(node, &eph->ready);
+    }
+
+  leave_critical_section(flags);
+  return nevents;
+}
+
+/****************************************************************************
+ * Name: epoll_gethead
+ *
+ * Description:
+ *   Get the epoll instance associated with an epoll file descriptor.
+ *
+ ****************************************************************************/
+
+static int epoll_gethead(int epfd, FAR struct epoll_head_s **eph)
+{
+  FAR struct file *filep;
+  int ret;
+
+  ret = fs_getfilep(epfd, &filep);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Descriptors created by dup() do not carry the epoll instance */
+
+  if (filep->f_inode != &g_epoll_inode || filep->f_priv == NULL)
+    {
+      return -EINVAL;
+    }
+
+  *eph = (FAR struct epoll_head_s *)filep->f_priv;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: epoll_file_close
+ *
+ * Description:
+ *   The close method of the epoll file descriptor:  Tear down all polls
+ *   and free the epoll instance.
+ *
+ ****************************************************************************/
+
+static int epoll_file_close(FAR struct file *filep)
+{
+  FAR struct epoll_head_s *eph = (FAR struct epoll_head_s *)filep->f_priv;
+  FAR struct epoll_item_s *item;
+  int fd;
+
+  if (eph != NULL)
+    {
+      epoll_semtake(eph);
+      for (fd = 0; fd < EPOLL_NFDS; fd++)
+        {
+          item = eph->items[fd];
+          if (item != NULL)
+            {
+              epoll_remove(item);
+            }
+        }
+
+      nxsem_post(&eph->exclsem);
+
+      /* epoll_detach() may still hold a reference */
+
+      filep->f_priv = NULL;
+      epoll_release(eph);
+    }
+
+  return OK;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -59,180 +763,488 @@
  * Name: epoll_create
  *
  * Description:
+ *   Create an epoll instance and return a file descriptor that refers to
+ *   it.  The descriptor is released with close() (or epoll_close()).
  *
  * Input Parameters:
+ *   size - Ignored, but must be greater than zero.  The interest list
+ *          holds any number of descriptors.
  *
  * Returned Value:
+ *   The epoll file descriptor on success.  On error, -1 is returned and
+ *   errno is set appropriately:
+ *
+ *   EINVAL - size is not positive.
+ *   EMFILE - No free file descriptor.
+ *   ENOMEM - Out of memory.
  *
  ****************************************************************************/
 
 int epoll_create(int size)
 {
-  FAR struct epoll_head *eph =
-    (FAR struct epoll_head *)kmm_malloc(sizeof(struct epoll_head));
+  FAR struct epoll_head_s *eph;
+  FAR struct file *filep;
+  int errcode;
+  int fd;
 
-  eph->size = size;
-  eph->occupied = 0;
-  eph->evs = kmm_malloc(sizeof(struct epoll_event) * eph->size);
+  if (size <= 0)
+    {
+      errcode = EINVAL;
+      goto errout;
+    }
+
+  eph = (FAR struct epoll_head_s *)kmm_zalloc(sizeof(struct epoll_head_s));
+  if (eph == NULL)
+    {
+      errcode = ENOMEM;
+      goto errout;
+    }
 
-  /* REVISIT: This will not work on machines where:
-   * sizeof(struct epoll_head *) > sizeof(int)
+  /* This semaphore is used for signaling and, hence, should not have
+   * priority inheritance enabled.
    */
 
-  return (int)((intptr_t)eph);
+  nxsem_init(&eph->sem, 0, 0);
+  nxsem_setprotocol(&eph->sem, SEM_PRIO_NONE);
+  nxsem_init(&eph->exclsem, 0, 1);
+  dq_init(&eph->ready);
+  eph->crefs = 1;
+
+  if (g_epoll_inode.u.i_ops == NULL)
+    {
+      g_epoll_inode.i_crefs  = 1;
+      g_epoll_inode.u.i_ops = &g_epoll_ops;
+    }
+
+  /* Allocate a file descriptor that refers to the epoll instance */
+
+  inode_addref(&g_epoll_inode);
+  fd = files_allocate(&g_epoll_inode, O_RDOK, 0, 0);
+  if (fd < 0)
+    {
+      inode_release(&g_epoll_inode);
+      errcode = EMFILE;
+      goto errout_with_eph;
+    }
+
+  if (fs_getfilep(fd, &filep) < 0)
+    {
+      errcode = EBADF;
+      goto errout_with_eph;
+    }
+
+  filep->f_priv = eph;
+  return fd;
+
+errout_with_eph:
+  nxsem_destroy(&eph->exclsem);
+  nxsem_destroy(&eph->sem);
+  kmm_free(eph);
+
+errout:
+  set_errno(errcode);
+  return ERROR;
 }
 
 /****************************************************************************
  * Name: epoll_close
  *
  * Description:
+ *   Close an epoll file descriptor.  Retained for compatibility;
+ *   equivalent to close(epfd).
  *
  * Input Parameters:
+ *   epfd - The epoll file descriptor
  *
  * Returned Value:
+ *   None
  *
  ****************************************************************************/
 
 void epoll_close(int epfd)
 {
-  /* REVISIT: This will not work on machines where:
-   * sizeof(struct epoll_head *) > sizeof(int)
-   */
-
-  FAR struct epoll_head *eph = (FAR struct epoll_head *)((intptr_t)epfd);
-
-  kmm_free(eph->evs);
-  kmm_free(eph);
+  (void)close(epfd);
 }
 
 /****************************************************************************
  * Name: epoll_ctl
  *
  * Description:
+ *   Add, modify or remove a descriptor in the interest list of an epoll
+ *   instance.  The poll of the descriptor is set up once when it is added
+ *   and stays set up until it is removed.  Closing the descriptor removes
+ *   it from the interest list (see epoll_detach()).
  *
  * Input Parameters:
+ *   epfd - The epoll file descriptor
+ *   op   - EPOLL_CTL_ADD, EPOLL_CTL_MOD or EPOLL_CTL_DEL
+ *   fd   - The file or socket descriptor
+ *   ev   - The requested events (EPOLLIN, ..., EPOLLET, EPOLLONESHOT) and
+ *          the user data.  Ignored for EPOLL_CTL_DEL.
  *
  * Returned Value:
+ *   Zero (OK) on success.  On error, -1 is returned and errno is set
+ *   appropriately:
+ *
+ *   EBADF  - epfd or fd is not a valid descriptor.
+ *   EEXIST - op is EPOLL_CTL_ADD and fd is already in the interest list.
+ *   EINVAL - epfd is not an epoll descriptor or op is not supported.
+ *   ENOENT - op is EPOLL_CTL_MOD or EPOLL_CTL_DEL and fd is not in the
+ *            interest list.
+ *   ENOMEM - Out of memory.
+ *   ENOSYS - The driver of fd does not support the poll method.
  *
  ****************************************************************************/
 
-int epoll_ctl(int epfd, int op, int fd, struct epoll_event *ev)
+int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
 {
-  /* REVISIT: This will not work on machines where:
-   * sizeof(struct epoll_head *) > sizeof(int)
-   */
+  FAR struct epoll_head_s *eph;
+  FAR struct epoll_item_s *item;
+  FAR void *obj;
+  irqstate_t flags;
+  int ret;
+
+  ret = epoll_gethead(epfd, &eph);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  if (fd < 0 || fd >= EPOLL_NFDS)
+    {
+      ret = -EBADF;
+      goto errout;
+    }
+
+  if (op != EPOLL_CTL_DEL && ev == NULL)
+    {
+      ret = -EINVAL;
+      goto errout;
+    }
+
+  ret = epoll_getobj(fd, &obj);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  ret = nxsem_wait(&eph->exclsem);
+  if (ret < 0)
+    {
+      goto errout;
+    }
 
-  FAR struct epoll_head *eph = (FAR struct epoll_head *)((intptr_t)epfd);
+  item = eph->items[fd];
 
   switch (op)
     {
       case EPOLL_CTL_ADD:
-        finfo("%08x CTL ADD(%d): fd=%d ev=%08x\n",
-              epfd, eph->occupied, fd, ev->events);
+        finfo("%d CTL ADD: fd=%d ev=%08x\n", epfd, fd, ev->events);
 
-        eph->evs[eph->occupied].events = ev->events | POLLERR | POLLHUP;
-        eph->evs[eph->occupied++].data.fd = fd;
-        return 0;
+        if (item != NULL)
+          {
+            ret = -EEXIST;
+            break;
+          }
+
+        item = (FAR struct epoll_item_s *)
+          kmm_zalloc(sizeof(struct epoll_item_s));
+        if (item == NULL)
+          {
+            ret = -ENOMEM;
+            break;
+          }
+
+        item->eph        = eph;
+        item->obj        = obj;
+        item->data       = ev->data;
+        item->events     = ev->events;
+        item->pfd.fd     = fd;
+        item->pfd.sem    = &eph->sem;
+        item->pfd.events = (pollevent_t)ev->events | POLLERR | POLLHUP;
+        item->pfd.cb     = epoll_notify;
+        item->pfd.arg    = item;
+
+        ret = epoll_arm(item);
+        if (ret < 0)
+          {
+            flags = enter_critical_section();
+            epoll_dequeue(item);
+            leave_critical_section(flags);
+
+            kmm_free(item);
+            break;
+          }
+
+        epoll_objlink(item);
+        eph->items[fd] = item;
+        break;
+
+      case EPOLL_CTL_MOD:
+        finfo("%d CTL MOD: fd=%d ev=%08x\n", epfd, fd, ev->events);
+
+        if (item == NULL)
+          {
+            ret = -ENOENT;
+            break;
+          }
+
+        flags = enter_critical_section();
+        item->data       = ev->data;
+        item->events     = ev->events;
+        item->pfd.events = (pollevent_t)ev->events | POLLERR | POLLHUP;
+        item->flags     &= ~(EPOLL_DISABLED | EPOLL_RECHECK);
+        leave_critical_section(flags);
+
+        ret = epoll_arm(item);
+        break;
 
       case EPOLL_CTL_DEL:
-        {
-          int i;
+        finfo("%d CTL DEL: fd=%d\n", epfd, fd);
 
-          for (i = 0; i < eph->occupied; i++)
-            {
-              if (eph->evs[i].data.fd == fd)
-                {
-                  if (i != eph->occupied-1)
-                    {
-                      memmove(&eph->evs[i], &eph->evs[i + 1],
-                              eph->occupied - i);
-                    }
-
-                  eph->occupied--;
-                  return 0;
-                }
-            }
+        if (item == NULL)
+          {
+            ret = -ENOENT;
+            break;
+          }
+
+        epoll_remove(item);
+        break;
 
-          return -ENOENT;
+      default:
+        ret = -EINVAL;
+        break;
+    }
+
+  nxsem_post(&eph->exclsem);
+  if (ret >= 0)
+    {
+      return OK;
+    }
+
+errout:
+  set_errno(-ret);
+  return ERROR;
+}
+
+/****************************************************************************
+ * Name: epoll_detach
+ *
+ * Description:
+ *   Remove a file or socket from the interest lists of all epoll instances.
+ *   Called when the file or socket is closed, before its driver is closed,
+ *   so that no driver is left with a pollfd that refers to epoll memory.
+ *   Only the items of the file or socket are visited.
+ *
+ * Input Parameters:
+ *   list - The f_epoll list of the struct file or the s_epoll list of the
+ *          struct socket being closed
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void epoll_detach(FAR struct epoll_item_s **list)
+{
+  FAR struct epoll_head_s *eph;
+  FAR struct epoll_item_s *item;
+  irqstate_t flags;
+
+  /* Nothing to do if the file or socket is in no interest list */
+
+  if (*list == NULL)
+    {
+      return;
+    }
+
+  for (; ; )
+    {
+      /* Take a reference to the epoll instance of the first item so that
+       * it is not freed while we wait for its exclsem.
+       */
+
+      flags = enter_critical_section();
+      item  = *list;
+      if (item == NULL)
+        {
+          leave_critical_section(flags);
+          break;
         }
 
-      case EPOLL_CTL_MOD:
+      eph = item->eph;
+      eph->crefs++;
+      leave_critical_section(flags);
+
+      /* Remove the items of this epoll instance.  They may already have
+       * been removed by epoll_ctl() or by closing the epoll descriptor
+       * while we waited.
+       */
+
+      epoll_semtake(eph);
+
+      for (; ; )
         {
-          int i;
+          flags = enter_critical_section();
+          item  = *list;
+          while (item != NULL && item->eph != eph)
+            {
+              item = item->oflink;
+            }
 
-          finfo("%08x CTL MOD(%d): fd=%d ev=%08x\n",
-                epfd, eph->occupied, fd, ev->events);
+          leave_critical_section(flags);
 
-          for (i = 0; i < eph->occupied; i++)
+          if (item == NULL)
             {
-              if (eph->evs[i].data.fd == fd)
-                {
-                  eph->evs[i].events = ev->events | POLLERR | POLLHUP;
-                  return 0;
-                }
+              break;
             }
 
-          return -ENOENT;
+          finfo("Closed fd=%d removed from epoll\n", item->pfd.fd);
+          epoll_remove(item);
         }
-    }
 
-  return -EINVAL;
+      nxsem_post(&eph->exclsem);
+      epoll_release(eph);
+    }
 }
 
 /****************************************************************************
  * Name: epoll_wait
  *
  * Description:
+ *   Wait for events on the descriptors in the interest list of an epoll
+ *   instance.  Only the descriptors that have been reported ready by their
+ *   drivers are visited; the cost does not depend on the size of the
+ *   interest list.
  *
  * Input Parameters:
+ *   epfd      - The epoll file descriptor
+ *   evs       - The returned events
+ *   maxevents - The maximum number of events to return
+ *   timeout   - The maximum time to wait in milliseconds.  A negative value
+ *               means an infinite timeout; zero returns immediately.
  *
  * Returned Value:
+ *   The number of events returned in evs; zero if the timeout expired.  On
+ *   error, -1 is returned and errno is set appropriately:
+ *
+ *   EBADF  - epfd is not a valid descriptor.
+ *   EINTR  - A signal occurred before any requested event.
+ *   EINVAL - epfd is not an epoll descriptor or maxevents is not positive.
  *
  ****************************************************************************/
 
 int epoll_wait(int epfd, FAR struct epoll_event *evs, int maxevents,
                int timeout)
 {
-  /* REVISIT: This will not work on machines where:
-   * sizeof(struct epoll_head *) > sizeof(int)
-   */
+  FAR struct epoll_head_s *eph;
+  irqstate_t flags;
+  systime_t start;
+  uint32_t ticks = 0;
+  int ret;
 
-  FAR struct epoll_head *eph = (FAR struct epoll_head *)((intptr_t)epfd);
-  int counter;
-  int rc;
-  int i;
+  /* epoll_wait() is a cancellation point */
 
-  rc = poll((FAR struct pollfd *)eph->evs, eph->occupied, timeout);
+  (void)enter_cancellation_point();
 
-  if (rc <= 0)
+  ret = epoll_gethead(epfd, &eph);
+  if (ret < 0)
     {
-      if (rc < 0)
-        {
-          ferr("ERROR: %08x poll fail: %d for %d, %d msecs\n",
-               epfd, rc, eph->occupied, timeout);
+      goto errout;
+    }
 
-          for (i = 0; i < eph->occupied; i++)
-            {
-              ferr("  %02d: fd=%d\n", i, eph->evs[i].data.fd);
-            }
-        }
+  if (evs == NULL || maxevents <= 0)
+    {
+      ret = -EINVAL;
+      goto errout;
+    }
+
+  /* Round the timeout up to the next full tick (see poll()) */
 
-      return rc;
+  if (timeout > 0)
+    {
+#if (MSEC_PER_TICK * USEC_PER_MSEC) != USEC_PER_TICK && \
+    defined(CONFIG_HAVE_LONG_LONG)
+      ticks = (((unsigned long long)timeout * USEC_PER_MSEC) +
+               (USEC_PER_TICK - 1)) / USEC_PER_TICK;
+#else
+      ticks = ((unsigned int)timeout + (MSEC_PER_TICK - 1)) / MSEC_PER_TICK;
+#endif
     }
 
-  /* Iterate over non NULL event fds */
+  start = clock_systimer();
 
-  for (i = 0, counter = 0; i < rc && counter < eph->size; counter++)
+  for (; ; )
     {
-      if (eph->evs[counter].revents != 0)
+      ret = nxsem_wait(&eph->exclsem);
+      if (ret < 0)
+        {
+          goto errout;
+        }
+
+      /* Consume the pending notifications.  If a driver posted the
+       * semaphore directly, the ready list may be incomplete.
+       */
+
+      flags = enter_critical_section();
+      while (nxsem_trywait(&eph->sem) >= 0)
+        {
+          epoll_account(eph);
+        }
+
+      if (eph->scan)
+        {
+          eph->scan = false;
+          leave_critical_section(flags);
+          epoll_scan(eph);
+        }
+      else
+        {
+          leave_critical_section(flags);
+        }
+
+      ret = epoll_harvest(eph, evs, maxevents);
+      nxsem_post(&eph->exclsem);
+
+      if (ret > 0 || timeout == 0)
         {
-          evs[i].data.fd = eph->evs[counter].data.fd;
-          evs[i].events  = eph->evs[counter].revents;
-          i += 1;
+          break;
         }
+
+      /* Wait for the next notification */
+
+      if (timeout > 0)
+        {
+          ret = nxsem_tickwait(&eph->sem, start, ticks);
+        }
+      else
+        {
+          ret = nxsem_wait(&eph->sem);
+        }
+
+      if (ret < 0)
+        {
+          if (ret == -ETIMEDOUT)
+            {
+              ret = 0;
+              break;
+            }
+
+          goto errout;
+        }
+
+      flags = enter_critical_section();
+      epoll_account(eph);
+      leave_critical_section(flags);
     }
 
-  return i;
+  leave_cancellation_point();
+  return ret;
+
+errout:
+  leave_cancellation_point();
+  set_errno(-ret);
+  return ERROR;
 }
 
 #endif /* CONFIG_DISABLE_POLL */
@@ -0,0 +1,294 @@
+/****************************************************************************
+ * fs/vfs/fs_readv.c
+ *
+ *   Copyright (C) 2017-2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/cancelpt.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/net/net.h>
+
+#include "inode/inode.h"
+
+#if CONFIG_NFILE_DESCRIPTORS > 0 || CONFIG_NSOCKET_DESCRIPTORS > 0
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: readv_loop
+ *
+ * Description:
+ *   Read into each buffer in turn.  This is used when the driver, file
+ *   system, or socket does not support vectored reads.  The transfer stops
+ *   at the first short read so that readv() on a pipe, character device,
+ *   or socket does not block once some data has been received.
+ *
+ ****************************************************************************/
+
+static ssize_t readv_loop(int fd, FAR struct file *filep,
+                          FAR const struct iovec *iov, int iovcnt)
+{
+  ssize_t ntotal = 0;
+  ssize_t nread;
+  int i;
+
+  for (i = 0; i < iovcnt; i++)
+    {
+      /* Ignore zero-length reads */
+
+      if (iov[i].iov_len == 0)
+        {
+          continue;
+        }
+
+#if CONFIG_NFILE_DESCRIPTORS > 0
+      if (filep != NULL)
+        {
+          nread = file_read(filep, iov[i].iov_base, iov[i].iov_len);
+        }
+      else
+#endif
+        {
+#if defined(CONFIG_NET) && CONFIG_NSOCKET_DESCRIPTORS > 0
+          nread = nx_recv(fd, iov[i].iov_base, iov[i].iov_len, 0);
+#else
+          nread = -EBADF;
+#endif
+        }
+
+      /* Return an error only if nothing has been read yet */
+
+      if (nread < 0)
+        {
+          return ntotal > 0 ? ntotal : nread;
+        }
+
+      ntotal += nread;
+
+      /* Stop on end-of-file or on a short read */
+
+      if ((size_t)nread < iov[i].iov_len)
+        {
+          break;
+        }
+    }
+
+  return ntotal;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: file_readv
+ *
+ * Description:
+ *   file_readv() is an internal OS interface.  It is functionally similar
+ *   to the standard readv() interface except that it does not modify the
+ *   errno variable, it is not a cancellation point, it does not handle
+ *   socket descriptors, and it accepts a file structure instance instead of
+ *   file descriptor.
+ *
+ * Input Parameters:
+ *   filep  - File structure instance
+ *   iov    - Array of read buffer descriptors
+ *   iovcnt - Number of elements in iov[]
+ *
+ * Returned Value:
+ *   The number of bytes read on success, 0 on an end-of-file condition, or
+ *   a negated errno value on any failure.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NFILE_DESCRIPTORS > 0
+ssize_t file_readv(FAR struct file *filep, FAR const struct iovec *iov,
+                   int iovcnt)
+{
+  FAR struct inode *inode;
+
+  DEBUGASSERT(filep != NULL);
+  inode = filep->f_inode;
+
+  /* Was this file opened for read access? */
+
+  if ((filep->f_oflags & O_RDOK) == 0)
+    {
+      return -EACCES;
+    }
+
+  if (inode == NULL || inode->u.i_ops == NULL)
+    {
+      return -EBADF;
+    }
+
+  /* Use the vectored read method if the driver or file system has one.
+   * The file_operations and mountpt_operations are not common at this
+   * point in the vtable.
+   */
+
+#ifndef CONFIG_DISABLE_MOUNTPOINT
+  if (INODE_IS_MOUNTPT(inode))
+    {
+      if (inode->u.i_mops->readv != NULL)
+        {
+          return inode->u.i_mops->readv(filep, iov, iovcnt);
+        }
+    }
+  else
+#endif
+  if (inode->u.i_ops->readv != NULL)
+    {
+      return inode->u.i_ops->readv(filep, iov, iovcnt);
+    }
+
+  /* Otherwise, read one buffer at a time */
+
+  return readv_loop(-1, filep, iov, iovcnt);
+}
+#endif
+
+/****************************************************************************
+ * Name: nx_readv
+ *
+ * Description:
+ *   nx_readv() is an internal OS interface.  It is functionally similar to
+ *   the standard readv() interface except that it does not modify the errno
+ *   variable and it is not a cancellation point.
+ *
+ * Input Parameters:
+ *   fd     - File or socket descriptor
+ *   iov    - Array of read buffer descriptors
+ *   iovcnt - Number of elements in iov[]
+ *
+ * Returned Value:
+ *   The number of bytes read on success, 0 on an end-of-file condition, or
+ *   a negated errno value on any failure.
+ *
+ ****************************************************************************/
+
+ssize_t nx_readv(int fd, FAR const struct iovec *iov, int iovcnt)
+{
+  if (iov == NULL || iovcnt < 0 || iovcnt > IOV_MAX)
+    {
+      return -EINVAL;
+    }
+
+#if CONFIG_NFILE_DESCRIPTORS > 0
+  if ((unsigned int)fd < CONFIG_NFILE_DESCRIPTORS)
+    {
+      FAR struct file *filep;
+      int ret;
+
+      /* The descriptor is in the range of file descriptors.  Get the file
+       * structure and let file_readv() do all of the work.
+       */
+
+      ret = fs_getfilep(fd, &filep);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      return file_readv(filep, iov, iovcnt);
+    }
+#endif
+
+  /* Otherwise, it must be a socket.  There is no vectored receive so the
+   * buffers are filled one at a time.
+   */
+
+  return readv_loop(fd, NULL, iov, iovcnt);
+}
+
+/****************************************************************************
+ * Name: readv
+ *
+ * Description:
+ *   The readv() function is equivalent to read(), except as described
+ *   below.  The readv() function places the input data into the iovcnt
+ *   buffers specified by the members of the iov array: iov[0], iov[1], ...,
+ *   iov[iovcnt-1].  The iovcnt argument is valid if greater than 0 and less
+ *   than or equal to IOV_MAX as defined in limits.h.
+ *
+ *   If the driver or file system provides a readv method, the entire
+ *   transfer is performed in one call.  Otherwise, each buffer is read in
+ *   turn and the transfer ends at the first short read.
+ *
+ * Input Parameters:
+ *   fd     - The open file or socket descriptor to be read
+ *   iov    - Array of read buffer descriptors
+ *   iovcnt - Number of elements in iov[]
+ *
+ * Returned Value:
+ *   Upon successful completion, readv() will return a non-negative integer
+ *   indicating the number of bytes actually read.  Otherwise, the functions
+ *   will return -1 and set errno to indicate the error.  See read().
+ *
+ ****************************************************************************/
+
+ssize_t readv(int fd, FAR const struct iovec *iov, int iovcnt)
+{
+  ssize_t ret;
+
+  /* readv() is a cancellation point */
+
+  (void)enter_cancellation_point();
+
+  ret = nx_readv(fd, iov, iovcnt);
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      ret = ERROR;
+    }
+
+  leave_cancellation_point();
+  return ret;
+}
+
+#endif /* CONFIG_NFILE_DESCRIPTORS > 0 || CONFIG_NSOCKET_DESCRIPTORS > 0 */
@@ -0,0 +1,262 @@
+/****************************************************************************
+ * fs/vfs/fs_writev.c
+ *
+ *   Copyright (C) 2017-2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/cancelpt.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/net/net.h>
+
+#include "inode/inode.h"
+
+#if CONFIG_NFILE_DESCRIPTORS > 0 || CONFIG_NSOCKET_DESCRIPTORS > 0
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: file_writev
+ *
+ * Description:
+ *   file_writev() is an internal OS interface.  It is functionally similar
+ *   to the standard writev() interface except that it does not modify the
+ *   errno variable, it is not a cancellation point, it does not handle
+ *   socket descriptors, and it accepts a file structure instance instead of
+ *   file descriptor.
+ *
+ * Input Parameters:
+ *   filep  - File structure instance
+ *   iov    - Array of write buffer descriptors
+ *   iovcnt - Number of elements in iov[]
+ *
+ * Returned Value:
+ *   The number of bytes written on success, or a negated errno value on
+ *   any failure.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NFILE_DESCRIPTORS > 0
+ssize_t file_writev(FAR struct file *filep, FAR const struct iovec *iov,
+                    int iovcnt)
+{
+  FAR struct inode *inode;
+  FAR const uint8_t *buffer;
+  size_t remaining;
+  ssize_t ntotal;
+  ssize_t nwritten;
+  int i;
+
+  DEBUGASSERT(filep != NULL);
+  inode = filep->f_inode;
+
+  /* Was this file opened for write access? */
+
+  if ((filep->f_oflags & O_WROK) == 0)
+    {
+      return -EBADF;
+    }
+
+  if (inode == NULL || inode->u.i_ops == NULL)
+    {
+      return -EBADF;
+    }
+
+  /* Use the vectored write method if the driver or file system has one.
+   * The file_operations and mountpt_operations are not common at this
+   * point in the vtable.
+   */
+
+#ifndef CONFIG_DISABLE_MOUNTPOINT
+  if (INODE_IS_MOUNTPT(inode))
+    {
+      if (inode->u.i_mops->writev != NULL)
+        {
+          return inode->u.i_mops->writev(filep, iov, iovcnt);
+        }
+    }
+  else
+#endif
+  if (inode->u.i_ops->writev != NULL)
+    {
+      return inode->u.i_ops->writev(filep, iov, iovcnt);
+    }
+
+  /* Otherwise, write each buffer in turn, writing repeatedly as necessary
+   * to write each entire buffer.
+   */
+
+  for (i = 0, ntotal = 0; i < iovcnt; i++)
+    {
+      buffer    = iov[i].iov_base;
+      remaining = iov[i].iov_len;
+
+      while (remaining > 0)
+        {
+          nwritten = file_write(filep, buffer, remaining);
+          if (nwritten < 0)
+            {
+              /* Return an error only if nothing has been written */
+
+              return ntotal > 0 ? ntotal : nwritten;
+            }
+
+          buffer    += nwritten;
+          remaining -= nwritten;
+          ntotal    += nwritten;
+        }
+    }
+
+  return ntotal;
+}
+#endif
+
+/****************************************************************************
+ * Name: nx_writev
+ *
+ * Description:
+ *   nx_writev() is an internal OS interface.  It is functionally similar to
+ *   the standard writev() interface except that it does not modify the
+ *   errno variable and it is not a cancellation point.
+ *
+ * Input Parameters:
+ *   fd     - File or socket descriptor
+ *   iov    - Array of write buffer descriptors
+ *   iovcnt - Number of elements in iov[]
+ *
+ * Returned Value:
+ *   The number of bytes written on success, or a negated errno value on
+ *   any failure.
+ *
+ ****************************************************************************/
+
+ssize_t nx_writev(int fd, FAR const struct iovec *iov, int iovcnt)
+{
+  if (iov == NULL || iovcnt < 0 || iovcnt > IOV_MAX)
+    {
+      return -EINVAL;
+    }
+
+#if CONFIG_NFILE_DESCRIPTORS > 0
+  if ((unsigned int)fd < CONFIG_NFILE_DESCRIPTORS)
+    {
+      FAR struct file *filep;
+      int ret;
+
+      /* The descriptor is in the range of file descriptors.  Get the file
+       * structure and let file_writev() do all of the work.
+       */
+
+      ret = fs_getfilep(fd, &filep);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      return file_writev(filep, iov, iovcnt);
+    }
+#endif
+
+#if defined(CONFIG_NET) && CONFIG_NSOCKET_DESCRIPTORS > 0
+  /* Writing to a socket descriptor is equivalent to sendv() with
+   * flags == 0.
+   */
+
+  return nx_sendv(fd, iov, iovcnt, 0);
+#else
+  return -EBADF;
+#endif
+}
+
+/****************************************************************************
+ * Name: writev
+ *
+ * Description:
+ *   The writev() function is equivalent to write(), except as described
+ *   below. The writev() function will gather output data from the iovcnt
+ *   buffers specified by the members of the iov array: iov[0], iov[1], ...,
+ *   iov[iovcnt-1]. The iovcnt argument is valid if greater than 0 and less
+ *   than or equal to IOV_MAX, as defined in limits.h.
+ *
+ *   If the driver or file system provides a writev method, or if fd is a
+ *   TCP or UDP socket with write buffering, all of the buffers are handed
+ *   down in one call.  For a socket, this means that the data is gathered
+ *   into a single segment or datagram.  Otherwise, each buffer is written
+ *   in turn.
+ *
+ * Input Parameters:
+ *   fd     - The open file or socket descriptor to be written
+ *   iov    - Array of write buffer descriptors
+ *   iovcnt - Number of elements in iov[]
+ *
+ * Returned Value:
+ *   Upon successful completion, writev() shall return the number of bytes
+ *   actually written. Otherwise, it shall return a value of -1 and errno
+ *   shall be set to indicate an error.
+ *
+ ****************************************************************************/
+
+ssize_t writev(int fd, FAR const struct iovec *iov, int iovcnt)
+{
+  ssize_t ret;
+
+  /* writev() is a cancellation point */
+
+  (void)enter_cancellation_point();
+
+  ret = nx_writev(fd, iov, iovcnt);
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      ret = ERROR;
+    }
+
+  leave_cancellation_point();
+  return ret;
+}
+
+#endif /* CONFIG_NFILE_DESCRIPTORS > 0 || CONFIG_NSOCKET_DESCRIPTORS > 0 */
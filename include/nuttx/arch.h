@@ -1734,6 +1734,56 @@ int16_t up_fetchsub16(FAR volatile int16_t *addr, int16_t value);
 int8_t up_fetchsub8(FAR volatile int8_t *addr, int8_t value);
 #endif
 
+/****************************************************************************
+ * Name: up_chksum
+ *
+ * Description:
+ *   Calculate the 16-bit one's complement sum of a buffer, as does the
+ *   generic chksum() function in net/utils.  This allows the architecture
+ *   to provide an assembly language or SIMD implementation of the inner
+ *   loop of all Internet checksum calculations.
+ *
+ *   This function must be provided via the architecture-specific logic if
+ *   CONFIG_ARCH_HAVE_CHKSUM is selected.
+ *
+ * Input Parameters:
+ *   sum  - Partial sum carried over from a previous call (host order)
+ *   data - Beginning of the data to include in the sum.  There are no
+ *          alignment requirements.
+ *   len  - Length of the data in bytes.
+ *
+ * Returned Value:
+ *   The updated sum in host byte order.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_HAVE_CHKSUM
+uint16_t up_chksum(uint16_t sum, FAR const uint8_t *data, uint16_t len);
+#endif
+
+/****************************************************************************
+ * Name: up_perf_gettime and up_perf_getfreq
+ *
+ * Description:
+ *   up_perf_gettime() returns the current value of a free-running counter,
+ *   typically a CPU cycle counter, that is used to time stamp performance
+ *   instrumentation.  The counter wraps around at 2**32.  up_perf_getfreq()
+ *   returns the frequency of that counter in Hz.
+ *
+ *   These functions must be provided via the architecture-specific logic if
+ *   CONFIG_ARCH_HAVE_PERF_EVENTS is selected.  Otherwise, the system timer
+ *   is used.  That requires including <nuttx/clock.h>.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_HAVE_PERF_EVENTS
+uint32_t up_perf_gettime(void);
+uint32_t up_perf_getfreq(void);
+#else
+#  define up_perf_gettime() ((uint32_t)clock_systimer())
+#  define up_perf_getfreq() ((uint32_t)CLK_TCK)
+#endif
+
 /****************************************************************************
  * Name: up_cpu_index
  *
@@ -195,7 +195,9 @@
 
 struct file;   /* Forward reference */
 struct pollfd; /* Forward reference */
+struct iovec;  /* Forward reference */
 struct inode;  /* Forward reference */
+struct epoll_item_s; /* Forward reference */
 
 struct file_operations
 {
@@ -222,6 +224,15 @@ struct file_operations
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
   int     (*unlink)(FAR struct inode *inode);
 #endif
+
+  /* Optional vectored I/O.  If these are not provided, readv() and
+   * writev() fall back to calling read() or write() once per buffer.
+   */
+
+  ssize_t (*readv)(FAR struct file *filep, FAR const struct iovec *iov,
+            int iovcnt);
+  ssize_t (*writev)(FAR struct file *filep, FAR const struct iovec *iov,
+            int iovcnt);
 };
 
 /* This structure provides information about the state of a block driver */
@@ -333,6 +344,13 @@ struct mountpt_operations
   int     (*stat)(FAR struct inode *mountpt, FAR const char *relpath,
             FAR struct stat *buf);
 
+  /* Optional vectored I/O on open files (see struct file_operations) */
+
+  ssize_t (*readv)(FAR struct file *filep, FAR const struct iovec *iov,
+            int iovcnt);
+  ssize_t (*writev)(FAR struct file *filep, FAR const struct iovec *iov,
+            int iovcnt);
+
   /* NOTE:  More operations will be needed here to support:  disk usage
    * stats file stat(), file attributes, file truncation, etc.
    */
@@ -400,6 +418,9 @@ struct file
   off_t             f_pos;      /* File position */
   FAR struct inode *f_inode;    /* Driver or file system interface */
   void             *f_priv;     /* Per file driver private data */
+#ifndef CONFIG_DISABLE_POLL
+  FAR struct epoll_item_s *f_epoll; /* epoll interest list entries */
+#endif
 };
 
 /* This defines a list of files indexed by the file descriptor */
@@ -968,6 +989,47 @@ ssize_t file_write(FAR struct file *filep, FAR const void *buf, size_t nbytes);
 
 ssize_t nx_write(int fd, FAR const void *buf, size_t nbytes);
 
+/****************************************************************************
+ * Name: file_readv and file_writev
+ *
+ * Description:
+ *   Equivalent to the standard readv() and writev() functions except that
+ *   they accept a struct file instance instead of a file descriptor and
+ *   they do not set the errno variable.  If the driver or file system does
+ *   not provide the vectored method, the buffers are transferred one at a
+ *   time with the read or write method.
+ *
+ * Returned Value:
+ *   The number of bytes transferred on success; a negated errno value on
+ *   failure.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NFILE_DESCRIPTORS > 0
+ssize_t file_readv(FAR struct file *filep, FAR const struct iovec *iov,
+                   int iovcnt);
+ssize_t file_writev(FAR struct file *filep, FAR const struct iovec *iov,
+                    int iovcnt);
+#endif
+
+/****************************************************************************
+ * Name: nx_readv and nx_writev
+ *
+ * Description:
+ *   nx_readv() and nx_writev() are internal OS interfaces equivalent to
+ *   readv() and writev() except that they do not modify the errno variable
+ *   and they are not cancellation points.  Both file and socket descriptors
+ *   are supported.
+ *
+ * Returned Value:
+ *   The number of bytes transferred on success; a negated errno value on
+ *   failure.
+ *
+ ****************************************************************************/
+
+ssize_t nx_readv(int fd, FAR const struct iovec *iov, int iovcnt);
+ssize_t nx_writev(int fd, FAR const struct iovec *iov, int iovcnt);
+
 /****************************************************************************
  * Name: file_pread
  *
@@ -1130,6 +1192,55 @@ int file_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup);
 int fdesc_poll(int fd, FAR struct pollfd *fds, bool setup);
 #endif
 
+/****************************************************************************
+ * Name: poll_notify
+ *
+ * Description:
+ *   Notify the waiter on a poll descriptor that fds->revents has been
+ *   updated.  Drivers call this instead of posting fds->sem directly.  The
+ *   semaphore is posted unless the waiter provided a notification callback
+ *   (as epoll does), in which case the callback is called instead.
+ *
+ * Input Parameters:
+ *   fds - The poll descriptor with the updated revents
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   May be called from interrupt handlers.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_POLL
+void poll_notify(FAR struct pollfd *fds);
+#endif
+
+/****************************************************************************
+ * Name: epoll_detach
+ *
+ * Description:
+ *   Remove a file or socket from the interest lists of all epoll instances.
+ *   The file and socket close paths call this before the driver is closed.
+ *
+ *   Only the epoll registrations of the file or socket are visited;
+ *   closing one that is in no interest list costs a single test.
+ *
+ * Input Parameters:
+ *   list - The f_epoll list of the struct file or the s_epoll list of the
+ *          struct socket being closed
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#if CONFIG_NFILE_DESCRIPTORS > 0 && !defined(CONFIG_DISABLE_POLL)
+void epoll_detach(FAR struct epoll_item_s **list);
+#else
+#  define epoll_detach(l)
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
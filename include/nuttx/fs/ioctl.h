@@ -248,6 +248,12 @@
                                            *      to return geometry.
                                            * OUT: Data return in user-provided
                                            *      buffer. */
+#define BIOC_FLUSH      _BIOC(0x000d)     /* Used only by BCH to write any
+                                           * modified sectors in its sector
+                                           * cache to the contained block
+                                           * driver.
+                                           * IN:  None
+                                           * OUT: None */
 
 /* NuttX MTD driver ioctl definitions ***************************************/
 
@@ -0,0 +1,197 @@
+/****************************************************************************
+ * include/nuttx/lockprof.h
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_LOCKPROF_H
+#define __INCLUDE_NUTTX_LOCKPROF_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+
+#ifdef CONFIG_SCHED_LOCKPROF
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Lock types */
+
+#define LOCKPROF_CSECTION   0  /* The SMP critical section */
+#define LOCKPROF_SPINLOCK   1  /* spin_lock() */
+#define LOCKPROF_SEMAPHORE  2  /* nxsem_wait() */
+#define LOCKPROF_MUTEX      3  /* pthread_mutex_lock() */
+
+/* The address of the code that called the function using this macro.  That
+ * is the "caller" that the statistics of a lock are kept for.
+ */
+
+#ifdef __GNUC__
+#  define LOCKPROF_CALLER() __builtin_return_address(0)
+#else
+#  define LOCKPROF_CALLER() NULL
+#endif
+
+/* Sample the time at which the wait for a lock begins */
+
+#define sched_lockprof_start() up_perf_gettime()
+
+/* Provide a caller and lock type for the next nxsem_wait() of the thread
+ * 'tcb'.  This is used by sem_wait() and pthread_mutex_lock() so that the
+ * statistics are kept for their callers rather than for the caller of
+ * nxsem_wait().
+ */
+
+#define sched_lockprof_hint(tcb,c,t) \
+  ((tcb)->lockprof_caller = (c), (tcb)->lockprof_type = (t))
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* This structure holds the statistics of one lock as taken by one caller.
+ * Times are in units of up_perf_gettime().  Hold times are kept only for
+ * semaphores and mutexes;  the hold times of the critical section and of
+ * spinlocks are measured by the spin_holdtime_begin() and
+ * spin_holdtime_end() hooks of the lock (CONFIG_SPINLOCK_HOLDTIME).
+ */
+
+struct lockprof_s
+{
+  FAR const void *lp_lock;      /* Address of the lock (NULL: unused) */
+  FAR void *lp_caller;          /* Address of the code that took the lock */
+  uint8_t  lp_type;             /* See LOCKPROF_* definitions */
+  uint32_t lp_count;            /* Number of acquisitions */
+  uint32_t lp_contended;        /* Number of acquisitions that had to wait */
+  uint32_t lp_maxwait;          /* Longest wait */
+  uint32_t lp_maxhold;          /* Longest hold */
+  uint64_t lp_totalwait;        /* Accumulated wait of contended acquisitions */
+  uint64_t lp_totalhold;        /* Accumulated hold time */
+  uint32_t lp_nholds;           /* Number of hold times measured */
+  uint32_t lp_evicted;          /* Number of holds dropped for lack of slots */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: sched_lockprof_acquired
+ *
+ * Description:
+ *   Account for the acquisition of a lock by the current thread.  If the
+ *   lock is a semaphore or a mutex, start measuring how long it is held.
+ *
+ * Input Parameters:
+ *   lock      - The address of the lock
+ *   caller    - The address of the code that took the lock
+ *   type      - The type of the lock (LOCKPROF_*)
+ *   start     - The value of sched_lockprof_start() when the wait began
+ *   contended - True if the lock was not available immediately
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void sched_lockprof_acquired(FAR const void *lock, FAR void *caller,
+                             uint8_t type, uint32_t start, bool contended);
+
+/****************************************************************************
+ * Name: sched_lockprof_released
+ *
+ * Description:
+ *   Account for the release of a lock by the current thread.  Nothing is
+ *   done if the current thread was not seen taking the lock, as is the case
+ *   of semaphores used for signaling.
+ *
+ * Input Parameters:
+ *   lock - The address of the lock
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void sched_lockprof_released(FAR const void *lock);
+
+/****************************************************************************
+ * Name: sched_lockprof_get
+ *
+ * Description:
+ *   Return a copy of one entry of the lock profile.
+ *
+ * Input Parameters:
+ *   index - The index of the entry, 0 .. CONFIG_SCHED_LOCKPROF_NENTRIES - 1
+ *   entry - The location to return the entry.  entry->lp_lock is NULL if
+ *           the entry is not in use.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; -ENOENT is returned if 'index' is
+ *   beyond the end of the profile.
+ *
+ ****************************************************************************/
+
+int sched_lockprof_get(int index, FAR struct lockprof_s *entry);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#else /* CONFIG_SCHED_LOCKPROF */
+
+#  define sched_lockprof_start()              0
+#  define sched_lockprof_hint(tcb,c,t)
+#  define sched_lockprof_acquired(l,c,t,s,w)
+#  define sched_lockprof_released(l)
+
+#endif /* CONFIG_SCHED_LOCKPROF */
+#endif /* __INCLUDE_NUTTX_LOCKPROF_H */
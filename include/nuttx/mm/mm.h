@@ -46,6 +46,10 @@
 #include <stdbool.h>
 #include <semaphore.h>
 
+#if defined(CONFIG_MM_CACHE) && defined(CONFIG_SMP)
+#  include <nuttx/spinlock.h>
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -155,6 +159,21 @@
 #  define MM_MAX_SHIFT   22  /*  4 Mb */
 #endif
 
+/* The heap profile (CONFIG_MM_HEAPINFO) adds the ID of the allocating task
+ * and the address of the caller to each chunk header.  The chunk header is
+ * then 12, 16 or 24 bytes and sizeof(struct mm_freenode_s) is 20, 24, or 40
+ * bytes.  A larger minimum chunk size is needed.
+ */
+
+#ifdef CONFIG_MM_HEAPINFO
+#  undef MM_MIN_SHIFT
+#  if UINTPTR_MAX <= UINT32_MAX
+#    define MM_MIN_SHIFT  5  /* 32 bytes */
+#  else
+#    define MM_MIN_SHIFT  6  /* 64 bytes */
+#  endif
+#endif
+
 /* All other definitions derive from these two */
 
 #define MM_MIN_CHUNK     (1 << MM_MIN_SHIFT)
@@ -177,6 +196,55 @@
 #define MM_IS_ALLOCATED(n) \
   ((int)((struct mm_allocnode_s*)(n)->preceding) < 0))
 
+/* TLSF free list definitions ***********************************************/
+/* If CONFIG_MM_TLSF is selected, then free chunks are not kept in the
+ * size-ordered mm_nodelist[] but are indexed with a two-level segregated
+ * fit (TLSF) scheme:  The first level index (FL) is the power of two of
+ * the chunk size (in units of MM_MIN_CHUNK);  each first level range is
+ * split linearly into MM_TLSF_SLCOUNT second level (SL) lists.  A bitmap of
+ * non-empty lists at each level permits a suitable list to be found with a
+ * find-first-set operation in constant time.
+ *
+ * Chunks of MM_MAX_CHUNK bytes or more all go into the last list.
+ */
+
+#ifdef CONFIG_MM_TLSF
+#  ifndef CONFIG_MM_TLSF_SLI
+#    define CONFIG_MM_TLSF_SLI 3
+#  endif
+
+#  define MM_TLSF_SLCOUNT   (1 << CONFIG_MM_TLSF_SLI)
+#  define MM_TLSF_FLCOUNT   (MM_MAX_SHIFT - MM_MIN_SHIFT - CONFIG_MM_TLSF_SLI + 1)
+#endif
+
+/* Small-object cache definitions *******************************************/
+/* If CONFIG_MM_CACHE is selected, then freed chunks whose size does not
+ * exceed CONFIG_MM_CACHE_MAXSIZE are not returned to the free node list
+ * but are retained in a small per-CPU cache.  There is one cache list for
+ * each chunk size (in units of MM_MIN_CHUNK) and each list holds at most
+ * CONFIG_MM_CACHE_DEPTH chunks.
+ */
+
+#ifdef CONFIG_MM_CACHE
+#  ifndef CONFIG_MM_CACHE_MAXSIZE
+#    define CONFIG_MM_CACHE_MAXSIZE 512
+#  endif
+
+#  ifndef CONFIG_MM_CACHE_DEPTH
+#    define CONFIG_MM_CACHE_DEPTH 8
+#  endif
+
+#  ifdef CONFIG_SMP
+#    define MM_CACHE_NCPUS  CONFIG_SMP_NCPUS
+#  else
+#    define MM_CACHE_NCPUS  1
+#  endif
+
+#  define MM_CACHE_NCLASSES  (CONFIG_MM_CACHE_MAXSIZE >> MM_MIN_SHIFT)
+#  define MM_CACHE_MAXCHUNK  (MM_CACHE_NCLASSES << MM_MIN_SHIFT)
+#  define MM_CACHE_NDX(s)    (((s) >> MM_MIN_SHIFT) - 1)
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -200,14 +268,24 @@ struct mm_allocnode_s
 {
   mmsize_t size;           /* Size of this chunk */
   mmsize_t preceding;      /* Size of the preceding chunk */
+#ifdef CONFIG_MM_HEAPINFO
+  FAR void *caller;        /* Address of the caller that allocated the chunk */
+  uintptr_t pid;           /* ID of the task that allocated the chunk */
+#endif
 };
 
 /* What is the size of the allocnode? */
 
 #ifdef CONFIG_MM_SMALL
-# define SIZEOF_MM_ALLOCNODE   4
+# define MM_SIZEOF_SIZES       4
+#else
+# define MM_SIZEOF_SIZES       8
+#endif
+
+#ifdef CONFIG_MM_HEAPINFO
+# define SIZEOF_MM_ALLOCNODE   (MM_SIZEOF_SIZES + 2 * sizeof(uintptr_t))
 #else
-# define SIZEOF_MM_ALLOCNODE   8
+# define SIZEOF_MM_ALLOCNODE   MM_SIZEOF_SIZES
 #endif
 
 #define CHECK_ALLOCNODE_SIZE \
@@ -219,6 +297,10 @@ struct mm_freenode_s
 {
   mmsize_t size;                   /* Size of this chunk */
   mmsize_t preceding;              /* Size of the preceding chunk */
+#ifdef CONFIG_MM_HEAPINFO
+  FAR void *caller;                /* Not used in a free chunk */
+  uintptr_t pid;                   /* Not used in a free chunk */
+#endif
   FAR struct mm_freenode_s *flink; /* Supports a doubly linked list */
   FAR struct mm_freenode_s *blink;
 };
@@ -231,6 +313,82 @@ struct mm_freenode_s
 #define CHECK_FREENODE_SIZE \
   DEBUGASSERT(sizeof(struct mm_freenode_s) == SIZEOF_MM_FREENODE)
 
+#ifdef CONFIG_MM_CACHE
+/* This describes a cached chunk.  The chunk retains its allocated chunk
+ * header;  the cache list link is kept in the user data area.
+ */
+
+struct mm_cachenode_s
+{
+  struct mm_allocnode_s hdr;        /* Allocated chunk header */
+  FAR struct mm_cachenode_s *flink; /* Supports a singly linked list */
+};
+
+/* This describes the small-object cache of one CPU */
+
+struct mm_cache_s
+{
+#ifdef CONFIG_SMP
+  volatile spinlock_t mc_lock;      /* Needed only for remote access */
+#endif
+  size_t mc_bytes;                  /* Total size of all cached chunks */
+  FAR struct mm_cachenode_s *mc_list[MM_CACHE_NCLASSES];
+  uint8_t mc_count[MM_CACHE_NCLASSES];
+};
+#endif
+
+#ifdef CONFIG_MM_HEAPINFO
+/* This is the heap profile.  Chunks are counted in size classes, one per
+ * power of two starting with MM_MIN_CHUNK (the same classes as the node
+ * lists).  Sizes are the full chunk sizes, including the chunk header.
+ */
+
+struct mm_heapinfo_s
+{
+  size_t   hi_curused;             /* Total size of the allocated chunks */
+  size_t   hi_maxused;             /* High-water mark of hi_curused */
+  uint32_t hi_nalloc[MM_NNODES];   /* Number of allocations */
+  uint32_t hi_nfree[MM_NNODES];    /* Number of frees */
+  uint32_t hi_maxlive[MM_NNODES];  /* High-water mark of allocated chunks */
+};
+
+/* This is the type of the function that mm_heapinfo_walk() calls for each
+ * allocated chunk.  A non-zero return value stops the traversal.
+ */
+
+typedef CODE int (*mm_walker_t)(FAR struct mm_allocnode_s *node,
+                                 FAR void *arg);
+
+/* Get the address of the caller of the current function (or NULL if the
+ * toolchain cannot provide that information).
+ */
+
+#  ifdef __GNUC__
+#    define MM_RETURN_ADDRESS()  __builtin_return_address(0)
+#  else
+#    define MM_RETURN_ADDRESS()  NULL
+#  endif
+
+/* Attribute a chunk to the caller of the current function.  This is used
+ * by the public wrappers (malloc(), realloc(), etc.) so that the recorded
+ * caller is the application and not the wrapper itself.
+ */
+
+#  define MM_SETCALLER(mem) \
+     do \
+       { \
+         if ((mem) != NULL) \
+           { \
+             ((FAR struct mm_allocnode_s *) \
+              ((FAR char *)(mem) - SIZEOF_MM_ALLOCNODE))->caller = \
+                MM_RETURN_ADDRESS(); \
+           } \
+       } \
+     while (0)
+#else
+#  define MM_SETCALLER(mem)
+#endif
+
 /* This describes one heap (possibly with multiple regions) */
 
 struct mm_heap_s
@@ -256,12 +414,36 @@ struct mm_heap_s
   int mm_nregions;
 #endif
 
+#ifdef CONFIG_MM_TLSF
+  /* All free nodes are maintained in doubly linked, segregated free lists
+   * with bitmaps that indicate which of the lists are non-empty.
+   */
+
+  uint32_t mm_flbitmap;
+  uint32_t mm_slbitmap[MM_TLSF_FLCOUNT];
+  FAR struct mm_freenode_s *mm_freelist[MM_TLSF_FLCOUNT][MM_TLSF_SLCOUNT];
+#else
   /* All free nodes are maintained in a doubly linked list.  This
    * array provides some hooks into the list at various points to
    * speed searches for free nodes.
    */
 
   struct mm_freenode_s mm_nodelist[MM_NNODES];
+#endif
+
+#ifdef CONFIG_MM_CACHE
+  /* Per-CPU caches of recently freed small chunks.  These may be accessed
+   * without holding the heap semaphore.
+   */
+
+  struct mm_cache_s mm_cache[MM_CACHE_NCPUS];
+#endif
+
+#ifdef CONFIG_MM_HEAPINFO
+  /* The heap profile.  Protected by the heap semaphore. */
+
+  struct mm_heapinfo_s mm_info;
+#endif
 };
 
 /****************************************************************************
@@ -377,6 +559,7 @@ FAR void *kmm_malloc(size_t size);
 /* Functions contained in mm_free.c *****************************************/
 
 void mm_free(FAR struct mm_heap_s *heap, FAR void *mem);
+void mm_freechunk(FAR struct mm_heap_s *heap, FAR void *mem);
 
 /* Functions contained in kmm_free.c ****************************************/
 
@@ -500,14 +683,42 @@ int kmm_mallinfo(struct mallinfo *info);
 void mm_shrinkchunk(FAR struct mm_heap_s *heap,
                     FAR struct mm_allocnode_s *node, size_t size);
 
-/* Functions contained in mm_addfreechunk.c *********************************/
+/* Functions contained in mm_addfreechunk.c or mm_tlsf.c *******************/
 
 void mm_addfreechunk(FAR struct mm_heap_s *heap,
                      FAR struct mm_freenode_s *node);
+void mm_delfreechunk(FAR struct mm_heap_s *heap,
+                     FAR struct mm_freenode_s *node);
+FAR struct mm_freenode_s *mm_findfreechunk(FAR struct mm_heap_s *heap,
+                                           size_t size);
 
 /* Functions contained in mm_size2ndx.c.c ***********************************/
 
+#ifndef CONFIG_MM_TLSF
 int mm_size2ndx(size_t size);
+#endif
+
+/* Functions contained in mm_heapinfo.c *************************************/
+
+#ifdef CONFIG_MM_HEAPINFO
+void mm_heapinfo_alloc(FAR struct mm_heap_s *heap,
+                       FAR struct mm_allocnode_s *node, FAR void *caller);
+void mm_heapinfo_free(FAR struct mm_heap_s *heap,
+                      FAR struct mm_allocnode_s *node);
+void mm_heapinfo(FAR struct mm_heap_s *heap, FAR struct mm_heapinfo_s *info);
+int  mm_heapinfo_walk(FAR struct mm_heap_s *heap, mm_walker_t handler,
+                      FAR void *arg);
+#endif
+
+/* Functions contained in mm_cache.c ****************************************/
+
+#ifdef CONFIG_MM_CACHE
+void mm_cache_initialize(FAR struct mm_heap_s *heap);
+FAR void *mm_cache_alloc(FAR struct mm_heap_s *heap, size_t chunksize);
+bool mm_cache_free(FAR struct mm_heap_s *heap, FAR void *mem);
+size_t mm_cache_flush(FAR struct mm_heap_s *heap);
+size_t mm_cache_bytes(FAR struct mm_heap_s *heap);
+#endif
 
 #undef EXTERN
 #ifdef __cplusplus
@@ -144,6 +144,9 @@ typedef uint8_t sockcaps_t;
 
 struct socket;  /* Forward reference */
 struct pollfd;  /* Forward reference */
+struct iovec;   /* Forward reference */
+struct file;    /* Forward reference */
+struct epoll_item_s; /* Forward reference */
 
 struct sock_intf_s
 {
@@ -177,6 +180,13 @@ struct sock_intf_s
                     size_t len, int flags, FAR struct sockaddr *from,
                     FAR socklen_t *fromlen);
   CODE int        (*si_close)(FAR struct socket *psock);
+
+  /* Optional gathered send.  May return -ENOSYS if the socket type
+   * cannot gather; the buffers are then sent one at a time.
+   */
+
+  CODE ssize_t    (*si_sendv)(FAR struct socket *psock,
+                    FAR const struct iovec *iov, int iovcnt, int flags);
 };
 
 /* This is the internal representation of a socket reference by a file
@@ -209,6 +219,12 @@ struct socket
 
   FAR const struct sock_intf_s *s_sockif;
 
+#ifndef CONFIG_DISABLE_POLL
+  /* epoll interest list entries of this socket */
+
+  FAR struct epoll_item_s *s_epoll;
+#endif
+
 #if defined(CONFIG_NET_TCP_WRITE_BUFFERS) || defined(CONFIG_NET_UDP_WRITE_BUFFERS)
   /* Callback instance for TCP send() or UDP sendto() */
 
@@ -790,6 +806,38 @@ ssize_t psock_send(FAR struct socket *psock, const void *buf, size_t len,
 
 ssize_t nx_send(int sockfd, FAR const void *buf, size_t len, int flags);
 
+/****************************************************************************
+ * Name: psock_sendv and nx_sendv
+ *
+ * Description:
+ *   Send the data gathered from the iovcnt buffers described by iov on a
+ *   connected socket.  If the address family supports it, all of the data
+ *   is queued in one operation so that, for example, a protocol header and
+ *   its payload are sent as a single TCP segment or UDP datagram.
+ *   Otherwise, each buffer is sent in turn with psock_send().
+ *
+ *   These are internal OS interfaces used to implement writev() on socket
+ *   descriptors.  They are not cancellation points and they do not modify
+ *   the errno variable.
+ *
+ * Input Parameters:
+ *   psock  - An instance of the internal socket structure.
+ *   sockfd - Socket descriptor of the socket
+ *   iov    - Array of buffer descriptors
+ *   iovcnt - Number of elements in iov[]
+ *   flags  - Send flags
+ *
+ * Returned Value:
+ *   On success, returns the number of characters sent.  On any failure, a
+ *   negated errno value is returned.
+ *
+ ****************************************************************************/
+
+ssize_t psock_sendv(FAR struct socket *psock, FAR const struct iovec *iov,
+                    int iovcnt, int flags);
+ssize_t nx_sendv(int sockfd, FAR const struct iovec *iov, int iovcnt,
+                 int flags);
+
 /****************************************************************************
  * Name: psock_sendto
  *
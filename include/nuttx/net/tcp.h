@@ -180,6 +180,9 @@ struct tcp_stats_s
   net_stats_t syndrop;    /* Number of dropped SYNs due to too few
                              available connections */
   net_stats_t synrst;     /* Number of SYNs for closed ports triggering a RST */
+  net_stats_t lookup;     /* Number of connection lookups for received
+                             segments */
+  net_stats_t probe;      /* Number of connections compared in lookups */
 };
 #endif
 
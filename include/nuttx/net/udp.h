@@ -97,6 +97,9 @@ struct udp_stats_s
   net_stats_t recv;         /* Number of recived UDP segments */
   net_stats_t sent;         /* Number of sent UDP segments */
   net_stats_t chkerr;       /* Number of UDP segments with a bad checksum */
+  net_stats_t lookup;       /* Number of connection lookups for received
+                               datagrams */
+  net_stats_t probe;        /* Number of connections compared in lookups */
 };
 #endif
 
@@ -651,6 +651,11 @@ struct tcb_s
 
   sem_t *waitsem;                        /* Semaphore ID waiting on             */
 
+#ifdef CONFIG_SCHED_LOCKPROF
+  FAR void *lockprof_caller;             /* Caller of sem_wait() and friends    */
+  uint8_t lockprof_type;                 /* Lock type to report for that caller */
+#endif
+
   /* POSIX Signal Control Fields ************************************************/
 
 #ifndef CONFIG_DISABLE_SIGNALS
@@ -760,6 +765,17 @@ struct pthread_tcb_s
 
 typedef void (*sched_foreach_t)(FAR struct tcb_s *tcb, FAR void *arg);
 
+#ifdef CONFIG_SMP_STATS
+/* Per-CPU scheduling statistics returned by nxsched_smpstats() */
+
+struct smp_stats_s
+{
+  uint32_t ss_affine;      /* Tasks started on the CPU they last ran on */
+  uint32_t ss_migrations;  /* Tasks started on a different CPU */
+  uint32_t ss_steals;      /* Tasks taken from g_readytorun by an idle CPU */
+};
+#endif
+
 #endif /* __ASSEMBLY__ */
 
 /********************************************************************************
@@ -1117,6 +1133,28 @@ int nxsched_setaffinity(pid_t pid, size_t cpusetsize,
                         FAR const cpu_set_t *mask);
 #endif
 
+/****************************************************************************
+ * Name: nxsched_smpstats
+ *
+ * Description:
+ *   Return a snapshot of the scheduling statistics of one CPU:  How often
+ *   tasks were started on the same CPU that they last ran on, how often
+ *   they migrated to another CPU, and how often a CPU that would otherwise
+ *   have run its IDLE task took a task from the shared ready-to-run list.
+ *
+ * Input Parameters:
+ *   cpu   - The index of the CPU of interest
+ *   stats - The location to return the statistics
+ *
+ * Returned Value:
+ *   Zero (OK) if successful.  -EINVAL if the CPU index is not valid.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP_STATS
+int nxsched_smpstats(int cpu, FAR struct smp_stats_s *stats);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -328,6 +328,30 @@ void sched_note_spinabort(FAR struct tcb_s *tcb, FAR volatile void *spinlock);
 ssize_t sched_note_get(FAR uint8_t *buffer, size_t buflen);
 #endif
 
+/****************************************************************************
+ * Name: sched_note_read
+ *
+ * Description:
+ *   Remove as many notes as will fit from the tail of the circular
+ *   buffer(s), copying them back-to-back into the user buffer.  Each note
+ *   begins with its length so the result is a self-describing stream.
+ *
+ * Input Parameters:
+ *   buffer - Location to return the notes
+ *   buflen - The length of the user provided buffer.
+ *
+ * Returned Value:
+ *   On success, the total length of the returned notes is provided.  Zero
+ *   is returned only if the circular buffer is empty.  A negated errno
+ *   value is returned if not even the first note will fit.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_SCHED_INSTRUMENTATION_BUFFER) && \
+    defined(CONFIG_SCHED_NOTE_GET)
+ssize_t sched_note_read(FAR uint8_t *buffer, size_t buflen);
+#endif
+
 /****************************************************************************
  * Name: sched_note_size
  *
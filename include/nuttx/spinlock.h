@@ -44,6 +44,7 @@
 
 #include <sys/types.h>
 #include <stdint.h>
+#include <stdbool.h>
 
 #ifdef CONFIG_SPINLOCK
 
@@ -100,6 +101,28 @@
  * Public Types
  ****************************************************************************/
 
+#ifdef CONFIG_SPINLOCK_HOLDTIME
+/* This structure holds the hold time statistics of one instrumented lock.
+ * Instances are linked into a global list by spin_holdtime_register().
+ */
+
+struct spinlock_holdtime_s
+{
+  FAR const char *ht_name;                /* Name shown in /proc/locks */
+  FAR struct spinlock_holdtime_s *ht_flink; /* Next registered lock */
+  uint32_t ht_start;                      /* Time when the lock was taken */
+  bool     ht_held;                       /* True: ht_start is valid */
+  uint32_t ht_count;                      /* Number of acquisitions */
+  uint32_t ht_max;                        /* Longest hold time */
+  uint64_t ht_total;                      /* Accumulated hold time */
+};
+
+/* Used by spin_holdtime_foreach() */
+
+typedef CODE void (*spin_holdtime_handler_t)
+  (FAR struct spinlock_holdtime_s *ht, FAR void *arg);
+#endif
+
 struct spinlock_s
 {
   volatile spinlock_t sp_lock;  /* Indicates if the spinlock is locked or
@@ -409,5 +432,73 @@ void spin_clrbit(FAR volatile cpu_set_t *set, unsigned int cpu,
                  FAR volatile spinlock_t *setlock,
                  FAR volatile spinlock_t *orlock);
 
+/****************************************************************************
+ * Name: spin_holdtime_register
+ *
+ * Description:
+ *   Add a hold time statistics structure to the list of instrumented locks
+ *   reported by /proc/locks.  The structure must persist for the life of
+ *   the system.
+ *
+ * Input Parameters:
+ *   ht   - The hold time statistics structure to register
+ *   name - The name of the lock
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPINLOCK_HOLDTIME
+void spin_holdtime_register(FAR struct spinlock_holdtime_s *ht,
+                            FAR const char *name);
+#else
+#  define spin_holdtime_register(h,n)
+#endif
+
+/****************************************************************************
+ * Name: spin_holdtime_begin and spin_holdtime_end
+ *
+ * Description:
+ *   Mark the beginning and the end of a period in which the lock described
+ *   by 'ht' is held.  These must be called while the lock is held, i.e.,
+ *   spin_holdtime_begin() just after the lock is taken and
+ *   spin_holdtime_end() just before it is released.
+ *
+ * Input Parameters:
+ *   ht - The hold time statistics structure of the lock
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPINLOCK_HOLDTIME
+void spin_holdtime_begin(FAR struct spinlock_holdtime_s *ht);
+void spin_holdtime_end(FAR struct spinlock_holdtime_s *ht);
+#else
+#  define spin_holdtime_begin(h)
+#  define spin_holdtime_end(h)
+#endif
+
+/****************************************************************************
+ * Name: spin_holdtime_foreach
+ *
+ * Description:
+ *   Call the provided handler once for each registered lock.
+ *
+ * Input Parameters:
+ *   handler - The function to call for each lock
+ *   arg     - An opaque argument passed to the handler
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPINLOCK_HOLDTIME
+void spin_holdtime_foreach(spin_holdtime_handler_t handler, FAR void *arg);
+#endif
+
 #endif /* CONFIG_SPINLOCK */
 #endif /* __INCLUDE_NUTTX_SPINLOCK_H */
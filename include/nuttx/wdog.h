@@ -144,6 +144,10 @@ struct wdog_s
   uint8_t            flags;      /* See WDOGF_* definitions above */
   uint8_t            argc;       /* The number of parameters to pass */
   wdparm_t           parm[CONFIG_MAX_WDOGPARMS];
+#ifdef CONFIG_WDOG_WHEEL
+  uint8_t            slot;       /* Timing wheel slot holding the watchdog */
+  FAR struct wdog_s **pprev;     /* Link to this watchdog in the slot */
+#endif
 };
 
 /* Watchdog 'handle' */
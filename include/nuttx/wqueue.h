@@ -74,6 +74,8 @@
  *   collection, the default is 100*1000.
  * CONFIG_SCHED_HPWORKSTACKSIZE - The stack size allocated for the worker
  *   thread.  Default: 2048.
+ * CONFIG_SCHED_HPWORK_PERCPU - Create one high-priority work queue and
+ *   worker thread for each CPU (SMP only).
  * CONFIG_SIG_SIGWORK - The signal number that will be used to wake-up
  *   the worker thread.  Default: 17
  *
@@ -294,6 +296,9 @@ struct work_s
   FAR void *arg;         /* Callback argument */
   systime_t qtime;       /* Time work queued */
   systime_t delay;       /* Delay until work performed */
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+  uint8_t   cpu;         /* CPU of the high priority work queue */
+#endif
 };
 
 /****************************************************************************
@@ -363,6 +368,36 @@ int work_usrstart(void);
 int work_queue(int qid, FAR struct work_s *work, worker_t worker,
                FAR void *arg, systime_t delay);
 
+/****************************************************************************
+ * Name: work_queue_cpu
+ *
+ * Description:
+ *   Queue high priority work to be performed on a specific CPU.  This is
+ *   the same as work_queue(HPWORK, ...) except that the work is added to
+ *   the high priority work queue of the CPU 'cpu' rather than to the queue
+ *   of the current CPU.  If the work is already queued on another CPU, it
+ *   is first removed from that CPU's queue.
+ *
+ * Input Parameters:
+ *   cpu    - The CPU whose worker thread will perform the work
+ *   work   - The work structure to queue
+ *   worker - The worker callback to be invoked.  The callback will invoked
+ *            on the worker thread of execution.
+ *   arg    - The argument that will be passed to the workder callback when
+ *            int is invoked.
+ *   delay  - Delay (in clock ticks) from the time queue until the worker
+ *            is invoked. Zero means to perform the work immediately.
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+int work_queue_cpu(int cpu, FAR struct work_s *work, worker_t worker,
+                   FAR void *arg, systime_t delay);
+#endif
+
 /****************************************************************************
  * Name: work_cancel
  *
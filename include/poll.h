@@ -103,6 +103,14 @@ typedef unsigned int nfds_t;
 
 typedef uint8_t pollevent_t;
 
+/* If a notification callback is provided in the pollfd structure, then
+ * poll_notify() calls it instead of posting the semaphore.  This is used
+ * by epoll to keep a list of ready descriptors.
+ */
+
+struct pollfd;
+typedef CODE void (*pollcb_t)(FAR struct pollfd *fds);
+
 /* This is the Nuttx variant of the standard pollfd structure. */
 
 struct pollfd
@@ -112,6 +120,8 @@ struct pollfd
   pollevent_t events;   /* The input event flags */
   pollevent_t revents;  /* The output event flags */
   FAR void   *priv;     /* For use by drivers */
+  pollcb_t    cb;       /* Notification callback (NULL: post sem) */
+  FAR void   *arg;      /* For use by the notification callback */
 };
 
 /****************************************************************************
@@ -94,6 +94,9 @@ struct mallinfo
                  * chunks handed out by malloc. */
   int fordblks; /* This is the total size of memory occupied
                  * by free (not in use) chunks.*/
+  int fsmblks;  /* This is the total size of memory held in the
+                 * small-object cache (CONFIG_MM_CACHE).  That memory is
+                 * free but not included in fordblks. */
 };
 
 /* Structure type returned by the div() function. */
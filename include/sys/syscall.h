@@ -286,14 +286,16 @@
 #  define SYS_write                    (__SYS_descriptors+3)
 #  define SYS_pread                    (__SYS_descriptors+4)
 #  define SYS_pwrite                   (__SYS_descriptors+5)
+#  define SYS_readv                    (__SYS_descriptors+6)
+#  define SYS_writev                   (__SYS_descriptors+7)
 #  ifdef CONFIG_FS_AIO
-#    define SYS_aio_read               (__SYS_descriptors+6)
-#    define SYS_aio_write              (__SYS_descriptors+7)
-#    define SYS_aio_fsync              (__SYS_descriptors+8)
-#    define SYS_aio_cancel             (__SYS_descriptors+9)
-#    define __SYS_poll                 (__SYS_descriptors+10)
+#    define SYS_aio_read               (__SYS_descriptors+8)
+#    define SYS_aio_write              (__SYS_descriptors+9)
+#    define SYS_aio_fsync              (__SYS_descriptors+10)
+#    define SYS_aio_cancel             (__SYS_descriptors+11)
+#    define __SYS_poll                 (__SYS_descriptors+12)
 #  else
-#    define __SYS_poll                 (__SYS_descriptors+6)
+#    define __SYS_poll                 (__SYS_descriptors+8)
 #  endif
 #  ifndef CONFIG_DISABLE_POLL
 #    define SYS_poll                   __SYS_poll
@@ -551,6 +551,10 @@ int lio_listio(int mode, FAR struct aiocb *const list[], int nent,
   /* Lock the scheduler so that no I/O events can complete on the worker
    * thread until we set our wait set up.  Pre-emption will, of course, be
    * re-enabled while we are waiting for the signal.
+   *
+   * This also submits the list as one batch:  The AIO worker threads will
+   * not run until the entire list has been queued and can then combine
+   * adjacent reads or writes of the same file into a single transfer.
    */
 
   sched_lock();
@@ -40,6 +40,9 @@
 #include <nuttx/config.h>
 
 #include <sys/sendfile.h>
+#include <sys/ioctl.h>
+#include <sys/statfs.h>
+#include <stdint.h>
 #include <stdbool.h>
 #include <stdlib.h>
 #include <unistd.h>
@@ -51,6 +54,116 @@
 
 #if CONFIG_NSOCKET_DESCRIPTORS > 0 || CONFIG_NFILE_DESCRIPTORS > 0
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sendfile_mapped
+ *
+ * Description:
+ *   If the file system can return the address of the file data in memory
+ *   (FIOC_MMAP, as supported by ROMFS on XIP media), write the data to
+ *   'outfd' directly from that memory.  No I/O buffer is needed and the
+ *   data is not copied by read().
+ *
+ *   The data must not move or be freed while it is being written, so this
+ *   is only done for ROMFS.  tmpfs also supports FIOC_MMAP but reallocates
+ *   the file data when the file is written or truncated.
+ *
+ * Returned Value:
+ *   false if the file data is not accessible in memory; the file position
+ *   is unchanged in that case.  Otherwise true with the number of bytes
+ *   transferred (or ERROR) in 'result' and the file position advanced
+ *   past the transferred data.
+ *
+ ****************************************************************************/
+
+static bool sendfile_mapped(int outfd, int infd, size_t count,
+                            FAR ssize_t *result)
+{
+  FAR const uint8_t *mapped = NULL;
+  ssize_t nbyteswritten;
+  size_t ntransferred;
+  off_t curpos;
+  off_t endpos;
+  struct statfs buf;
+
+  if (fstatfs(infd, &buf) < 0 || buf.f_type != ROMFS_MAGIC)
+    {
+      return false;
+    }
+
+  if (ioctl(infd, FIOC_MMAP, (unsigned long)((uintptr_t)&mapped)) < 0 ||
+      mapped == NULL)
+    {
+      return false;
+    }
+
+  /* The mapped region ends at the end of the file */
+
+  curpos = lseek(infd, 0, SEEK_CUR);
+  if (curpos == (off_t)-1)
+    {
+      return false;
+    }
+
+  endpos = lseek(infd, 0, SEEK_END);
+  if (endpos == (off_t)-1)
+    {
+      (void)lseek(infd, curpos, SEEK_SET);
+      return false;
+    }
+
+  if (curpos >= endpos)
+    {
+      count = 0;
+    }
+  else if ((off_t)count > endpos - curpos)
+    {
+      count = endpos - curpos;
+    }
+
+  /* Write until everything has been written or an error occurs */
+
+  for (ntransferred = 0; ntransferred < count; )
+    {
+      nbyteswritten = _NX_WRITE(outfd, mapped + curpos + ntransferred,
+                                count - ntransferred);
+      if (nbyteswritten >= 0)
+        {
+          ntransferred += nbyteswritten;
+        }
+      else
+        {
+#ifndef CONFIG_DISABLE_SIGNALS
+          int errcode = _NX_GETERRNO(nbyteswritten);
+
+          /* EINTR is not an error if some data has been transferred */
+
+          if (errcode != EINTR || ntransferred == 0)
+#endif
+            {
+              _NX_SETERRNO(nbyteswritten);
+              (void)lseek(infd, curpos, SEEK_SET);
+              *result = ERROR;
+              return true;
+            }
+        }
+    }
+
+  /* Leave the file position after the data that was written */
+
+  if (lseek(infd, curpos + ntransferred, SEEK_SET) == (off_t)-1)
+    {
+      *result = ERROR;
+      return true;
+    }
+
+  *result = ntransferred;
+  return true;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -66,6 +179,9 @@
  *   nothing in NuttX but provide some Linux compatible (and adding
  *   another 'almost standard' interface).
  *
+ *   If the file system can return the address of the input file data in
+ *   memory (FIOC_MMAP), the data is written directly from there instead.
+ *
  *   NOTE: This interface is *not* specified in POSIX.1-2001, or other
  *   standards.  The implementation here is very similar to the Linux
  *   sendfile interface.  Other UNIX systems implement sendfile() with
@@ -133,6 +249,14 @@ ssize_t sendfile(int outfd, int infd, off_t *offset, size_t count)
         }
     }
 
+  /* Write directly from memory if the file data is accessible there */
+
+  if (sendfile_mapped(outfd, infd, count, &nbyteswritten))
+    {
+      ntransferred = nbyteswritten;
+      goto out;
+    }
+
   /* Allocate an I/O buffer */
 
   iobuffer = (FAR void *)lib_malloc(CONFIG_LIB_SENDFILE_BUFSIZE);
@@ -263,6 +387,8 @@ ssize_t sendfile(int outfd, int infd, off_t *offset, size_t count)
 
   lib_free(iobuffer);
 
+out:
+
   /* Return the current file position */
 
   if (offset)
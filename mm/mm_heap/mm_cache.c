@@ -0,0 +1,322 @@
+/****************************************************************************
+ * mm/mm_heap/mm_cache.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/mm/mm.h>
+
+#ifdef CONFIG_MM_CACHE
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_cache_lock
+ *
+ * Description:
+ *   Get exclusive access to the small-object cache of a CPU.  Local
+ *   interrupts are disabled so that the caller cannot be preempted (or,
+ *   in the SMP case, migrated to a different CPU) while it holds the cache.
+ *   In the SMP case, the cache spinlock is also taken.  That spinlock is
+ *   never contended except when another CPU flushes the cache.
+ *
+ ****************************************************************************/
+
+static inline irqstate_t mm_cache_lock(FAR struct mm_cache_s *cache)
+{
+  irqstate_t flags = up_irq_save();
+
+#ifdef CONFIG_SMP
+  spin_lock(&cache->mc_lock);
+#endif
+  return flags;
+}
+
+/****************************************************************************
+ * Name: mm_cache_unlock
+ *
+ * Description:
+ *   Relinquish exclusive access to the small-object cache of a CPU.
+ *
+ ****************************************************************************/
+
+static inline void mm_cache_unlock(FAR struct mm_cache_s *cache,
+                                   irqstate_t flags)
+{
+#ifdef CONFIG_SMP
+  spin_unlock(&cache->mc_lock);
+#endif
+  up_irq_restore(flags);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_cache_initialize
+ *
+ * Description:
+ *   Initialize the small-object caches of the selected heap.  All caches
+ *   are initially empty.
+ *
+ ****************************************************************************/
+
+void mm_cache_initialize(FAR struct mm_heap_s *heap)
+{
+#ifdef CONFIG_SMP
+  int cpu;
+#endif
+
+  memset(heap->mm_cache, 0, sizeof(struct mm_cache_s) * MM_CACHE_NCPUS);
+
+#ifdef CONFIG_SMP
+  for (cpu = 0; cpu < MM_CACHE_NCPUS; cpu++)
+    {
+      spin_initialize(&heap->mm_cache[cpu].mc_lock, SP_UNLOCKED);
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: mm_cache_alloc
+ *
+ * Description:
+ *   Try to satisfy an allocation from the small-object cache of the current
+ *   CPU.  The heap semaphore is not needed.
+ *
+ * Input Parameters:
+ *   heap      - The selected heap
+ *   chunksize - The aligned size of the chunk, including the allocated
+ *               chunk header.
+ *
+ * Returned Value:
+ *   The address of the user memory of a cached chunk of at least
+ *   'chunksize' bytes;  NULL if there is no cached chunk of that size.
+ *
+ ****************************************************************************/
+
+FAR void *mm_cache_alloc(FAR struct mm_heap_s *heap, size_t chunksize)
+{
+  FAR struct mm_cachenode_s *node;
+  FAR struct mm_cache_s *cache;
+  irqstate_t flags;
+  int ndx;
+
+  if (chunksize > MM_CACHE_MAXCHUNK)
+    {
+      return NULL;
+    }
+
+  ndx   = MM_CACHE_NDX(chunksize);
+  flags = up_irq_save();
+  cache = &heap->mm_cache[up_cpu_index()];
+
+#ifdef CONFIG_SMP
+  spin_lock(&cache->mc_lock);
+#endif
+
+  node = cache->mc_list[ndx];
+  if (node != NULL)
+    {
+      cache->mc_list[ndx] = node->flink;
+      cache->mc_count[ndx]--;
+      cache->mc_bytes    -= node->hdr.size;
+    }
+
+  mm_cache_unlock(cache, flags);
+
+  if (node == NULL)
+    {
+      return NULL;
+    }
+
+  DEBUGASSERT((node->hdr.preceding & MM_ALLOC_BIT) != 0);
+  return (FAR void *)((FAR char *)node + SIZEOF_MM_ALLOCNODE);
+}
+
+/****************************************************************************
+ * Name: mm_cache_free
+ *
+ * Description:
+ *   Try to retain a freed chunk in the small-object cache of the current
+ *   CPU.  The chunk remains marked as allocated in the heap.  The heap
+ *   semaphore is not needed.
+ *
+ * Input Parameters:
+ *   heap - The selected heap
+ *   mem  - The user memory of the chunk being freed
+ *
+ * Returned Value:
+ *   True if the chunk was retained in the cache;  false if the chunk is
+ *   too large or if the cache for that size is full.  In the latter case,
+ *   the caller must return the chunk to the heap.
+ *
+ ****************************************************************************/
+
+bool mm_cache_free(FAR struct mm_heap_s *heap, FAR void *mem)
+{
+  FAR struct mm_cachenode_s *node;
+  FAR struct mm_cache_s *cache;
+  irqstate_t flags;
+  bool cached = false;
+  int ndx;
+
+  node = (FAR struct mm_cachenode_s *)((FAR char *)mem - SIZEOF_MM_ALLOCNODE);
+  DEBUGASSERT((node->hdr.preceding & MM_ALLOC_BIT) != 0);
+
+  if (node->hdr.size > MM_CACHE_MAXCHUNK)
+    {
+      return false;
+    }
+
+  ndx   = MM_CACHE_NDX(node->hdr.size);
+  flags = up_irq_save();
+  cache = &heap->mm_cache[up_cpu_index()];
+
+#ifdef CONFIG_SMP
+  spin_lock(&cache->mc_lock);
+#endif
+
+  if (cache->mc_count[ndx] < CONFIG_MM_CACHE_DEPTH)
+    {
+      node->flink          = cache->mc_list[ndx];
+      cache->mc_list[ndx]  = node;
+      cache->mc_count[ndx]++;
+      cache->mc_bytes     += node->hdr.size;
+      cached               = true;
+    }
+
+  mm_cache_unlock(cache, flags);
+  return cached;
+}
+
+/****************************************************************************
+ * Name: mm_cache_flush
+ *
+ * Description:
+ *   Return every chunk held in the small-object caches of all CPUs to the
+ *   heap.  This is done when an allocation from the heap fails so that
+ *   memory tied up in the caches is not lost.
+ *
+ * Input Parameters:
+ *   heap - The selected heap
+ *
+ * Returned Value:
+ *   The total size of the chunks that were returned to the heap.
+ *
+ ****************************************************************************/
+
+size_t mm_cache_flush(FAR struct mm_heap_s *heap)
+{
+  FAR struct mm_cachenode_s *head = NULL;
+  FAR struct mm_cachenode_s *node;
+  FAR struct mm_cache_s *cache;
+  irqstate_t flags;
+  size_t nbytes = 0;
+  int cpu;
+  int ndx;
+
+  /* Detach the content of all caches while holding each cache lock */
+
+  for (cpu = 0; cpu < MM_CACHE_NCPUS; cpu++)
+    {
+      cache = &heap->mm_cache[cpu];
+      flags = mm_cache_lock(cache);
+
+      for (ndx = 0; ndx < MM_CACHE_NCLASSES; ndx++)
+        {
+          while ((node = cache->mc_list[ndx]) != NULL)
+            {
+              cache->mc_list[ndx] = node->flink;
+              node->flink         = head;
+              head                = node;
+            }
+
+          cache->mc_count[ndx] = 0;
+        }
+
+      nbytes         += cache->mc_bytes;
+      cache->mc_bytes = 0;
+      mm_cache_unlock(cache, flags);
+    }
+
+  /* Then return the detached chunks to the heap */
+
+  while ((node = head) != NULL)
+    {
+      head = node->flink;
+      mm_freechunk(heap, (FAR char *)node + SIZEOF_MM_ALLOCNODE);
+    }
+
+  minfo("Flushed %lu bytes\n", (unsigned long)nbytes);
+  return nbytes;
+}
+
+/****************************************************************************
+ * Name: mm_cache_bytes
+ *
+ * Description:
+ *   Return the total size of the chunks currently held in the small-object
+ *   caches of all CPUs.  This is only a snapshot:  The caches may change
+ *   immediately after the value is sampled.
+ *
+ ****************************************************************************/
+
+size_t mm_cache_bytes(FAR struct mm_heap_s *heap)
+{
+  size_t nbytes = 0;
+  int cpu;
+
+  for (cpu = 0; cpu < MM_CACHE_NCPUS; cpu++)
+    {
+      nbytes += heap->mm_cache[cpu].mc_bytes;
+    }
+
+  return nbytes;
+}
+
+#endif /* CONFIG_MM_CACHE */
@@ -120,8 +120,9 @@ void mm_extend(FAR struct mm_heap_s *heap, FAR void *mem, size_t size,
   mm_givesemaphore(heap);
 
   /* Finally "free" the new block of memory where the old terminal node was
-   * located.
+   * located.  This is not an allocation so it must bypass the small-object
+   * cache and the heap profile.
    */
 
-  mm_free(heap, (FAR void *)mem);
+  mm_freechunk(heap, (FAR void *)mem);
 }
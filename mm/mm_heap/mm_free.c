@@ -55,14 +55,14 @@
  *   Returns a chunk of memory to the list of free nodes,  merging with
  *   adjacent free chunks if possible.
  *
+ *   If the small-object cache is enabled, then small chunks are first
+ *   offered to the cache of the current CPU and are returned to the list
+ *   of free nodes only if that cache is full.
+ *
  ****************************************************************************/
 
 void mm_free(FAR struct mm_heap_s *heap, FAR void *mem)
 {
-  FAR struct mm_freenode_s *node;
-  FAR struct mm_freenode_s *prev;
-  FAR struct mm_freenode_s *next;
-
   minfo("Freeing %p\n", mem);
 
   /* Protect against attempts to free a NULL reference */
@@ -72,6 +72,42 @@ void mm_free(FAR struct mm_heap_s *heap, FAR void *mem)
       return;
     }
 
+#ifdef CONFIG_MM_CACHE
+  /* Try to keep the chunk in the cache.  That does not require the MM
+   * semaphore.
+   */
+
+  if (mm_cache_free(heap, mem))
+    {
+      return;
+    }
+#endif
+
+#ifdef CONFIG_MM_HEAPINFO
+  /* Remove the chunk from the heap profile */
+
+  mm_heapinfo_free(heap, (FAR struct mm_allocnode_s *)
+                   ((FAR char *)mem - SIZEOF_MM_ALLOCNODE));
+#endif
+
+  mm_freechunk(heap, mem);
+}
+
+/****************************************************************************
+ * Name: mm_freechunk
+ *
+ * Description:
+ *   Returns a chunk of memory directly to the list of free nodes, bypassing
+ *   the small-object cache and the heap profile.
+ *
+ ****************************************************************************/
+
+void mm_freechunk(FAR struct mm_heap_s *heap, FAR void *mem)
+{
+  FAR struct mm_freenode_s *node;
+  FAR struct mm_freenode_s *prev;
+  FAR struct mm_freenode_s *next;
+
   /* We need to hold the MM semaphore while we muck with the
    * nodelist.
    */
@@ -97,16 +133,9 @@ void mm_free(FAR struct mm_heap_s *heap, FAR void *mem)
 
       andbeyond = (FAR struct mm_allocnode_s *)((FAR char *)next + next->size);
 
-      /* Remove the next node.  There must be a predecessor,
-       * but there may not be a successor node.
-       */
+      /* Remove the next node from the free list */
 
-      DEBUGASSERT(next->blink);
-      next->blink->flink = next->flink;
-      if (next->flink)
-        {
-          next->flink->blink = next->blink;
-        }
+      mm_delfreechunk(heap, next);
 
       /* Then merge the two chunks */
 
@@ -122,16 +151,9 @@ void mm_free(FAR struct mm_heap_s *heap, FAR void *mem)
   prev = (FAR struct mm_freenode_s *)((FAR char *)node - node->preceding);
   if ((prev->preceding & MM_ALLOC_BIT) == 0)
     {
-      /* Remove the node.  There must be a predecessor, but there may
-       * not be a successor node.
-       */
+      /* Remove the preceding node from the free list */
 
-      DEBUGASSERT(prev->blink);
-      prev->blink->flink = prev->flink;
-      if (prev->flink)
-        {
-          prev->flink->blink = prev->blink;
-        }
+      mm_delfreechunk(heap, prev);
 
       /* Then merge the two chunks */
 
@@ -0,0 +1,217 @@
+/****************************************************************************
+ * mm/mm_heap/mm_heapinfo.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+#include <strings.h>
+#include <unistd.h>
+#include <assert.h>
+
+#include <nuttx/mm/mm.h>
+
+#ifdef CONFIG_MM_HEAPINFO
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_heapinfo_class
+ *
+ * Description:
+ *   Convert a chunk size into a size class index.
+ *
+ ****************************************************************************/
+
+static inline int mm_heapinfo_class(size_t size)
+{
+  int ndx = flsl((long)(size >> MM_MIN_SHIFT)) - 1;
+
+  if (ndx < 0)
+    {
+      return 0;
+    }
+  else if (ndx >= MM_NNODES)
+    {
+      return MM_NNODES - 1;
+    }
+
+  return ndx;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_heapinfo_alloc
+ *
+ * Description:
+ *   Record the allocation of a chunk in the heap profile and tag the chunk
+ *   with the ID of the current task and the address of the caller.  The
+ *   caller may or may not already hold the MM semaphore.
+ *
+ ****************************************************************************/
+
+void mm_heapinfo_alloc(FAR struct mm_heap_s *heap,
+                       FAR struct mm_allocnode_s *node, FAR void *caller)
+{
+  FAR struct mm_heapinfo_s *info = &heap->mm_info;
+  uint32_t nlive;
+  int ndx;
+
+  node->caller = caller;
+  node->pid    = (uintptr_t)getpid();
+
+  mm_takesemaphore(heap);
+
+  ndx = mm_heapinfo_class(node->size);
+  info->hi_nalloc[ndx]++;
+
+  nlive = info->hi_nalloc[ndx] - info->hi_nfree[ndx];
+  if (nlive > info->hi_maxlive[ndx])
+    {
+      info->hi_maxlive[ndx] = nlive;
+    }
+
+  info->hi_curused += node->size;
+  if (info->hi_curused > info->hi_maxused)
+    {
+      info->hi_maxused = info->hi_curused;
+    }
+
+  mm_givesemaphore(heap);
+}
+
+/****************************************************************************
+ * Name: mm_heapinfo_free
+ *
+ * Description:
+ *   Record the release of a chunk in the heap profile.  The caller may or
+ *   may not already hold the MM semaphore.
+ *
+ ****************************************************************************/
+
+void mm_heapinfo_free(FAR struct mm_heap_s *heap,
+                      FAR struct mm_allocnode_s *node)
+{
+  FAR struct mm_heapinfo_s *info = &heap->mm_info;
+
+  DEBUGASSERT((node->preceding & MM_ALLOC_BIT) != 0);
+
+  mm_takesemaphore(heap);
+
+  info->hi_nfree[mm_heapinfo_class(node->size)]++;
+  DEBUGASSERT(info->hi_curused >= node->size);
+  info->hi_curused -= node->size;
+
+  mm_givesemaphore(heap);
+}
+
+/****************************************************************************
+ * Name: mm_heapinfo
+ *
+ * Description:
+ *   Return a consistent snapshot of the heap profile.
+ *
+ ****************************************************************************/
+
+void mm_heapinfo(FAR struct mm_heap_s *heap, FAR struct mm_heapinfo_s *info)
+{
+  mm_takesemaphore(heap);
+  memcpy(info, &heap->mm_info, sizeof(struct mm_heapinfo_s));
+  mm_givesemaphore(heap);
+}
+
+/****************************************************************************
+ * Name: mm_heapinfo_walk
+ *
+ * Description:
+ *   Call 'handler' for each allocated chunk in the heap.  The MM semaphore
+ *   is held while the handler runs so the handler must not allocate from
+ *   or free to this heap.  The guard chunks at the beginning and end of
+ *   each region are not reported.
+ *
+ * Returned Value:
+ *   Zero if all chunks were visited;  otherwise the non-zero value returned
+ *   by the handler that stopped the traversal.
+ *
+ ****************************************************************************/
+
+int mm_heapinfo_walk(FAR struct mm_heap_s *heap, mm_walker_t handler,
+                     FAR void *arg)
+{
+  FAR struct mm_allocnode_s *node;
+  int ret = 0;
+#if CONFIG_MM_REGIONS > 1
+  int region;
+#else
+# define region 0
+#endif
+
+  /* Visit each region.  Retake the semaphore for each region to reduce
+   * latencies.
+   */
+
+#if CONFIG_MM_REGIONS > 1
+  for (region = 0; region < heap->mm_nregions && ret == 0; region++)
+#endif
+    {
+      mm_takesemaphore(heap);
+
+      for (node = (FAR struct mm_allocnode_s *)
+             ((FAR char *)heap->mm_heapstart[region] + SIZEOF_MM_ALLOCNODE);
+           node < heap->mm_heapend[region] && ret == 0;
+           node = (FAR struct mm_allocnode_s *)((FAR char *)node + node->size))
+        {
+          if ((node->preceding & MM_ALLOC_BIT) != 0)
+            {
+              ret = handler(node, arg);
+            }
+        }
+
+      mm_givesemaphore(heap);
+    }
+#undef region
+
+  return ret;
+}
+
+#endif /* CONFIG_MM_HEAPINFO */
@@ -64,6 +64,7 @@ int mm_mallinfo(FAR struct mm_heap_s *heap, FAR struct mallinfo *info)
   int    ordblks  = 0;  /* Number of non-inuse chunks */
   size_t uordblks = 0;  /* Total allocated space */
   size_t fordblks = 0;  /* Total non-inuse space */
+  size_t fsmblks  = 0;  /* Total space in cached chunks */
 #if CONFIG_MM_REGIONS > 1
   int region;
 #else
@@ -121,10 +122,27 @@ int mm_mallinfo(FAR struct mm_heap_s *heap, FAR struct mallinfo *info)
 
   DEBUGASSERT(uordblks + fordblks == heap->mm_heapsize);
 
+#ifdef CONFIG_MM_CACHE
+  /* Chunks held in the small-object caches appear to be allocated in the
+   * heap, but they are really free.  Report them separately.  NOTE that
+   * the caches are not locked while the heap is traversed so this is only
+   * an estimate if there is concurrent allocation activity.
+   */
+
+  fsmblks = mm_cache_bytes(heap);
+  if (fsmblks > uordblks)
+    {
+      fsmblks = uordblks;
+    }
+
+  uordblks -= fsmblks;
+#endif
+
   info->arena    = heap->mm_heapsize;
   info->ordblks  = ordblks;
   info->mxordblk = mxordblk;
   info->uordblks = uordblks;
   info->fordblks = fordblks;
+  info->fsmblks  = fsmblks;
   return OK;
 }
@@ -73,7 +73,6 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
   FAR struct mm_freenode_s *node;
   size_t alignsize;
   void *ret = NULL;
-  int ndx;
 
   /* Ignore zero-length allocations */
 
@@ -89,37 +88,29 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
   alignsize = MM_ALIGN_UP(size + SIZEOF_MM_ALLOCNODE);
   DEBUGASSERT(alignsize >= size);  /* Check for integer overflow */
 
-  /* We need to hold the MM semaphore while we muck with the nodelist. */
-
-  mm_takesemaphore(heap);
-
-  /* Get the location in the node list to start the search. Special case
-   * really big allocations
+#ifdef CONFIG_MM_CACHE
+  /* Small allocations may be satisfied from the small-object cache of this
+   * CPU without taking the MM semaphore.
    */
 
-  if (alignsize >= MM_MAX_CHUNK)
+  ret = mm_cache_alloc(heap, alignsize);
+  if (ret != NULL)
     {
-      ndx = MM_NNODES-1;
+      minfo("Allocated %p from cache, size %d\n", ret, alignsize);
+      return ret;
     }
-  else
-    {
-      /* Convert the request size into a nodelist index */
+#endif
 
-      ndx = mm_size2ndx(alignsize);
-    }
+  /* We need to hold the MM semaphore while we muck with the nodelist. */
 
-  /* Search for a large enough chunk in the list of nodes. This list is
-   * ordered by size, but will have occasional zero sized nodes as we visit
-   * other mm_nodelist[] entries.
-   */
+  mm_takesemaphore(heap);
+
+  /* Find a free chunk that is large enough */
 
-  for (node = heap->mm_nodelist[ndx].flink;
-       node && node->size < alignsize;
-       node = node->flink);
+  node = mm_findfreechunk(heap, alignsize);
 
-  /* If we found a node with non-zero size, then this is one to use. Since
-   * the list is ordered, we know that is must be best fitting chunk
-   * available.
+  /* If we found a node with non-zero size, then this is one to use.  With
+   * the default node lists, this is the best fitting chunk available.
    */
 
   if (node)
@@ -128,16 +119,9 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
       FAR struct mm_freenode_s *next;
       size_t remaining;
 
-      /* Remove the node.  There must be a predecessor, but there may not be
-       * a successor node.
-       */
+      /* Remove the node from the free list */
 
-      DEBUGASSERT(node->blink);
-      node->blink->flink = node->flink;
-      if (node->flink)
-        {
-          node->flink->blink = node->blink;
-        }
+      mm_delfreechunk(heap, node);
 
       /* Check if we have to split the free node into one of the allocated
        * size and another smaller freenode.  In some cases, the remaining
@@ -180,10 +164,29 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
 
       node->preceding |= MM_ALLOC_BIT;
       ret = (void *)((FAR char *)node + SIZEOF_MM_ALLOCNODE);
+
+#ifdef CONFIG_MM_HEAPINFO
+      /* Record the allocation in the heap profile */
+
+      mm_heapinfo_alloc(heap, (FAR struct mm_allocnode_s *)node,
+                        MM_RETURN_ADDRESS());
+#endif
     }
 
   mm_givesemaphore(heap);
 
+#ifdef CONFIG_MM_CACHE
+  /* If the allocation failed, then the memory that we need may be held in
+   * the small-object caches.  Return all cached chunks to the heap and, if
+   * that recovered anything, try again.
+   */
+
+  if (ret == NULL && mm_cache_flush(heap) > 0)
+    {
+      return mm_malloc(heap, size);
+    }
+#endif
+
   /* If CONFIG_DEBUG_MM is defined, then output the result of the allocation
    * to the SYSLOG.
    */
@@ -43,6 +43,20 @@
 
 #include <nuttx/mm/mm.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Chunks are aligned to MM_MIN_CHUNK and the memory returned by mm_malloc()
+ * immediately follows the chunk header.  That memory is then aligned to the
+ * largest power of two that divides SIZEOF_MM_ALLOCNODE:  4 or 8 bytes
+ * normally but, for example, 16 bytes with a 32-bit CONFIG_MM_HEAPINFO
+ * header or 8 bytes with a 64-bit one.
+ */
+
+#define MM_MALLOC_ALIGN \
+  (SIZEOF_MM_ALLOCNODE & ~(SIZEOF_MM_ALLOCNODE - 1))
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -55,8 +69,8 @@
  *   within that chunk that meets the alignment request and then frees any
  *   leading or trailing space.
  *
- *   The alignment argument must be a power of two (not checked).  8-byte
- *   alignment is guaranteed by normal malloc calls.
+ *   The alignment argument must be a power of two (not checked).
+ *   MM_MALLOC_ALIGN alignment is guaranteed by normal malloc calls.
  *
  ****************************************************************************/
 
@@ -73,7 +87,7 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
    * of malloc, then just let malloc do the work.
    */
 
-  if (alignment <= MM_MIN_CHUNK)
+  if (alignment <= MM_MALLOC_ALIGN)
     {
       return mm_malloc(heap, size);
     }
@@ -113,6 +127,12 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
 
   node = (FAR struct mm_allocnode_s *)(rawchunk - SIZEOF_MM_ALLOCNODE);
 
+#ifdef CONFIG_MM_HEAPINFO
+  /* The aligned chunk will be re-entered in the heap profile below */
+
+  mm_heapinfo_free(heap, node);
+#endif
+
   /* Find the aligned subregion */
 
   alignedchunk = (rawchunk + mask) & ~mask;
@@ -205,6 +225,10 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
       mm_shrinkchunk(heap, node, size);
     }
 
+#ifdef CONFIG_MM_HEAPINFO
+  mm_heapinfo_alloc(heap, node, MM_RETURN_ADDRESS());
+#endif
+
   mm_givesemaphore(heap);
   return (FAR void *)alignedchunk;
 }
@@ -125,7 +125,13 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
 
       if (newsize < oldsize)
         {
+#ifdef CONFIG_MM_HEAPINFO
+          mm_heapinfo_free(heap, oldnode);
+#endif
           mm_shrinkchunk(heap, oldnode, newsize);
+#ifdef CONFIG_MM_HEAPINFO
+          mm_heapinfo_alloc(heap, oldnode, MM_RETURN_ADDRESS());
+#endif
         }
 
       /* Then return the original address */
@@ -159,6 +165,12 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
       size_t takeprev = 0;
       size_t takenext = 0;
 
+#ifdef CONFIG_MM_HEAPINFO
+      /* The chunk will be re-entered in the heap profile with its new size */
+
+      mm_heapinfo_free(heap, oldnode);
+#endif
+
       /* Check if we can extend into the previous chunk and if the
        * previous chunk is smaller than the next chunk.
        */
@@ -220,16 +232,9 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
         {
           FAR struct mm_allocnode_s *newnode;
 
-          /* Remove the previous node.  There must be a predecessor, but
-           * there may not be a successor node.
-           */
+          /* Remove the previous node from the free list */
 
-          DEBUGASSERT(prev->blink);
-          prev->blink->flink = prev->flink;
-          if (prev->flink)
-            {
-              prev->flink->blink = prev->blink;
-            }
+          mm_delfreechunk(heap, prev);
 
           /* Extend the node into the previous free chunk */
 
@@ -287,16 +292,9 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
 
           andbeyond = (FAR struct mm_allocnode_s *)((FAR char *)next + nextsize);
 
-          /* Remove the next node.  There must be a predecessor, but there
-           * may not be a successor node.
-           */
+          /* Remove the next node from the free list */
 
-          DEBUGASSERT(next->blink);
-          next->blink->flink = next->flink;
-          if (next->flink)
-            {
-              next->flink->blink = next->blink;
-            }
+          mm_delfreechunk(heap, next);
 
           /* Extend the node into the next chunk */
 
@@ -327,6 +325,10 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
             }
         }
 
+#ifdef CONFIG_MM_HEAPINFO
+      mm_heapinfo_alloc(heap, oldnode, MM_RETURN_ADDRESS());
+#endif
+
       mm_givesemaphore(heap);
       return newmem;
     }
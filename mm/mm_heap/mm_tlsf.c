@@ -0,0 +1,274 @@
+/****************************************************************************
+ * mm/mm_heap/mm_tlsf.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <strings.h>
+#include <assert.h>
+
+#include <nuttx/mm/mm.h>
+
+#ifdef CONFIG_MM_TLSF
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_tlsf_mapping
+ *
+ * Description:
+ *   Map a chunk size to the first and second level indices of the free list
+ *   that holds chunks of that size.
+ *
+ ****************************************************************************/
+
+static inline void mm_tlsf_mapping(size_t size, FAR int *fl, FAR int *sl)
+{
+  size_t units;
+  int msb;
+
+  /* Really big chunks all go into the last list */
+
+  if (size >= MM_MAX_CHUNK)
+    {
+      *fl = MM_TLSF_FLCOUNT - 1;
+      *sl = MM_TLSF_SLCOUNT - 1;
+      return;
+    }
+
+  /* Small chunks are mapped linearly into the first level 0 lists.  Above
+   * that, each power of two is split into MM_TLSF_SLCOUNT lists.
+   */
+
+  units = size >> MM_MIN_SHIFT;
+  if (units < MM_TLSF_SLCOUNT)
+    {
+      *fl = 0;
+      *sl = (int)units;
+    }
+  else
+    {
+      msb = flsl((long)units) - 1;
+      *fl = msb - CONFIG_MM_TLSF_SLI + 1;
+      *sl = (int)(units >> (msb - CONFIG_MM_TLSF_SLI)) - MM_TLSF_SLCOUNT;
+    }
+
+  DEBUGASSERT(*fl < MM_TLSF_FLCOUNT && *sl < MM_TLSF_SLCOUNT);
+}
+
+/****************************************************************************
+ * Name: mm_tlsf_roundup
+ *
+ * Description:
+ *   Round a request size up to the next second level boundary.  Then every
+ *   chunk in the list that the rounded size maps to (or in any higher list)
+ *   is large enough to satisfy the request.
+ *
+ ****************************************************************************/
+
+static inline size_t mm_tlsf_roundup(size_t size)
+{
+  size_t units = size >> MM_MIN_SHIFT;
+  int msb;
+
+  if (units >= MM_TLSF_SLCOUNT && size < MM_MAX_CHUNK)
+    {
+      msb    = flsl((long)units) - 1;
+      units += ((size_t)1 << (msb - CONFIG_MM_TLSF_SLI)) - 1;
+      size   = units << MM_MIN_SHIFT;
+    }
+
+  return size;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_addfreechunk
+ *
+ * Description:
+ *   Add a free chunk to the head of its segregated free list.  It is assumed
+ *   that the caller holds the mm semaphore
+ *
+ ****************************************************************************/
+
+void mm_addfreechunk(FAR struct mm_heap_s *heap,
+                     FAR struct mm_freenode_s *node)
+{
+  FAR struct mm_freenode_s *head;
+  int fl;
+  int sl;
+
+  mm_tlsf_mapping(node->size, &fl, &sl);
+
+  head        = heap->mm_freelist[fl][sl];
+  node->blink = NULL;
+  node->flink = head;
+
+  if (head)
+    {
+      head->blink = node;
+    }
+
+  heap->mm_freelist[fl][sl] = node;
+  heap->mm_slbitmap[fl]    |= (uint32_t)1 << sl;
+  heap->mm_flbitmap        |= (uint32_t)1 << fl;
+}
+
+/****************************************************************************
+ * Name: mm_delfreechunk
+ *
+ * Description:
+ *   Remove a free chunk from its segregated free list.  The node size must
+ *   not have been modified since the node was added to the free list.  It
+ *   is assumed that the caller holds the mm semaphore
+ *
+ ****************************************************************************/
+
+void mm_delfreechunk(FAR struct mm_heap_s *heap,
+                     FAR struct mm_freenode_s *node)
+{
+  int fl;
+  int sl;
+
+  mm_tlsf_mapping(node->size, &fl, &sl);
+
+  if (node->blink)
+    {
+      node->blink->flink = node->flink;
+    }
+  else
+    {
+      DEBUGASSERT(heap->mm_freelist[fl][sl] == node);
+      heap->mm_freelist[fl][sl] = node->flink;
+    }
+
+  if (node->flink)
+    {
+      node->flink->blink = node->blink;
+    }
+
+  /* Update the bitmaps if the list is now empty */
+
+  if (heap->mm_freelist[fl][sl] == NULL)
+    {
+      heap->mm_slbitmap[fl] &= ~((uint32_t)1 << sl);
+      if (heap->mm_slbitmap[fl] == 0)
+        {
+          heap->mm_flbitmap &= ~((uint32_t)1 << fl);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: mm_findfreechunk
+ *
+ * Description:
+ *   Find a free chunk of at least 'size' bytes.  The chunk is not removed
+ *   from its free list.  It is assumed that the caller holds the mm
+ *   semaphore.
+ *
+ *   This is a good fit, not a best fit, search:  The chunk is taken from
+ *   the first non-empty list whose chunks are all large enough.  That takes
+ *   constant time for any request smaller than MM_MAX_CHUNK.  Only if there
+ *   is no such list is the list for the request size itself searched.  That
+ *   search is not bounded but happens only when the heap is (nearly)
+ *   exhausted.
+ *
+ ****************************************************************************/
+
+FAR struct mm_freenode_s *mm_findfreechunk(FAR struct mm_heap_s *heap,
+                                           size_t size)
+{
+  FAR struct mm_freenode_s *node;
+  uint32_t bitmap;
+  int fl;
+  int sl;
+
+  /* Look for a non-empty list at or above the rounded-up size */
+
+  mm_tlsf_mapping(mm_tlsf_roundup(size), &fl, &sl);
+
+  bitmap = heap->mm_slbitmap[fl] & (UINT32_MAX << sl);
+  if (bitmap == 0)
+    {
+      bitmap = heap->mm_flbitmap & (UINT32_MAX << (fl + 1));
+      if (bitmap != 0)
+        {
+          fl     = ffsl((long)bitmap) - 1;
+          bitmap = heap->mm_slbitmap[fl];
+        }
+    }
+
+  if (bitmap != 0)
+    {
+      sl = ffsl((long)bitmap) - 1;
+
+      /* Every chunk in the selected list is large enough except, perhaps,
+       * in the last list which also holds all of the really big chunks.
+       */
+
+      for (node = heap->mm_freelist[fl][sl];
+           node && node->size < size;
+           node = node->flink);
+
+      if (node)
+        {
+          return node;
+        }
+    }
+
+  /* Otherwise, there may still be a large enough chunk in the list that the
+   * request size maps to.
+   */
+
+  mm_tlsf_mapping(size, &fl, &sl);
+
+  for (node = heap->mm_freelist[fl][sl];
+       node && node->size < size;
+       node = node->flink);
+
+  return node;
+}
+
+#endif /* CONFIG_MM_TLSF */
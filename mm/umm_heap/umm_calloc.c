@@ -59,5 +59,9 @@
 
 FAR void *calloc(size_t n, size_t elem_size)
 {
-  return mm_calloc(USR_HEAP, n, elem_size);
+  FAR void *mem;
+
+  mem = mm_calloc(USR_HEAP, n, elem_size);
+  MM_SETCALLER(mem);
+  return mem;
 }
@@ -97,6 +97,10 @@ FAR void *malloc(size_t size)
 
   return mem;
 #else
-  return mm_malloc(USR_HEAP, size);
+  FAR void *mem;
+
+  mem = mm_malloc(USR_HEAP, size);
+  MM_SETCALLER(mem);
+  return mem;
 #endif
 }
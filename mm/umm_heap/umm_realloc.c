@@ -66,5 +66,9 @@
 
 FAR void *realloc(FAR void *oldmem, size_t size)
 {
-  return mm_realloc(USR_HEAP, oldmem, size);
+  FAR void *newmem;
+
+  newmem = mm_realloc(USR_HEAP, oldmem, size);
+  MM_SETCALLER(newmem);
+  return newmem;
 }
@@ -80,6 +80,10 @@ FAR void *zalloc(size_t size)
 #else
   /* Use mm_zalloc() becuase it implements the clear */
 
-  return mm_zalloc(USR_HEAP, size);
+  FAR void *alloc;
+
+  alloc = mm_zalloc(USR_HEAP, size);
+  MM_SETCALLER(alloc);
+  return alloc;
 #endif
 }
@@ -41,6 +41,7 @@
 
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <stdbool.h>
 #include <assert.h>
 #include <errno.h>
@@ -88,6 +89,8 @@ static ssize_t    inet_sendto(FAR struct socket *psock, FAR const void *buf,
 static ssize_t    inet_sendfile(FAR struct socket *psock, FAR struct file *infile,
                     FAR off_t *offset, size_t count);
 #endif
+static ssize_t    inet_sendv(FAR struct socket *psock,
+                    FAR const struct iovec *iov, int iovcnt, int flags);
 
 /****************************************************************************
  * Private Data
@@ -112,7 +115,8 @@ static const struct sock_intf_s g_inet_sockif =
   inet_sendfile,    /* si_sendfile */
 #endif
   inet_recvfrom,    /* si_recvfrom */
-  inet_close        /* si_close */
+  inet_close,       /* si_close */
+  inet_sendv        /* si_sendv */
 };
 
 /****************************************************************************
@@ -1178,6 +1182,50 @@ static ssize_t inet_sendto(FAR struct socket *psock, FAR const void *buf,
   return nsent;
 }
 
+/****************************************************************************
+ * Name: inet_sendv
+ *
+ * Description:
+ *   Send data gathered from several buffers on a connected INET socket.
+ *   With write buffering, all of the data is copied into one write buffer
+ *   so that it goes out in as few TCP segments as possible or as one UDP
+ *   datagram.
+ *
+ * Input Parameters:
+ *   psock    An instance of the internal socket structure.
+ *   iov      Array of buffers containing the data to send
+ *   iovcnt   Number of elements in iov[]
+ *   flags    Send flags
+ *
+ * Returned Value:
+ *   On success, returns the number of characters sent.  On  error, a negated
+ *   errno value is returned.  -ENOSYS is returned if the socket cannot
+ *   gather the data; the caller will then send each buffer in turn.
+ *
+ ****************************************************************************/
+
+static ssize_t inet_sendv(FAR struct socket *psock,
+                          FAR const struct iovec *iov, int iovcnt, int flags)
+{
+  switch (psock->s_type)
+    {
+#if defined(NET_TCP_HAVE_STACK) && defined(CONFIG_NET_TCP_WRITE_BUFFERS) && \
+   !defined(CONFIG_NET_6LOWPAN)
+      case SOCK_STREAM:
+        return psock_tcp_sendv(psock, iov, iovcnt);
+#endif
+
+#if defined(NET_UDP_HAVE_STACK) && defined(CONFIG_NET_UDP_WRITE_BUFFERS) && \
+   !defined(CONFIG_NET_6LOWPAN)
+      case SOCK_DGRAM:
+        return psock_udp_sendv(psock, iov, iovcnt);
+#endif
+
+      default:
+        return -ENOSYS;
+    }
+}
+
 /****************************************************************************
  * Name: inet_sendfile
  *
@@ -1204,7 +1252,7 @@ static ssize_t inet_sendfile(FAR struct socket *psock,
                              size_t count)
 {
 #if defined(CONFIG_NET_TCP) && !defined(CONFIG_NET_TCP_NO_STACK)
-  return tcp_sendfile(psock, infile, offset, size_t count);
+  return tcp_sendfile(psock, infile, offset, count);
 #else
   return -ENOSYS;
 #endif
@@ -146,7 +146,7 @@ static int ipv4_hdrsize(FAR struct ipv4_hdr_s *ipv4)
 
 static int ipv4_decr_ttl(FAR struct ipv4_hdr_s *ipv4)
 {
-  uint16_t sum;
+  uint16_t oldval;
   int ttl = (int)ipv4->ttl - 1;
 
   if (ttl <= 0)
@@ -163,25 +163,16 @@ static int ipv4_decr_ttl(FAR struct ipv4_hdr_s *ipv4)
 
   /* Save the updated TTL value */
 
+  oldval    = HTONS(((uint16_t)ipv4->ttl << 8) | ipv4->proto);
   ipv4->ttl = ttl;
 
-  /* Re-calculate the IPv4 checksum.  This checksum is the Internet checksum
-   * of the 20 bytes of the IPv4 header.  This checksum will be different
-   * because we just modify the IPv4 TTL.
+  /* Update the IPv4 header checksum.  Only the 16-bit word holding the TTL
+   * has changed so the checksum can be adjusted incrementally rather than
+   * re-calculated over the entire header.
    */
 
-  ipv4->ipchksum = 0;
-  sum            = chksum(0, (FAR const uint8_t *)ipv4, IPv4_HDRLEN);
-  if (sum == 0)
-    {
-      sum = 0xffff;
-    }
-  else
-    {
-      sum = htons(sum);
-    }
-
-  ipv4->ipchksum = ~sum;
+  net_chksum_adjust(&ipv4->ipchksum, oldval,
+                    HTONS(((uint16_t)ipv4->ttl << 8) | ipv4->proto));
   return ttl;
 }
 
@@ -79,6 +79,10 @@ static int     netprocfs_sent(FAR struct netprocfs_file_s *netfile);
 #ifdef CONFIG_NET_TCP
 static int     netprocfs_retransmissions(FAR struct netprocfs_file_s *netfile);
 #endif /* CONFIG_NET_TCP */
+#if defined(CONFIG_NET_TCP) || defined(CONFIG_NET_UDP)
+static int     netprocfs_lookups(FAR struct netprocfs_file_s *netfile);
+static int     netprocfs_probes(FAR struct netprocfs_file_s *netfile);
+#endif /* CONFIG_NET_TCP || CONFIG_NET_UDP */
 
 /****************************************************************************
  * Private Data
@@ -113,6 +117,11 @@ static const linegen_t g_stat_linegen[] =
 #ifdef CONFIG_NET_TCP
   , netprocfs_retransmissions
 #endif /* CONFIG_NET_TCP */
+
+#if defined(CONFIG_NET_TCP) || defined(CONFIG_NET_UDP)
+  , netprocfs_lookups
+  , netprocfs_probes
+#endif /* CONFIG_NET_TCP || CONFIG_NET_UDP */
 };
 
 #define NSTAT_LINES (sizeof(g_stat_linegen) / sizeof(linegen_t))
@@ -435,6 +444,80 @@ static int netprocfs_retransmissions(FAR struct netprocfs_file_s *netfile)
 }
 #endif /* CONFIG_NET_STATISTICS && CONFIG_NET_TCP */
 
+/****************************************************************************
+ * Name: netprocfs_lookups
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_STATISTICS) && \
+    (defined(CONFIG_NET_TCP) || defined(CONFIG_NET_UDP))
+static int netprocfs_lookups(FAR struct netprocfs_file_s *netfile)
+{
+  int len = 0;
+
+  len += snprintf(&netfile->line[len], NET_LINELEN - len, "Lookups    ");
+#ifdef CONFIG_NET_IPv4
+  len += snprintf(&netfile->line[len], NET_LINELEN - len, "  ----");
+#endif
+#ifdef CONFIG_NET_IPv6
+  len += snprintf(&netfile->line[len], NET_LINELEN - len, "  ----");
+#endif
+#ifdef CONFIG_NET_TCP
+  len += snprintf(&netfile->line[len], NET_LINELEN - len, "  %04x",
+                  g_netstats.tcp.lookup);
+#endif
+#ifdef CONFIG_NET_UDP
+  len += snprintf(&netfile->line[len], NET_LINELEN - len, "  %04x",
+                  g_netstats.udp.lookup);
+#endif
+#ifdef CONFIG_NET_ICMP
+  len += snprintf(&netfile->line[len], NET_LINELEN - len, "  ----");
+#endif
+#ifdef CONFIG_NET_ICMPv6
+  len += snprintf(&netfile->line[len], NET_LINELEN - len, "  ----");
+#endif
+
+  len += snprintf(&netfile->line[len], NET_LINELEN - len, "\n");
+  return len;
+}
+#endif /* CONFIG_NET_STATISTICS && (CONFIG_NET_TCP || CONFIG_NET_UDP) */
+
+/****************************************************************************
+ * Name: netprocfs_probes
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_STATISTICS) && \
+    (defined(CONFIG_NET_TCP) || defined(CONFIG_NET_UDP))
+static int netprocfs_probes(FAR struct netprocfs_file_s *netfile)
+{
+  int len = 0;
+
+  len += snprintf(&netfile->line[len], NET_LINELEN - len, "  Probes   ");
+#ifdef CONFIG_NET_IPv4
+  len += snprintf(&netfile->line[len], NET_LINELEN - len, "  ----");
+#endif
+#ifdef CONFIG_NET_IPv6
+  len += snprintf(&netfile->line[len], NET_LINELEN - len, "  ----");
+#endif
+#ifdef CONFIG_NET_TCP
+  len += snprintf(&netfile->line[len], NET_LINELEN - len, "  %04x",
+                  g_netstats.tcp.probe);
+#endif
+#ifdef CONFIG_NET_UDP
+  len += snprintf(&netfile->line[len], NET_LINELEN - len, "  %04x",
+                  g_netstats.udp.probe);
+#endif
+#ifdef CONFIG_NET_ICMP
+  len += snprintf(&netfile->line[len], NET_LINELEN - len, "  ----");
+#endif
+#ifdef CONFIG_NET_ICMPv6
+  len += snprintf(&netfile->line[len], NET_LINELEN - len, "  ----");
+#endif
+
+  len += snprintf(&netfile->line[len], NET_LINELEN - len, "\n");
+  return len;
+}
+#endif /* CONFIG_NET_STATISTICS && (CONFIG_NET_TCP || CONFIG_NET_UDP) */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -41,6 +41,7 @@
 
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <errno.h>
 #include <assert.h>
 #include <debug.h>
@@ -159,6 +160,83 @@ ssize_t nx_send(int sockfd, FAR const void *buf, size_t len, int flags)
   return psock_send(psock, buf, len, flags);
 }
 
+/****************************************************************************
+ * Name: psock_sendv
+ *
+ * Description:
+ *   Send the data gathered from several buffers on a connected socket.
+ *   See include/nuttx/net/net.h.
+ *
+ ****************************************************************************/
+
+ssize_t psock_sendv(FAR struct socket *psock, FAR const struct iovec *iov,
+                    int iovcnt, int flags)
+{
+  ssize_t ntotal;
+  ssize_t ret;
+  int i;
+
+  /* Verify that the sockfd corresponds to valid, allocated socket */
+
+  if (psock == NULL || psock->s_crefs <= 0)
+    {
+      return -EBADF;
+    }
+
+  DEBUGASSERT(psock->s_sockif != NULL);
+
+  /* Let the address family gather the data if it can */
+
+  if (psock->s_sockif->si_sendv != NULL)
+    {
+      ret = psock->s_sockif->si_sendv(psock, iov, iovcnt, flags);
+      if (ret != -ENOSYS)
+        {
+          return ret;
+        }
+    }
+
+  /* Otherwise, send each buffer in turn */
+
+  for (i = 0, ntotal = 0; i < iovcnt; i++)
+    {
+      if (iov[i].iov_len == 0)
+        {
+          continue;
+        }
+
+      ret = psock_send(psock, iov[i].iov_base, iov[i].iov_len, flags);
+      if (ret < 0)
+        {
+          /* Return an error only if nothing has been sent */
+
+          return ntotal > 0 ? ntotal : ret;
+        }
+
+      ntotal += ret;
+      if ((size_t)ret < iov[i].iov_len)
+        {
+          break;
+        }
+    }
+
+  return ntotal;
+}
+
+/****************************************************************************
+ * Name: nx_sendv
+ *
+ * Description:
+ *   Equivalent to psock_sendv() but accepts a socket descriptor.
+ *
+ ****************************************************************************/
+
+ssize_t nx_sendv(int sockfd, FAR const struct iovec *iov, int iovcnt,
+                 int flags)
+{
+  return psock_sendv(sockfd_socket(sockfd), iov, iovcnt, flags);
+}
+
 /****************************************************************************
  * Name: send
  *
@@ -84,10 +84,10 @@
 #  define TCP_WBNRTX(wrb)            ((wrb)->wb_nrtx)
 #  define TCP_WBIOB(wrb)             ((wrb)->wb_iob)
 #  define TCP_WBCOPYOUT(wrb,dest,n)  (iob_copyout(dest,(wrb)->wb_iob,(n),0))
-#  define TCP_WBCOPYIN(wrb,src,n) \
-     (iob_copyin((wrb)->wb_iob,src,(n),0,false))
-#  define TCP_WBTRYCOPYIN(wrb,src,n) \
-     (iob_trycopyin((wrb)->wb_iob,src,(n),0,false))
+#  define TCP_WBCOPYIN(wrb,src,n,off) \
+     (iob_copyin((wrb)->wb_iob,src,(n),(off),false))
+#  define TCP_WBTRYCOPYIN(wrb,src,n,off) \
+     (iob_trycopyin((wrb)->wb_iob,src,(n),(off),false))
 
 #  define TCP_WBTRIM(wrb,n) \
      do { (wrb)->wb_iob = iob_trimhead((wrb)->wb_iob,(n)); } while (0)
@@ -143,6 +143,10 @@ struct tcp_conn_s
   uint16_t mss;           /* Current maximum segment size for the
                            * connection */
   uint16_t winsize;       /* Current window size of the connection */
+#ifdef CONFIG_NET_TCP_HASH
+  FAR struct tcp_conn_s *hnext;  /* Next active connection in the bucket */
+  FAR struct tcp_conn_s *lnext;  /* Next listener in the bucket */
+#endif
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
   uint32_t unacked;       /* Number bytes sent but not yet ACKed */
 #else
@@ -1287,6 +1291,23 @@ struct socket;
 ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
                        size_t len);
 
+/****************************************************************************
+ * Name: psock_tcp_sendv
+ *
+ * Description:
+ *   Like psock_tcp_send() but the data is gathered from the iovcnt buffers
+ *   described by iov into a single write buffer.  The data is then sent
+ *   in as few segments as the MSS allows rather than in one segment per
+ *   buffer.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_WRITE_BUFFERS
+struct iovec;
+ssize_t psock_tcp_sendv(FAR struct socket *psock, FAR const struct iovec *iov,
+                        int iovcnt);
+#endif
+
 /****************************************************************************
  * Name: tcp_setsockopt
  *
@@ -60,6 +60,7 @@
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/ip.h>
 #include <nuttx/net/tcp.h>
+#include <nuttx/net/netstats.h>
 
 #include "devif/devif.h"
 #include "inet/inet.h"
@@ -72,6 +73,10 @@
 #define IPv4BUF ((struct ipv4_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
 #define IPv6BUF ((struct ipv6_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
 
+#ifdef CONFIG_NET_TCP_HASH
+#  define TCP_HASHMASK (CONFIG_NET_TCP_HASHSIZE - 1)
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -88,6 +93,14 @@ static dq_queue_t g_free_tcp_connections;
 
 static dq_queue_t g_active_tcp_connections;
 
+#ifdef CONFIG_NET_TCP_HASH
+/* The active connections hashed by local port, remote port and remote
+ * address.
+ */
+
+static FAR struct tcp_conn_s *g_tcp_hash[CONFIG_NET_TCP_HASHSIZE];
+#endif
+
 /* Last port used by a TCP connection connection. */
 
 static uint16_t g_last_tcp_port;
@@ -96,6 +109,106 @@ static uint16_t g_last_tcp_port;
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: tcp_hash
+ *
+ * Description:
+ *   Return the hash table index for a connection.  Port numbers and the
+ *   (folded) remote IP address are in network byte order.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_HASH
+static inline unsigned int tcp_hash(uint16_t lport, uint16_t rport,
+                                    uint32_t raddr)
+{
+  uint32_t hash = raddr ^ ((uint32_t)lport << 16) ^ rport;
+
+  hash ^= hash >> 16;
+  hash ^= hash >> 8;
+  return hash & TCP_HASHMASK;
+}
+#endif
+
+/****************************************************************************
+ * Name: tcp_ipv6_fold
+ *
+ * Description:
+ *   Fold an IPv6 address into 32 bits for hashing.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_TCP_HASH) && defined(CONFIG_NET_IPv6)
+static inline uint32_t tcp_ipv6_fold(FAR const uint16_t *addr)
+{
+  return ((uint32_t)(addr[0] ^ addr[2] ^ addr[4] ^ addr[6]) << 16) |
+         (uint32_t)(addr[1] ^ addr[3] ^ addr[5] ^ addr[7]);
+}
+#endif
+
+/****************************************************************************
+ * Name: tcp_hash_insert and tcp_hash_remove
+ *
+ * Description:
+ *   Add a connection to (remove a connection from) the hash table of
+ *   active connections.  The local port, remote port and remote address of
+ *   the connection must not change while it is in the hash table.
+ *
+ * Assumptions:
+ *   This function is called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_HASH
+static unsigned int tcp_hash_conn(FAR struct tcp_conn_s *conn)
+{
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  if (conn->domain == PF_INET)
+#endif
+    {
+      return tcp_hash(conn->lport, conn->rport, conn->u.ipv4.raddr);
+    }
+#endif /* CONFIG_NET_IPv4 */
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  else
+#endif
+    {
+      return tcp_hash(conn->lport, conn->rport,
+                      tcp_ipv6_fold(conn->u.ipv6.raddr));
+    }
+#endif /* CONFIG_NET_IPv6 */
+}
+
+static void tcp_hash_insert(FAR struct tcp_conn_s *conn)
+{
+  unsigned int ndx = tcp_hash_conn(conn);
+
+  conn->hnext     = g_tcp_hash[ndx];
+  g_tcp_hash[ndx] = conn;
+}
+
+static void tcp_hash_remove(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_conn_s **pprev;
+
+  for (pprev = &g_tcp_hash[tcp_hash_conn(conn)];
+       *pprev != NULL;
+       pprev = &(*pprev)->hnext)
+    {
+      if (*pprev == conn)
+        {
+          *pprev = conn->hnext;
+          break;
+        }
+    }
+
+  conn->hnext = NULL;
+}
+#endif /* CONFIG_NET_TCP_HASH */
+
 /****************************************************************************
  * Name: tcp_ipv4_listener
  *
@@ -327,12 +440,21 @@ static inline FAR struct tcp_conn_s *
   in_addr_t srcipaddr;
   in_addr_t destipaddr;
 
-  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
   srcipaddr  = net_ip4addr_conv32(ip->srcipaddr);
   destipaddr = net_ip4addr_conv32(ip->destipaddr);
 
+#ifdef CONFIG_NET_TCP_HASH
+  conn = g_tcp_hash[tcp_hash(tcp->destport, tcp->srcport, srcipaddr)];
+#else
+  conn = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
+#endif
+
   while (conn)
     {
+#ifdef CONFIG_NET_STATISTICS
+      g_netstats.tcp.probe++;
+#endif
+
       /* Find an open connection matching the TCP input. The following
        * checks are performed:
        *
@@ -366,7 +488,11 @@ static inline FAR struct tcp_conn_s *
 
       /* Look at the next active connection */
 
+#ifdef CONFIG_NET_TCP_HASH
+      conn = conn->hnext;
+#else
       conn = (FAR struct tcp_conn_s *)conn->node.flink;
+#endif
     }
 
   return conn;
@@ -394,12 +520,22 @@ static inline FAR struct tcp_conn_s *
   net_ipv6addr_t *srcipaddr;
   net_ipv6addr_t *destipaddr;
 
-  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
   srcipaddr  = (net_ipv6addr_t *)ip->srcipaddr;
   destipaddr = (net_ipv6addr_t *)ip->destipaddr;
 
+#ifdef CONFIG_NET_TCP_HASH
+  conn = g_tcp_hash[tcp_hash(tcp->destport, tcp->srcport,
+                             tcp_ipv6_fold(*srcipaddr))];
+#else
+  conn = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
+#endif
+
   while (conn)
     {
+#ifdef CONFIG_NET_STATISTICS
+      g_netstats.tcp.probe++;
+#endif
+
       /* Find an open connection matching the TCP input. The following
        * checks are performed:
        *
@@ -433,7 +569,11 @@ static inline FAR struct tcp_conn_s *
 
       /* Look at the next active connection */
 
+#ifdef CONFIG_NET_TCP_HASH
+      conn = conn->hnext;
+#else
       conn = (FAR struct tcp_conn_s *)conn->node.flink;
+#endif
     }
 
   return conn;
@@ -772,6 +912,9 @@ void tcp_free(FAR struct tcp_conn_s *conn)
       /* Remove the connection from the active list */
 
       dq_rem(&conn->node, &g_active_tcp_connections);
+#ifdef CONFIG_NET_TCP_HASH
+      tcp_hash_remove(conn);
+#endif
     }
 
 #ifdef CONFIG_NET_TCP_READAHEAD
@@ -834,6 +977,10 @@ void tcp_free(FAR struct tcp_conn_s *conn)
 FAR struct tcp_conn_s *tcp_active(FAR struct net_driver_s *dev,
                                   FAR struct tcp_hdr_s *tcp)
 {
+#ifdef CONFIG_NET_STATISTICS
+  g_netstats.tcp.lookup++;
+#endif
+
 #ifdef CONFIG_NET_IPv6
 #ifdef CONFIG_NET_IPv4
   if (IFF_IS_IPv6(dev->d_flags))
@@ -1035,6 +1182,9 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
        */
 
       dq_addlast(&conn->node, &g_active_tcp_connections);
+#ifdef CONFIG_NET_TCP_HASH
+      tcp_hash_insert(conn);
+#endif
     }
 
   return conn;
@@ -1270,6 +1420,9 @@ int tcp_connect(FAR struct tcp_conn_s *conn, FAR const struct sockaddr *addr)
   /* And, finally, put the connection structure into the active list. */
 
   dq_addlast(&conn->node, &g_active_tcp_connections);
+#ifdef CONFIG_NET_TCP_HASH
+  tcp_hash_insert(conn);
+#endif
   ret = OK;
 
 errout_with_lock:
@@ -54,6 +54,15 @@
 #include "devif/devif.h"
 #include "tcp/tcp.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_HASH
+#  define TCP_LISTENHASH(p) \
+     (((p) ^ ((p) >> 8)) & (CONFIG_NET_TCP_HASHSIZE - 1))
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -62,6 +71,12 @@
 
 static FAR struct tcp_conn_s *tcp_listenports[CONFIG_NET_MAX_LISTENPORTS];
 
+#ifdef CONFIG_NET_TCP_HASH
+/* The same listeners hashed by local port number */
+
+static FAR struct tcp_conn_s *g_tcp_listenhash[CONFIG_NET_TCP_HASHSIZE];
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -83,6 +98,26 @@ FAR struct tcp_conn_s *tcp_findlistener(uint16_t portno, uint8_t domain)
 FAR struct tcp_conn_s *tcp_findlistener(uint16_t portno)
 #endif
 {
+#ifdef CONFIG_NET_TCP_HASH
+  FAR struct tcp_conn_s *conn;
+
+  /* Examine each listener that hashes to this port */
+
+  for (conn = g_tcp_listenhash[TCP_LISTENHASH(portno)];
+       conn != NULL;
+       conn = conn->lnext)
+    {
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+      if (conn->lport == portno && conn->domain == domain)
+#else
+      if (conn->lport == portno)
+#endif
+        {
+          return conn;
+        }
+    }
+
+#else
   int ndx;
 
   /* Examine each connection structure in each slot of the listener list */
@@ -105,6 +140,7 @@ FAR struct tcp_conn_s *tcp_findlistener(uint16_t portno)
           return conn;
         }
     }
+#endif /* CONFIG_NET_TCP_HASH */
 
   /* No listener for this port */
 
@@ -134,6 +170,13 @@ void tcp_listen_initialize(void)
     {
       tcp_listenports[ndx] = NULL;
     }
+
+#ifdef CONFIG_NET_TCP_HASH
+  for (ndx = 0; ndx < CONFIG_NET_TCP_HASHSIZE; ndx++)
+    {
+      g_tcp_listenhash[ndx] = NULL;
+    }
+#endif
 }
 
 /****************************************************************************
@@ -163,6 +206,26 @@ int tcp_unlisten(FAR struct tcp_conn_s *conn)
         }
     }
 
+#ifdef CONFIG_NET_TCP_HASH
+  if (ret == OK)
+    {
+      FAR struct tcp_conn_s **pprev;
+
+      for (pprev = &g_tcp_listenhash[TCP_LISTENHASH(conn->lport)];
+           *pprev != NULL;
+           pprev = &(*pprev)->lnext)
+        {
+          if (*pprev == conn)
+            {
+              *pprev = conn->lnext;
+              break;
+            }
+        }
+
+      conn->lnext = NULL;
+    }
+#endif
+
   net_unlock();
   return ret;
 }
@@ -220,6 +283,10 @@ int tcp_listen(FAR struct tcp_conn_s *conn)
               /* Yes.. we found it */
 
               tcp_listenports[ndx] = conn;
+#ifdef CONFIG_NET_TCP_HASH
+              conn->lnext = g_tcp_listenhash[TCP_LISTENHASH(conn->lport)];
+              g_tcp_listenhash[TCP_LISTENHASH(conn->lport)] = conn;
+#endif
               ret = OK;
               break;
             }
@@ -52,6 +52,7 @@
 
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 
 #include <stdint.h>
 #include <stdbool.h>
@@ -957,16 +958,17 @@ static inline void send_txnotify(FAR struct socket *psock,
  ****************************************************************************/
 
 /****************************************************************************
- * Name: psock_tcp_send
+ * Name: psock_tcp_sendv
  *
  * Description:
- *   psock_tcp_send() call may be used only when the TCP socket is in a
- *   connected state (so that the intended recipient is known).
+ *   psock_tcp_sendv() call may be used only when the TCP socket is in a
+ *   connected state (so that the intended recipient is known).  The data
+ *   from all of the buffers is copied into one write buffer.
  *
  * Input Parameters:
  *   psock    An instance of the internal socket structure.
- *   buf      Data to send
- *   len      Length of data to send
+ *   iov      Array of buffers containing the data to send
+ *   iovcnt   Number of elements in iov[]
  *
  * Returned Value:
  *   On success, returns the number of characters sent.  On  error,
@@ -1011,13 +1013,22 @@ static inline void send_txnotify(FAR struct socket *psock,
  *
  ****************************************************************************/
 
-ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
-                       size_t len)
+ssize_t psock_tcp_sendv(FAR struct socket *psock, FAR const struct iovec *iov,
+                        int iovcnt)
 {
   FAR struct tcp_conn_s *conn;
   FAR struct tcp_wrbuffer_s *wrb;
   ssize_t    result = 0;
+  size_t     len;
   int        ret = OK;
+  int        i;
+
+  /* Get the total size of the data to be sent */
+
+  for (i = 0, len = 0; i < iovcnt; i++)
+    {
+      len += iov[i].iov_len;
+    }
 
   if (psock == NULL || psock->s_crefs <= 0)
     {
@@ -1071,9 +1082,14 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
     }
 #endif /* CONFIG_NET_ARP_SEND || CONFIG_NET_ICMPv6_NEIGHBOR */
 
-  /* Dump the incoming buffer */
+  /* Dump the incoming buffers */
 
-  BUF_DUMP("psock_tcp_send", buf, len);
+#ifdef CONFIG_NET_TCP_WRBUFFER_DUMP
+  for (i = 0; i < iovcnt; i++)
+    {
+      BUF_DUMP("psock_tcp_sendv", iov[i].iov_base, iov[i].iov_len);
+    }
+#endif
 
   /* Set the socket state to sending */
 
@@ -1134,43 +1150,62 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
       TCP_WBSEQNO(wrb) = (unsigned)-1;
       TCP_WBNRTX(wrb)  = 0;
 
-      /* Copy the user data into the write buffer.  We cannot wait for
-       * buffer space if the socket was opened non-blocking.
+      /* Copy the user data into the write buffer, appending each buffer
+       * to the I/O buffer chain.  We cannot wait for buffer space if the
+       * socket was opened non-blocking.
        */
 
-      if (_SS_ISNONBLOCK(psock->s_flags))
+      for (i = 0; i < iovcnt && result >= 0; i++)
         {
-          /* The return value from TCP_WBTRYCOPYIN is either OK or
-           * -ENOMEM if less than the entire data chunk could be allocated.
-           * If -ENOMEM is returned, check if at least a part of the data
-           * chunk was allocated. If more than zero bytes were sent
-           * we return that number and let the caller deal with sending the
-           * remaining data.
-           */
+          if (iov[i].iov_len == 0)
+            {
+              continue;
+            }
 
-          result = TCP_WBTRYCOPYIN(wrb, (FAR uint8_t *)buf, len);
-          if (result == -ENOMEM)
+          if (_SS_ISNONBLOCK(psock->s_flags))
             {
-              if (TCP_WBPKTLEN(wrb) > 0)
-                {
-                  ninfo("INFO: Allocated part of the requested data\n");
-                  result = TCP_WBPKTLEN(wrb);
-                }
-              else
+              /* The return value from TCP_WBTRYCOPYIN is either OK or
+               * -ENOMEM if less than the entire data chunk could be
+               * allocated.  If -ENOMEM is returned, check if at least a
+               * part of the data was allocated. If more than zero bytes
+               * were sent we return that number and let the caller deal
+               * with sending the remaining data.
+               */
+
+              ret = TCP_WBTRYCOPYIN(wrb, (FAR uint8_t *)iov[i].iov_base,
+                                    iov[i].iov_len, result);
+              if (ret == -ENOMEM)
                 {
-                  nerr("ERROR: Failed to add data to the I/O buffer chain\n");
-                  ret = -EWOULDBLOCK;
-                  goto errout_with_wrb;
+                  if (TCP_WBPKTLEN(wrb) > 0)
+                    {
+                      ninfo("INFO: Allocated part of the requested data\n");
+                      result = TCP_WBPKTLEN(wrb);
+                      ret    = OK;
+                      break;
+                    }
+                  else
+                    {
+                      nerr("ERROR: Failed to add data to the I/O buffer "
+                           "chain\n");
+                      ret = -EWOULDBLOCK;
+                      goto errout_with_wrb;
+                    }
                 }
             }
           else
             {
-              result = len;
+              ret = TCP_WBCOPYIN(wrb, (FAR uint8_t *)iov[i].iov_base,
+                                 iov[i].iov_len, result);
+            }
+
+          if (ret < 0)
+            {
+              result = ret;
+            }
+          else
+            {
+              result += ret;
             }
-        }
-      else
-        {
-          result = TCP_WBCOPYIN(wrb, (FAR uint8_t *)buf, len);
         }
 
       /* Dump I/O buffer chain */
@@ -1230,6 +1265,33 @@ errout:
   return ret;
 }
 
+/****************************************************************************
+ * Name: psock_tcp_send
+ *
+ * Description:
+ *   psock_tcp_send() call may be used only when the TCP socket is in a
+ *   connected state (so that the intended recipient is known).
+ *
+ * Input Parameters:
+ *   psock    An instance of the internal socket structure.
+ *   buf      Data to send
+ *   len      Length of data to send
+ *
+ * Returned Value:
+ *   See psock_tcp_sendv().
+ *
+ ****************************************************************************/
+
+ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
+                       size_t len)
+{
+  struct iovec iov;
+
+  iov.iov_base = (FAR void *)buf;
+  iov.iov_len  = len;
+  return psock_tcp_sendv(psock, &iov, 1);
+}
+
 /****************************************************************************
  * Name: psock_tcp_cansend
  *
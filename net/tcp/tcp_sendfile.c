@@ -42,6 +42,7 @@
 #include <nuttx/config.h>
 
 #include <sys/stat.h>
+#include <sys/statfs.h>
 #include <sys/types.h>
 #include <sys/socket.h>
 
@@ -58,6 +59,7 @@
 #include <nuttx/clock.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/arp.h>
@@ -99,6 +101,7 @@ struct sendfile_s
   FAR struct devif_callback_s *snd_datacb; /* Data callback */
   FAR struct devif_callback_s *snd_ackcb;  /* ACK callback */
   FAR struct file   *snd_file;    /* File structure of the input file */
+  FAR const uint8_t *snd_map;     /* File data in memory (NULL if none) */
   sem_t              snd_sem;     /* Used to wake up the waiting thread */
   off_t              snd_foffset; /* Input file offset */
   size_t             snd_flen;    /* File length */
@@ -416,23 +419,38 @@ static uint16_t sendfile_eventhandler(FAR struct net_driver_s *dev,
 
           /* Then set-up to send that amount of data. (this won't actually
            * happen until the polling cycle completes).
+           *
+           * If the file data is in memory, it is copied straight into the
+           * packet buffer.  Otherwise, it must be read from the file.
            */
 
-          ret = file_seek(pstate->snd_file,
-                          pstate->snd_foffset + pstate->snd_sent, SEEK_SET);
-          if (ret < 0)
+          if (pstate->snd_map != NULL)
             {
-              nerr("ERROR: Failed to lseek: %d\n", ret);
-              pstate->snd_sent = ret;
-              goto end_wait;
+              memcpy(dev->d_appdata,
+                     pstate->snd_map + pstate->snd_foffset + pstate->snd_sent,
+                     sndlen);
+              ret = sndlen;
             }
-
-          ret = file_read(pstate->snd_file, dev->d_appdata, sndlen);
-          if (ret < 0)
+          else
             {
-              nerr("ERROR: Failed to read from input file: %d\n", (int)ret);
-              pstate->snd_sent = ret;
-              goto end_wait;
+              ret = file_seek(pstate->snd_file,
+                              pstate->snd_foffset + pstate->snd_sent,
+                              SEEK_SET);
+              if (ret < 0)
+                {
+                  nerr("ERROR: Failed to lseek: %d\n", ret);
+                  pstate->snd_sent = ret;
+                  goto end_wait;
+                }
+
+              ret = file_read(pstate->snd_file, dev->d_appdata, sndlen);
+              if (ret < 0)
+                {
+                  nerr("ERROR: Failed to read from input file: %d\n",
+                       (int)ret);
+                  pstate->snd_sent = ret;
+                  goto end_wait;
+                }
             }
 
           dev->d_sndlen = sndlen;
@@ -509,6 +527,94 @@ wait:
   return flags;
 }
 
+/****************************************************************************
+ * Name: sendfile_map
+ *
+ * Description:
+ *   Get the address of the file data in memory.  This is possible when the
+ *   file system supports the FIOC_MMAP ioctl (as, for example, ROMFS does
+ *   for XIP media).  The data can then be copied directly into the packet
+ *   buffer for each segment and for each retransmission instead of seeking
+ *   and reading the file.
+ *
+ *   The address is used for the whole send, so the data must not move or
+ *   be freed while the file is open.  That is only true of read-only file
+ *   systems.  tmpfs, for example, also supports FIOC_MMAP but reallocates
+ *   the file data when the file is written or truncated.
+ *
+ * Input Parameters:
+ *   pstate - send state structure
+ *
+ * Returned Value:
+ *   None.  snd_map is left NULL if the file data cannot be accessed in
+ *   memory.  Otherwise, snd_flen is reduced so that it does not extend
+ *   beyond the end of the file.
+ *
+ ****************************************************************************/
+
+static void sendfile_map(FAR struct sendfile_s *pstate)
+{
+#ifndef CONFIG_DISABLE_MOUNTPOINT
+  FAR struct inode *inode = pstate->snd_file->f_inode;
+  FAR void *addr = NULL;
+  struct statfs buf;
+  off_t filesize;
+  off_t pos;
+  int ret;
+
+  /* Only ROMFS file data is known to be immutable */
+
+  if (inode == NULL || !INODE_IS_MOUNTPT(inode) ||
+      inode->u.i_mops == NULL || inode->u.i_mops->statfs == NULL)
+    {
+      return;
+    }
+
+  ret = inode->u.i_mops->statfs(inode, &buf);
+  if (ret < 0 || buf.f_type != ROMFS_MAGIC)
+    {
+      return;
+    }
+
+  ret = file_ioctl(pstate->snd_file, FIOC_MMAP,
+                   (unsigned long)((uintptr_t)&addr));
+  if (ret < 0 || addr == NULL)
+    {
+      return;
+    }
+
+  /* The mapped region ends at the end of the file.  Find the size of the
+   * file by seeking to its end, then put the file position back where it
+   * was so that failing to send leaves the file untouched.
+   */
+
+  pos = file_seek(pstate->snd_file, 0, SEEK_CUR);
+  if (pos < 0)
+    {
+      return;
+    }
+
+  filesize = file_seek(pstate->snd_file, 0, SEEK_END);
+  (void)file_seek(pstate->snd_file, pos, SEEK_SET);
+
+  if (filesize < 0)
+    {
+      return;
+    }
+
+  if (pstate->snd_foffset >= filesize)
+    {
+      pstate->snd_flen = 0;
+    }
+  else if ((off_t)pstate->snd_flen > filesize - pstate->snd_foffset)
+    {
+      pstate->snd_flen = filesize - pstate->snd_foffset;
+    }
+
+  pstate->snd_map = (FAR const uint8_t *)addr;
+#endif
+}
+
 /****************************************************************************
  * Name: sendfile_txnotify
  *
@@ -585,7 +691,7 @@ ssize_t tcp_sendfile(FAR struct socket *psock, FAR struct file *infile,
 {
   FAR struct tcp_conn_s *conn;
   struct sendfile_s state;
-  int ret;
+  int ret = OK;
 
   /* If this is an un-connected socket, then return ENOTCONN */
 
@@ -655,6 +761,10 @@ ssize_t tcp_sendfile(FAR struct socket *psock, FAR struct file *infile,
   state.snd_flen    = count;                /* Number of bytes to send */
   state.snd_file    = infile;               /* File to read from */
 
+  /* Use the file data in place if it is in memory */
+
+  sendfile_map(&state);
+
   /* Allocate resources to receive a callback */
 
   state.snd_datacb = tcp_callback_alloc(conn);
@@ -662,7 +772,7 @@ ssize_t tcp_sendfile(FAR struct socket *psock, FAR struct file *infile,
   if (state.snd_datacb == NULL)
     {
       nerr("ERROR: Failed to allocate data callback\n");
-      ret =- ENOMEM;
+      ret = -ENOMEM;
       goto errout_locked;
     }
 
@@ -716,6 +826,15 @@ ssize_t tcp_sendfile(FAR struct socket *psock, FAR struct file *infile,
 
   psock->s_flags = _SS_SETSTATE(psock->s_flags, _SF_IDLE);
 
+  /* Leave the file position after the data that was sent, as the read
+   * path does.
+   */
+
+  if (state.snd_map != NULL && state.snd_sent >= 0)
+    {
+      (void)file_seek(infile, state.snd_foffset + state.snd_sent, SEEK_SET);
+    }
+
   tcp_callback_free(conn, state.snd_ackcb);
 
 errout_datacb:
@@ -723,7 +842,7 @@ errout_datacb:
 
 errout_locked:
 
-  nxsem_destroy(&state. snd_sem);
+  nxsem_destroy(&state.snd_sem);
   net_unlock();
 
 errout:
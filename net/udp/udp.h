@@ -104,6 +104,9 @@ struct udp_conn_s
   uint8_t  domain;        /* IP domain: PF_INET or PF_INET6 */
   uint8_t  ttl;           /* Default time-to-live */
   uint8_t  crefs;         /* Reference counts on this instance */
+#ifdef CONFIG_NET_UDP_HASH
+  FAR struct udp_conn_s *hnext; /* Next bound connection in the bucket */
+#endif
 
 #ifdef CONFIG_NET_UDP_READAHEAD
   /* Read-ahead buffering.
@@ -594,6 +597,26 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
                          size_t len, int flags, FAR const struct sockaddr *to,
                          socklen_t tolen);
 
+/****************************************************************************
+ * Name: psock_udp_sendv and psock_udp_sendtov
+ *
+ * Description:
+ *   Like psock_udp_send() and psock_udp_sendto() except that the data is
+ *   gathered from the iovcnt buffers described by iov into a single
+ *   datagram.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_WRITE_BUFFERS
+struct iovec;
+ssize_t psock_udp_sendv(FAR struct socket *psock,
+                        FAR const struct iovec *iov, int iovcnt);
+ssize_t psock_udp_sendtov(FAR struct socket *psock,
+                          FAR const struct iovec *iov, int iovcnt,
+                          int flags, FAR const struct sockaddr *to,
+                          socklen_t tolen);
+#endif
+
 /****************************************************************************
  * Name: udp_pollsetup
  *
@@ -60,6 +60,7 @@
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/ip.h>
 #include <nuttx/net/udp.h>
+#include <nuttx/net/netstats.h>
 
 #include "devif/devif.h"
 #include "netdev/netdev.h"
@@ -73,6 +74,10 @@
 #define IPv4BUF ((struct ipv4_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
 #define IPv6BUF ((struct ipv6_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
 
+#ifdef CONFIG_NET_UDP_HASH
+#  define UDP_HASH(p) (((p) ^ ((p) >> 8)) & (CONFIG_NET_UDP_HASHSIZE - 1))
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -90,6 +95,12 @@ static sem_t g_free_sem;
 
 static dq_queue_t g_active_udp_connections;
 
+#ifdef CONFIG_NET_UDP_HASH
+/* The bound UDP connections hashed by local port number */
+
+static FAR struct udp_conn_s *g_udp_hash[CONFIG_NET_UDP_HASHSIZE];
+#endif
+
 /* Last port used by a UDP connection connection. */
 
 static uint16_t g_last_udp_port;
@@ -98,6 +109,51 @@ static uint16_t g_last_udp_port;
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: udp_setport
+ *
+ * Description:
+ *   Set the local port number of a connection, moving the connection to
+ *   the matching hash bucket.  A port number of zero unbinds the
+ *   connection.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_HASH
+static void udp_setport(FAR struct udp_conn_s *conn, uint16_t portno)
+{
+  FAR struct udp_conn_s **pprev;
+
+  net_lock();
+  if (conn->lport != 0)
+    {
+      for (pprev = &g_udp_hash[UDP_HASH(conn->lport)];
+           *pprev != NULL;
+           pprev = &(*pprev)->hnext)
+        {
+          if (*pprev == conn)
+            {
+              *pprev = conn->hnext;
+              break;
+            }
+        }
+
+      conn->hnext = NULL;
+    }
+
+  conn->lport = portno;
+  if (portno != 0)
+    {
+      conn->hnext                  = g_udp_hash[UDP_HASH(portno)];
+      g_udp_hash[UDP_HASH(portno)] = conn;
+    }
+
+  net_unlock();
+}
+#else
+#  define udp_setport(c,p) do { (c)->lport = (p); } while (0)
+#endif
+
 /****************************************************************************
  * Name: _udp_semtake() and _udp_semgive()
  *
@@ -266,9 +322,18 @@ static inline FAR struct udp_conn_s *
   FAR struct ipv4_hdr_s *ip = IPv4BUF;
   FAR struct udp_conn_s *conn;
 
+#ifdef CONFIG_NET_UDP_HASH
+  conn = g_udp_hash[UDP_HASH(udp->destport)];
+#else
   conn = (FAR struct udp_conn_s *)g_active_udp_connections.head;
+#endif
+
   while (conn)
     {
+#ifdef CONFIG_NET_STATISTICS
+      g_netstats.udp.probe++;
+#endif
+
       /* If the local UDP port is non-zero, the connection is considered
        * to be used. If so, then the following checks are performed:
        *
@@ -329,7 +394,11 @@ static inline FAR struct udp_conn_s *
 
       /* Look at the next active connection */
 
+#ifdef CONFIG_NET_UDP_HASH
+      conn = conn->hnext;
+#else
       conn = (FAR struct udp_conn_s *)conn->node.flink;
+#endif
     }
 
   return conn;
@@ -355,9 +424,18 @@ static inline FAR struct udp_conn_s *
   FAR struct ipv6_hdr_s *ip = IPv6BUF;
   FAR struct udp_conn_s *conn;
 
+#ifdef CONFIG_NET_UDP_HASH
+  conn = g_udp_hash[UDP_HASH(udp->destport)];
+#else
   conn = (FAR struct udp_conn_s *)g_active_udp_connections.head;
+#endif
+
   while (conn)
     {
+#ifdef CONFIG_NET_STATISTICS
+      g_netstats.udp.probe++;
+#endif
+
       /* If the local UDP port is non-zero, the connection is considered
        * to be used. If so, then the following checks are performed:
        *
@@ -418,7 +496,11 @@ static inline FAR struct udp_conn_s *
 
       /* Look at the next active connection */
 
+#ifdef CONFIG_NET_UDP_HASH
+      conn = conn->hnext;
+#else
       conn = (FAR struct udp_conn_s *)conn->node.flink;
+#endif
     }
 
   return conn;
@@ -520,7 +602,7 @@ void udp_free(FAR struct udp_conn_s *conn)
   DEBUGASSERT(conn->crefs == 0);
 
   _udp_semtake(&g_free_sem);
-  conn->lport = 0;
+  udp_setport(conn, 0);
 
   /* Remove the connection from the active list */
 
@@ -562,6 +644,10 @@ void udp_free(FAR struct udp_conn_s *conn)
 FAR struct udp_conn_s *udp_active(FAR struct net_driver_s *dev,
                                   FAR struct udp_hdr_s *udp)
 {
+#ifdef CONFIG_NET_STATISTICS
+  g_netstats.udp.lookup++;
+#endif
+
 #ifdef CONFIG_NET_IPv6
 #ifdef CONFIG_NET_IPv4
   if (IFF_IS_IPv6(dev->d_flags))
@@ -669,8 +755,8 @@ int udp_bind(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
     {
       /* Yes.. Select any unused local port number */
 
-      conn->lport = htons(udp_select_port(conn->domain, &conn->u));
-      ret         = OK;
+      udp_setport(conn, htons(udp_select_port(conn->domain, &conn->u)));
+      ret = OK;
     }
   else
     {
@@ -684,7 +770,7 @@ int udp_bind(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
         {
           /* No.. then bind the socket to the port */
 
-          conn->lport = portno;
+          udp_setport(conn, portno);
           ret         = OK;
         }
       else
@@ -735,7 +821,7 @@ int udp_connect(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
        * connection structure.
        */
 
-      conn->lport = htons(udp_select_port(conn->domain, &conn->u));
+      udp_setport(conn, htons(udp_select_port(conn->domain, &conn->u)));
     }
 
   /* Is there a remote port (rport)? */
@@ -43,6 +43,7 @@
 #include <poll.h>
 #include <debug.h>
 
+#include <nuttx/fs/fs.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/net/net.h>
 
@@ -134,7 +135,7 @@ static uint16_t udp_poll_eventhandler(FAR struct net_driver_s *dev,
       if (eventset)
         {
           info->fds->revents |= eventset;
-          nxsem_post(info->fds->sem);
+          poll_notify(info->fds);
         }
     }
 
@@ -263,7 +264,7 @@ int udp_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
   if (fds->revents != 0)
     {
       /* Yes.. then signal the poll logic */
-      nxsem_post(fds->sem);
+      poll_notify(fds);
     }
 
   net_unlock();
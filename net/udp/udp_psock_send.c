@@ -40,6 +40,7 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <string.h>
 #include <assert.h>
 #include <errno.h>
@@ -50,31 +51,40 @@
 #include "udp/udp.h"
 
 /****************************************************************************
- * Public Functions
+ * Private Types
+ ****************************************************************************/
+
+union udp_sockaddr_u
+{
+  struct sockaddr     addr;
+#ifdef CONFIG_NET_IPv4
+  struct sockaddr_in  addr4;
+#endif
+#ifdef CONFIG_NET_IPv6
+  struct sockaddr_in6 addr6;
+#endif
+};
+
+/****************************************************************************
+ * Private Functions
  ****************************************************************************/
 
 /****************************************************************************
- * Name: psock_udp_send
+ * Name: udp_peeraddr
  *
  * Description:
- *   Implements send() for connected UDP sockets
+ *   Get the address of the peer of a connected UDP socket.
+ *
+ * Returned Value:
+ *   The size of the address on success; -ENOTCONN if the socket is not
+ *   connected.
  *
  ****************************************************************************/
 
-ssize_t psock_udp_send(FAR struct socket *psock, FAR const void *buf,
-                       size_t len)
+static int udp_peeraddr(FAR struct socket *psock,
+                        FAR union udp_sockaddr_u *to)
 {
   FAR struct udp_conn_s *conn;
-  union
-  {
-    struct sockaddr     addr;
-#ifdef CONFIG_NET_IPv4
-    struct sockaddr_in  addr4;
-#endif
-#ifdef CONFIG_NET_IPv6
-    struct sockaddr_in6 addr6;
-#endif
-  } to;
   socklen_t tolen;
 
   DEBUGASSERT(psock != NULL && psock->s_crefs > 0);
@@ -92,17 +102,15 @@ ssize_t psock_udp_send(FAR struct socket *psock, FAR const void *buf,
       return -ENOTCONN;
     }
 
-  /* Yes, then let psock_sendto to the work */
-
 #ifdef CONFIG_NET_IPv4
 #ifdef CONFIG_NET_IPv6
   if (conn->domain == PF_INET)
 #endif
     {
-      tolen               = sizeof(struct sockaddr_in);
-      to.addr4.sin_family = AF_INET;
-      to.addr4.sin_port   = conn->rport;
-      net_ipv4addr_copy(to.addr4.sin_addr.s_addr, conn->u.ipv4.raddr);
+      tolen                = sizeof(struct sockaddr_in);
+      to->addr4.sin_family = AF_INET;
+      to->addr4.sin_port   = conn->rport;
+      net_ipv4addr_copy(to->addr4.sin_addr.s_addr, conn->u.ipv4.raddr);
     }
 #endif /* CONFIG_NET_IPv4 */
 
@@ -111,12 +119,67 @@ ssize_t psock_udp_send(FAR struct socket *psock, FAR const void *buf,
   else
 #endif
     {
-      tolen               = sizeof(struct sockaddr_in6);
-      to.addr6.sin6_family = AF_INET6;
-      to.addr6.sin6_port   = conn->rport;
-      net_ipv6addr_copy(to.addr6.sin6_addr.s6_addr, conn->u.ipv6.raddr);
+      tolen                 = sizeof(struct sockaddr_in6);
+      to->addr6.sin6_family = AF_INET6;
+      to->addr6.sin6_port   = conn->rport;
+      net_ipv6addr_copy(to->addr6.sin6_addr.s6_addr, conn->u.ipv6.raddr);
     }
 #endif /* CONFIG_NET_IPv6 */
 
+  return (int)tolen;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: psock_udp_send
+ *
+ * Description:
+ *   Implements send() for connected UDP sockets
+ *
+ ****************************************************************************/
+
+ssize_t psock_udp_send(FAR struct socket *psock, FAR const void *buf,
+                       size_t len)
+{
+  union udp_sockaddr_u to;
+  int tolen;
+
+  /* Get the peer address and let psock_udp_sendto() do the work */
+
+  tolen = udp_peeraddr(psock, &to);
+  if (tolen < 0)
+    {
+      return tolen;
+    }
+
   return psock_udp_sendto(psock, buf, len, 0, &to.addr, tolen);
 }
+
+/****************************************************************************
+ * Name: psock_udp_sendv
+ *
+ * Description:
+ *   Implements a gathered send for connected UDP sockets.  All of the
+ *   buffers are sent as a single datagram.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_WRITE_BUFFERS
+ssize_t psock_udp_sendv(FAR struct socket *psock,
+                        FAR const struct iovec *iov, int iovcnt)
+{
+  union udp_sockaddr_u to;
+  int tolen;
+
+  tolen = udp_peeraddr(psock, &to);
+  if (tolen < 0)
+    {
+      return tolen;
+    }
+
+  return psock_udp_sendtov(psock, iov, iovcnt, 0, &to.addr, tolen);
+}
+#endif
@@ -51,6 +51,7 @@
 
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 
 #include <stdint.h>
 #include <stdbool.h>
@@ -587,16 +588,17 @@ static uint16_t sendto_eventhandler(FAR struct net_driver_s *dev,
  ****************************************************************************/
 
 /****************************************************************************
- * Name: psock_udp_sendto
+ * Name: psock_udp_sendtov
  *
  * Description:
  *   This function implements the UDP-specific logic of the standard
- *   sendto() socket operation.
+ *   sendto() socket operation.  The data from all of the buffers is
+ *   gathered into a single datagram.
  *
  * Input Parameters:
  *   psock    A pointer to a NuttX-specific, internal socket structure
- *   buf      Data to send
- *   len      Length of data to send
+ *   iov      Array of buffers containing the data to send
+ *   iovcnt   Number of elements in iov[]
  *   flags    Send flags
  *   to       Address of recipient
  *   tolen    The length of the address structure
@@ -611,13 +613,24 @@ static uint16_t sendto_eventhandler(FAR struct net_driver_s *dev,
  *
  ****************************************************************************/
 
-ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
-                         size_t len, int flags, FAR const struct sockaddr *to,
-                         socklen_t tolen)
+ssize_t psock_udp_sendtov(FAR struct socket *psock,
+                          FAR const struct iovec *iov, int iovcnt,
+                          int flags, FAR const struct sockaddr *to,
+                          socklen_t tolen)
 {
   FAR struct udp_conn_s *conn;
   FAR struct udp_wrbuffer_s *wrb;
+  size_t len;
+  size_t offset;
   int ret = OK;
+  int i;
+
+  /* Get the total size of the datagram */
+
+  for (i = 0, len = 0; i < iovcnt; i++)
+    {
+      len += iov[i].iov_len;
+    }
 
   /* Make sure that we have the IP address mapping */
 
@@ -656,9 +669,14 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
     }
 #endif /* CONFIG_NET_ARP_SEND || CONFIG_NET_ICMPv6_NEIGHBOR */
 
-  /* Dump the incoming buffer */
+  /* Dump the incoming buffers */
 
-  BUF_DUMP("psock_udp_send", buf, len);
+#ifdef CONFIG_NET_UDP_WRBUFFER_DUMP
+  for (i = 0; i < iovcnt; i++)
+    {
+      BUF_DUMP("psock_udp_sendtov", iov[i].iov_base, iov[i].iov_len);
+    }
+#endif
 
   /* Set the socket state to sending */
 
@@ -688,22 +706,36 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
       wrb->wb_start = clock_systimer();
 #endif
 
-      /* Copy the user data into the write buffer.  We cannot wait for
-       * buffer space if the socket was opened non-blocking.
+      /* Copy the user data into the write buffer, gathering all of the
+       * buffers into one datagram.  We cannot wait for buffer space if the
+       * socket was opened non-blocking.
        */
 
-      if (_SS_ISNONBLOCK(psock->s_flags))
-        {
-          ret = iob_trycopyin(wrb->wb_iob, (FAR uint8_t *)buf, len, 0, false);
-        }
-      else
-        {
-          ret = iob_copyin(wrb->wb_iob, (FAR uint8_t *)buf, len, 0, false);
-        }
-
-      if (ret < 0)
+      for (i = 0, offset = 0; i < iovcnt; i++)
         {
-          goto errout_with_wrb;
+          if (iov[i].iov_len == 0)
+            {
+              continue;
+            }
+
+          if (_SS_ISNONBLOCK(psock->s_flags))
+            {
+              ret = iob_trycopyin(wrb->wb_iob,
+                                  (FAR uint8_t *)iov[i].iov_base,
+                                  iov[i].iov_len, offset, false);
+            }
+          else
+            {
+              ret = iob_copyin(wrb->wb_iob, (FAR uint8_t *)iov[i].iov_base,
+                               iov[i].iov_len, offset, false);
+            }
+
+          if (ret < 0)
+            {
+              goto errout_with_wrb;
+            }
+
+          offset += iov[i].iov_len;
         }
 
       /* Dump I/O buffer chain */
@@ -757,4 +789,35 @@ errout_with_lock:
   return ret;
 }
 
+/****************************************************************************
+ * Name: psock_udp_sendto
+ *
+ * Description:
+ *   This function implements the UDP-specific logic of the standard
+ *   sendto() socket operation.
+ *
+ * Input Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   buf      Data to send
+ *   len      Length of data to send
+ *   flags    Send flags
+ *   to       Address of recipient
+ *   tolen    The length of the address structure
+ *
+ * Returned Value:
+ *   See psock_udp_sendtov().
+ *
+ ****************************************************************************/
+
+ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
+                         size_t len, int flags, FAR const struct sockaddr *to,
+                         socklen_t tolen)
+{
+  struct iovec iov;
+
+  iov.iov_base = (FAR void *)buf;
+  iov.iov_len  = len;
+  return psock_udp_sendtov(psock, &iov, 1, flags, to, tolen);
+}
+
 #endif /* CONFIG_NET && CONFIG_NET_UDP && CONFIG_NET_UDP_WRITE_BUFFERS */
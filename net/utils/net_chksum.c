@@ -57,6 +57,94 @@
 #define IPv4BUF   ((struct ipv4_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
 #define IPv6BUF   ((struct ipv6_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: chksum_aligned
+ *
+ * Description:
+ *   Calculate the one's complement sum of the 16-bit aligned buffer data.
+ *   The buffer is read in native byte order so the sum is returned in
+ *   network byte order.  A trailing odd byte is padded with zero.
+ *
+ *   The inner loop reads 32-bits at a time and accumulates the two 16-bit
+ *   halves into a 32-bit sum, deferring all carries to the final fold.  For
+ *   len <= 65535, the accumulator cannot overflow.
+ *
+ ****************************************************************************/
+
+#if !defined(CONFIG_NET_ARCH_CHKSUM) && !defined(CONFIG_ARCH_HAVE_CHKSUM)
+static uint16_t chksum_aligned(FAR const uint8_t *data, uint16_t len)
+{
+  FAR const uint16_t *ptr16 = (FAR const uint16_t *)data;
+  FAR const uint32_t *ptr32;
+  uint32_t acc = 0;
+  uint32_t w;
+
+  /* Get to a 32-bit boundary */
+
+  if (((uintptr_t)ptr16 & 2) != 0 && len >= 2)
+    {
+      acc += *ptr16++;
+      len -= 2;
+    }
+
+  ptr32 = (FAR const uint32_t *)ptr16;
+
+  /* Sum 16 bytes per pass */
+
+  while (len >= 16)
+    {
+      w    = ptr32[0];
+      acc += (w >> 16) + (w & 0xffff);
+      w    = ptr32[1];
+      acc += (w >> 16) + (w & 0xffff);
+      w    = ptr32[2];
+      acc += (w >> 16) + (w & 0xffff);
+      w    = ptr32[3];
+      acc += (w >> 16) + (w & 0xffff);
+
+      ptr32 += 4;
+      len   -= 16;
+    }
+
+  while (len >= 4)
+    {
+      w    = *ptr32++;
+      acc += (w >> 16) + (w & 0xffff);
+      len -= 4;
+    }
+
+  /* Then the remaining half word and byte */
+
+  ptr16 = (FAR const uint16_t *)ptr32;
+  if (len >= 2)
+    {
+      acc += *ptr16++;
+      len -= 2;
+    }
+
+  if (len > 0)
+    {
+      union
+      {
+        uint16_t hword;
+        uint8_t  b[2];
+      } u;
+
+      u.b[0] = *(FAR const uint8_t *)ptr16;
+      u.b[1] = 0;
+      acc   += u.hword;
+    }
+
+  acc = (acc & 0xffff) + (acc >> 16);
+  acc = (acc & 0xffff) + (acc >> 16);
+  return (uint16_t)acc;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -79,45 +167,43 @@
  *
  ****************************************************************************/
 
-#ifndef CONFIG_NET_ARCH_CHKSUM
+#if !defined(CONFIG_NET_ARCH_CHKSUM) && !defined(CONFIG_ARCH_HAVE_CHKSUM)
 uint16_t chksum(uint16_t sum, FAR const uint8_t *data, uint16_t len)
 {
-  FAR const uint8_t *dataptr;
-  FAR const uint8_t *last_byte;
-  uint16_t t;
+  uint32_t acc;
 
-  dataptr = data;
-  last_byte = data + len - 1;
-
-  while (dataptr < last_byte)
+  if (len == 0)
     {
-      /* At least two more bytes */
+      return sum;
+    }
 
-      t = ((uint16_t)dataptr[0] << 8) + dataptr[1];
-      sum += t;
-      if (sum < t)
-        {
-          sum++; /* carry */
-        }
+  /* The one's complement sum is independent of byte order (RFC1071), so
+   * the bulk of the buffer is summed as native, 16-bit aligned words.  An
+   * odd start address just swaps the bytes of that partial sum.
+   */
 
-      dataptr += 2;
+  if (((uintptr_t)data & 1) != 0)
+    {
+      acc = chksum_aligned(data + 1, len - 1);
+      acc = ((acc & 0xff) << 8) | (acc >> 8);
+      acc = NTOHS((uint16_t)acc) + ((uint32_t)data[0] << 8);
     }
-
-  if (dataptr == last_byte)
+  else
     {
-      t = (dataptr[0] << 8) + 0;
-      sum += t;
-      if (sum < t)
-        {
-          sum++; /* carry */
-        }
+      acc = NTOHS(chksum_aligned(data, len));
     }
 
+  /* Add in the carried over sum and fold back to 16 bits */
+
+  acc += sum;
+  acc  = (acc & 0xffff) + (acc >> 16);
+  acc  = (acc & 0xffff) + (acc >> 16);
+
   /* Return sum in host byte order. */
 
-  return sum;
+  return (uint16_t)acc;
 }
-#endif /* CONFIG_NET_ARCH_CHKSUM */
+#endif /* !CONFIG_NET_ARCH_CHKSUM && !CONFIG_ARCH_HAVE_CHKSUM */
 
 /****************************************************************************
  * Name: net_chksum
@@ -151,4 +237,40 @@ uint16_t net_chksum(FAR uint16_t *data, uint16_t len)
 }
 #endif /* CONFIG_NET_ARCH_CHKSUM */
 
+/****************************************************************************
+ * Name: net_chksum_adjust
+ *
+ * Description:
+ *   Incrementally update an Internet checksum after one 16-bit word of the
+ *   covered data has changed (RFC1624, eqn. 3):  HC' = ~(~HC + ~m + m').
+ *   This is much cheaper than recomputing the checksum, for example, when
+ *   a forwarded packet's TTL is decremented.
+ *
+ *   The checksum and both values may be in either byte order, provided
+ *   that all three are in the same byte order.
+ *
+ * Input Parameters:
+ *   chksum - The checksum field to be updated.
+ *   oldval - The old value of the 16-bit word.
+ *   newval - The new value of the 16-bit word.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void net_chksum_adjust(FAR uint16_t *chksum, uint16_t oldval,
+                       uint16_t newval)
+{
+  uint32_t sum;
+
+  sum  = (uint16_t)~*chksum;
+  sum += (uint16_t)~oldval;
+  sum += newval;
+  sum  = (sum & 0xffff) + (sum >> 16);
+  sum  = (sum & 0xffff) + (sum >> 16);
+
+  *chksum = (uint16_t)~sum;
+}
+
 #endif /* CONFIG_NET */
@@ -131,12 +131,13 @@ void net_lockinitialize(void)
 
 void net_lock(void)
 {
-#ifdef CONFIG_SMP
-  irqstate_t flags = enter_critical_section();
-#endif
   pid_t me = getpid();
 
-  /* Does this thread already hold the semaphore? */
+  /* Does this thread already hold the semaphore?  No critical section is
+   * needed, even in SMP mode:  Only the holder ever sets g_holder to its
+   * own PID so the comparison cannot succeed spuriously, and g_count is
+   * only modified by the holder.
+   */
 
   if (g_holder == me)
     {
@@ -155,10 +156,6 @@ void net_lock(void)
       g_holder = me;
       g_count  = 1;
     }
-
-#ifdef CONFIG_SMP
-  leave_critical_section(flags);
-#endif
 }
 
 /****************************************************************************
@@ -177,9 +174,6 @@ void net_lock(void)
 
 void net_unlock(void)
 {
-#ifdef CONFIG_SMP
-  irqstate_t flags = enter_critical_section();
-#endif
   DEBUGASSERT(g_holder == getpid() && g_count > 0);
 
   /* If the count would go to zero, then release the semaphore */
@@ -198,10 +192,6 @@ void net_unlock(void)
 
       g_count--;
     }
-
-#ifdef CONFIG_SMP
-  leave_critical_section(flags);
-#endif
 }
 
 /****************************************************************************
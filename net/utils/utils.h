@@ -41,6 +41,7 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+#include <nuttx/arch.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/ip.h>
 
@@ -209,7 +210,9 @@ void net_ipv6_pref2mask(uint8_t preflen, net_ipv6addr_t mask);
  *
  ****************************************************************************/
 
-#ifndef CONFIG_NET_ARCH_CHKSUM
+#if defined(CONFIG_ARCH_HAVE_CHKSUM)
+#  define chksum(s,d,l) up_chksum(s,d,l)
+#elif !defined(CONFIG_NET_ARCH_CHKSUM)
 uint16_t chksum(uint16_t sum, FAR const uint8_t *data, uint16_t len);
 #endif
 
@@ -242,6 +245,27 @@ uint16_t chksum(uint16_t sum, FAR const uint8_t *data, uint16_t len);
 uint16_t net_chksum(FAR uint16_t *data, uint16_t len);
 #endif
 
+/****************************************************************************
+ * Name: net_chksum_adjust
+ *
+ * Description:
+ *   Incrementally update an Internet checksum after one 16-bit word of the
+ *   covered data has changed (RFC1624).  The checksum and both values must
+ *   be in the same byte order.
+ *
+ * Input Parameters:
+ *   chksum - The checksum field to be updated.
+ *   oldval - The old value of the 16-bit word.
+ *   newval - The new value of the 16-bit word.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void net_chksum_adjust(FAR uint16_t *chksum, uint16_t oldval,
+                       uint16_t newval);
+
 /****************************************************************************
  * Name: ipv4_upperlayer_chksum
  *
@@ -135,6 +135,12 @@ extern volatile cpu_set_t g_cpu_irqset SP_SECTION;
 /* Handles nested calls to enter_critical section from interrupt handlers */
 
 extern volatile uint8_t g_cpu_nestcount[CONFIG_SMP_NCPUS];
+
+#ifdef CONFIG_SPINLOCK_HOLDTIME
+/* Hold time statistics of g_cpu_irqlock */
+
+extern struct spinlock_holdtime_s g_cpu_irqhold;
+#endif
 #endif
 
 /****************************************************************************
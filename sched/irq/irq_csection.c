@@ -44,6 +44,7 @@
 #include <nuttx/init.h>
 #include <nuttx/spinlock.h>
 #include <nuttx/sched_note.h>
+#include <nuttx/lockprof.h>
 #include <arch/irq.h>
 
 #include "sched/sched.h"
@@ -70,6 +71,12 @@ volatile cpu_set_t g_cpu_irqset SP_SECTION;
 /* Handles nested calls to enter_critical section from interrupt handlers */
 
 volatile uint8_t g_cpu_nestcount[CONFIG_SMP_NCPUS];
+
+#ifdef CONFIG_SPINLOCK_HOLDTIME
+/* Hold time statistics of g_cpu_irqlock */
+
+struct spinlock_holdtime_s g_cpu_irqhold;
+#endif
 #endif
 
 /****************************************************************************
@@ -188,6 +195,10 @@ irqstate_t enter_critical_section(void)
 {
   FAR struct tcb_s *rtcb;
   irqstate_t ret;
+#ifdef CONFIG_SCHED_LOCKPROF
+  uint32_t start;
+  bool contended;
+#endif
   int cpu;
 
   /* Disable interrupts.
@@ -279,6 +290,11 @@ try_again:
 
               if ((g_cpu_irqset & (1 << cpu)) == 0)
                 {
+#ifdef CONFIG_SCHED_LOCKPROF
+                  start     = sched_lockprof_start();
+                  contended = spin_islocked(&g_cpu_irqlock);
+#endif
+
                   /* Wait until we can get the spinlock (meaning that we are
                    * no longer blocked by the critical section).
                    */
@@ -292,6 +308,16 @@ try_again:
 
                       DEBUGVERIFY(up_cpu_paused(cpu));
                     }
+                  else
+                    {
+                      /* We just took the lock; start timing the hold */
+
+                      spin_holdtime_begin(&g_cpu_irqhold);
+                      sched_lockprof_acquired((FAR const void *)&g_cpu_irqlock,
+                                              LOCKPROF_CALLER(),
+                                              LOCKPROF_CSECTION, start,
+                                              contended);
+                    }
                 }
 
               /* In any event, the nesting count is now one */
@@ -344,6 +370,11 @@ try_again:
 
               DEBUGASSERT((g_cpu_irqset & (1 << cpu)) == 0);
 
+#ifdef CONFIG_SCHED_LOCKPROF
+              start     = sched_lockprof_start();
+              contended = spin_islocked(&g_cpu_irqlock);
+#endif
+
               if (!irq_waitlock(cpu))
                 {
                   /* We are in a deadlock condition due to a pending pause
@@ -361,6 +392,11 @@ try_again:
                   goto try_again;
                 }
 
+              spin_holdtime_begin(&g_cpu_irqhold);
+              sched_lockprof_acquired((FAR const void *)&g_cpu_irqlock,
+                                      LOCKPROF_CALLER(), LOCKPROF_CSECTION,
+                                      start, contended);
+
               /* The set the lock count to 1.
                *
                * Interrupts disables must follow a stacked order.  We
@@ -472,6 +508,13 @@ void leave_critical_section(irqstate_t flags)
 
               if (rtcb->irqcount <= 0)
                 {
+#ifdef CONFIG_SPINLOCK_HOLDTIME
+                  if ((g_cpu_irqset & ~(1 << cpu)) == 0)
+                    {
+                      spin_holdtime_end(&g_cpu_irqhold);
+                    }
+#endif
+
                   spin_clrbit(&g_cpu_irqset, cpu, &g_cpu_irqsetlock,
                               &g_cpu_irqlock);
                 }
@@ -549,6 +592,14 @@ void leave_critical_section(irqstate_t flags)
                */
 
               rtcb->irqcount = 0;
+
+#ifdef CONFIG_SPINLOCK_HOLDTIME
+              if ((g_cpu_irqset & ~(1 << cpu)) == 0)
+                {
+                  spin_holdtime_end(&g_cpu_irqhold);
+                }
+#endif
+
               spin_clrbit(&g_cpu_irqset, cpu, &g_cpu_irqsetlock,
                           &g_cpu_irqlock);
 
@@ -40,6 +40,7 @@
 #include <nuttx/config.h>
 #include <nuttx/arch.h>
 #include <nuttx/irq.h>
+#include <nuttx/spinlock.h>
 
 #include "irq/irq.h"
 
@@ -99,4 +100,10 @@ void irq_initialize(void)
 #endif
 #endif
     }
+
+#ifdef CONFIG_SPINLOCK_HOLDTIME
+  /* Start collecting hold time statistics for the critical section */
+
+  spin_holdtime_register(&g_cpu_irqhold, "csection");
+#endif
 }
@@ -47,7 +47,9 @@
 #include <debug.h>
 
 #include <nuttx/sched.h>
+#include <nuttx/lockprof.h>
 
+#include "sched/sched.h"
 #include "pthread/pthread.h"
 
 /****************************************************************************
@@ -215,7 +217,10 @@ int pthread_mutex_lock(FAR pthread_mutex_t *mutex)
              * default mutex.
              */
 
+            sched_lockprof_hint(this_task(), LOCKPROF_CALLER(),
+                                LOCKPROF_MUTEX);
             ret = pthread_mutex_take(mutex, true);
+            sched_lockprof_hint(this_task(), NULL, LOCKPROF_SEMAPHORE);
 
             /* If we successfully obtained the semaphore, then indicate
              * that we own it.
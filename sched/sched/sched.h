@@ -382,6 +382,15 @@ extern volatile spinlock_t g_cpu_tasklistlock SP_SECTION;
 extern volatile int16_t g_global_lockcount;
 #endif
 
+#ifdef CONFIG_SMP_STATS
+/* Declared in sched_smpstats.c *********************************************/
+/* Per-CPU task placement statistics.  These are modified only while the
+ * task lists are locked.
+ */
+
+extern struct smp_stats_s g_smpstats[CONFIG_SMP_NCPUS];
+#endif
+
 #endif /* CONFIG_SMP */
 
 /****************************************************************************
@@ -396,6 +405,24 @@ bool sched_addprioritized(FAR struct tcb_s *tcb, DSEG dq_queue_t *list);
 void sched_mergeprioritized(FAR dq_queue_t *list1, FAR dq_queue_t *list2,
                             uint8_t task_state);
 bool sched_mergepending(void);
+
+#ifdef CONFIG_SCHED_PRIOINDEX
+/* Priority index of the ready-to-run lists.  Any logic that links a TCB
+ * into or unlinks a TCB from a ready-to-run list by some means other than
+ * sched_addprioritized() must keep the index in sync using these.
+ */
+
+bool sched_prioindex_lookup(DSEG dq_queue_t *list, uint8_t sched_priority,
+                            FAR struct tcb_s **prev);
+void sched_prioindex_insert(FAR struct tcb_s *tcb, DSEG dq_queue_t *list);
+void sched_prioindex_remove(FAR struct tcb_s *tcb, DSEG dq_queue_t *list);
+void sched_prioindex_rebuild(DSEG dq_queue_t *list);
+#else
+#  define sched_prioindex_insert(t, l)
+#  define sched_prioindex_remove(t, l)
+#  define sched_prioindex_rebuild(l)
+#endif
+
 void sched_addblocked(FAR struct tcb_s *btcb, tstate_t task_state);
 void sched_removeblocked(FAR struct tcb_s *btcb);
 int  nxsched_setpriority(FAR struct tcb_s *tcb, int sched_priority);
@@ -461,6 +488,16 @@ void sched_tasklist_unlock(irqstate_t lock);
 
 #  define sched_islocked_tcb(tcb) sched_islocked_global()
 
+#ifdef CONFIG_SMP_STATS
+#  define sched_smp_started(tcb, cpu) \
+     ((tcb)->cpu == (cpu) ? g_smpstats[cpu].ss_affine++ : \
+                            g_smpstats[cpu].ss_migrations++)
+#  define sched_smp_stolen(cpu)   (g_smpstats[cpu].ss_steals++)
+#else
+#  define sched_smp_started(tcb, cpu)
+#  define sched_smp_stolen(cpu)
+#endif
+
 #else
 #  define sched_cpu_select(a)     (0)
 #  define sched_cpu_pause(t)      (-38)  /* -ENOSYS */
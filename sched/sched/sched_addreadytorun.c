@@ -193,6 +193,19 @@ bool sched_addreadytorun(FAR struct tcb_s *btcb)
        */
 
       cpu = sched_cpu_select(btcb->affinity);
+
+      /* If the CPU that the task last ran on is running a task of the same
+       * priority as the selected CPU, then it is just as good a choice and
+       * the task's working set may still be in that CPU's cache.
+       */
+
+      if (cpu != btcb->cpu &&
+          (btcb->affinity & (1 << btcb->cpu)) != 0 &&
+          current_task(btcb->cpu)->sched_priority <=
+          current_task(cpu)->sched_priority)
+        {
+          cpu = btcb->cpu;
+        }
     }
 
   /* Get the task currently running on the CPU (may be the IDLE task) */
@@ -304,6 +317,7 @@ bool sched_addreadytorun(FAR struct tcb_s *btcb)
 
           DEBUGASSERT(task_state == TSTATE_TASK_RUNNING);
 
+          sched_smp_started(btcb, cpu);
           btcb->cpu        = cpu;
           btcb->task_state = TSTATE_TASK_RUNNING;
 
@@ -382,6 +396,7 @@ bool sched_addreadytorun(FAR struct tcb_s *btcb)
             {
               /* Remove the task from the assigned task list */
 
+              sched_prioindex_remove(next, tasklist);
               dq_rem((FAR dq_entry_t *)next, tasklist);
 
               /* Add the task to the g_readytorun or to the g_pendingtasks
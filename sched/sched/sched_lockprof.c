@@ -0,0 +1,390 @@
+/****************************************************************************
+ * sched/sched/sched_lockprof.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/init.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/lockprof.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_LOCKPROF
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_SCHED_LOCKPROF_NENTRIES
+#  define CONFIG_SCHED_LOCKPROF_NENTRIES 64
+#endif
+
+#ifndef CONFIG_SCHED_LOCKPROF_NHOLDS
+#  define CONFIG_SCHED_LOCKPROF_NHOLDS 16
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one lock currently held by one thread */
+
+struct lockprof_hold_s
+{
+  FAR const void *lh_lock;      /* Address of the lock (NULL: unused) */
+  pid_t    lh_pid;              /* The thread that holds the lock */
+  int16_t  lh_index;            /* Index of the entry in g_lockprof[] */
+  uint32_t lh_start;            /* Time when the lock was taken */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The lock profile, a hash table keyed by lock and caller */
+
+static struct lockprof_s g_lockprof[CONFIG_SCHED_LOCKPROF_NENTRIES];
+
+/* The locks currently held */
+
+static struct lockprof_hold_s g_lockhold[CONFIG_SCHED_LOCKPROF_NHOLDS];
+
+#ifdef CONFIG_SMP
+/* Protects the tables above.  This can be neither the critical section
+ * nor an instrumented spinlock since both are profiled.
+ */
+
+static volatile spinlock_t g_lockprof_lock SP_SECTION = SP_UNLOCKED;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lockprof_lock and lockprof_unlock
+ ****************************************************************************/
+
+static inline irqstate_t lockprof_lock(void)
+{
+  irqstate_t flags = up_irq_save();
+#ifdef CONFIG_SMP
+  spin_lock_wo_note(&g_lockprof_lock);
+#endif
+  return flags;
+}
+
+static inline void lockprof_unlock(irqstate_t flags)
+{
+#ifdef CONFIG_SMP
+  spin_unlock_wo_note(&g_lockprof_lock);
+#endif
+  up_irq_restore(flags);
+}
+
+/****************************************************************************
+ * Name: lockprof_pid
+ *
+ * Description:
+ *   Return the ID of the thread running on this CPU.  this_task() is not
+ *   used because it may enter the critical section.
+ *
+ ****************************************************************************/
+
+static inline pid_t lockprof_pid(void)
+{
+  return current_task(this_cpu())->pid;
+}
+
+/****************************************************************************
+ * Name: lockprof_find
+ *
+ * Description:
+ *   Find the profile entry of a lock and caller, allocating a new entry if
+ *   there is none yet.
+ *
+ * Returned Value:
+ *   The index of the entry in g_lockprof[] or -1 if the table is full.
+ *
+ ****************************************************************************/
+
+static int lockprof_find(FAR const void *lock, FAR void *caller,
+                         uint8_t type)
+{
+  FAR struct lockprof_s *entry;
+  uintptr_t hash;
+  int index;
+  int i;
+
+  hash  = (uintptr_t)lock ^ ((uintptr_t)caller << 4);
+  hash ^= hash >> 11;
+
+  for (i = 0; i < CONFIG_SCHED_LOCKPROF_NENTRIES; i++)
+    {
+      index = (int)((hash + i) % CONFIG_SCHED_LOCKPROF_NENTRIES);
+      entry = &g_lockprof[index];
+
+      if (entry->lp_lock == lock && entry->lp_caller == caller)
+        {
+          return index;
+        }
+
+      if (entry->lp_lock == NULL)
+        {
+          memset(entry, 0, sizeof(struct lockprof_s));
+          entry->lp_lock   = lock;
+          entry->lp_caller = caller;
+          entry->lp_type   = type;
+          return index;
+        }
+    }
+
+  return -1;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_lockprof_acquired
+ *
+ * Description:
+ *   Account for the acquisition of a lock by the current thread.  If the
+ *   lock is a semaphore or a mutex, start measuring how long it is held.
+ *
+ * Input Parameters:
+ *   lock      - The address of the lock
+ *   caller    - The address of the code that took the lock
+ *   type      - The type of the lock (LOCKPROF_*)
+ *   start     - The value of sched_lockprof_start() when the wait began
+ *   contended - True if the lock was not available immediately
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void sched_lockprof_acquired(FAR const void *lock, FAR void *caller,
+                             uint8_t type, uint32_t start, bool contended)
+{
+  FAR struct lockprof_s *entry;
+  FAR struct lockprof_hold_s *hold;
+  irqstate_t flags;
+  uint32_t now;
+  uint32_t wait;
+  int index;
+  int i;
+
+  /* The task lists must be valid in order to identify the holder */
+
+  if (g_os_initstate < OSINIT_TASKLISTS)
+    {
+      return;
+    }
+
+  now   = up_perf_gettime();
+  flags = lockprof_lock();
+
+  index = lockprof_find(lock, caller, type);
+  if (index >= 0)
+    {
+      entry = &g_lockprof[index];
+      entry->lp_count++;
+
+      if (contended)
+        {
+          wait = now - start;
+          entry->lp_contended++;
+          entry->lp_totalwait += wait;
+
+          if (wait > entry->lp_maxwait)
+            {
+              entry->lp_maxwait = wait;
+            }
+        }
+
+      /* The hold times of the critical section and of spinlocks are
+       * measured per CPU by the spin_holdtime_begin() and
+       * spin_holdtime_end() hooks.  Only semaphores and mutexes are held
+       * by threads.
+       */
+
+      if (type == LOCKPROF_CSECTION || type == LOCKPROF_SPINLOCK)
+        {
+          lockprof_unlock(flags);
+          return;
+        }
+
+      /* Remember when the lock was taken.  If all hold slots are in use,
+       * reuse the oldest one:  That is most likely a semaphore used for
+       * signaling that will never be released by this thread.  The hold
+       * time of the lock in that slot is lost; count that against its
+       * entry.
+       */
+
+      hold = &g_lockhold[0];
+      for (i = 0; i < CONFIG_SCHED_LOCKPROF_NHOLDS; i++)
+        {
+          if (g_lockhold[i].lh_lock == NULL)
+            {
+              hold = &g_lockhold[i];
+              break;
+            }
+
+          if (now - g_lockhold[i].lh_start > now - hold->lh_start)
+            {
+              hold = &g_lockhold[i];
+            }
+        }
+
+      if (hold->lh_lock != NULL)
+        {
+          g_lockprof[hold->lh_index].lp_evicted++;
+        }
+
+      hold->lh_lock  = lock;
+      hold->lh_pid   = lockprof_pid();
+      hold->lh_index = (int16_t)index;
+      hold->lh_start = now;
+    }
+
+  lockprof_unlock(flags);
+}
+
+/****************************************************************************
+ * Name: sched_lockprof_released
+ *
+ * Description:
+ *   Account for the release of a lock by the current thread.  Nothing is
+ *   done if the current thread was not seen taking the lock, as is the case
+ *   of semaphores used for signaling.
+ *
+ * Input Parameters:
+ *   lock - The address of the lock
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void sched_lockprof_released(FAR const void *lock)
+{
+  FAR struct lockprof_s *entry;
+  FAR struct lockprof_hold_s *hold;
+  irqstate_t flags;
+  uint32_t now;
+  uint32_t held;
+  pid_t pid;
+  int i;
+
+  if (g_os_initstate < OSINIT_TASKLISTS)
+    {
+      return;
+    }
+
+  now   = up_perf_gettime();
+  flags = lockprof_lock();
+  pid   = lockprof_pid();
+
+  for (i = 0; i < CONFIG_SCHED_LOCKPROF_NHOLDS; i++)
+    {
+      hold = &g_lockhold[i];
+      if (hold->lh_lock == lock && hold->lh_pid == pid)
+        {
+          held  = now - hold->lh_start;
+          entry = &g_lockprof[hold->lh_index];
+
+          entry->lp_nholds++;
+          entry->lp_totalhold += held;
+
+          if (held > entry->lp_maxhold)
+            {
+              entry->lp_maxhold = held;
+            }
+
+          hold->lh_lock = NULL;
+          break;
+        }
+    }
+
+  lockprof_unlock(flags);
+}
+
+/****************************************************************************
+ * Name: sched_lockprof_get
+ *
+ * Description:
+ *   Return a copy of one entry of the lock profile.
+ *
+ * Input Parameters:
+ *   index - The index of the entry, 0 .. CONFIG_SCHED_LOCKPROF_NENTRIES - 1
+ *   entry - The location to return the entry.  entry->lp_lock is NULL if
+ *           the entry is not in use.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; -ENOENT is returned if 'index' is
+ *   beyond the end of the profile.
+ *
+ ****************************************************************************/
+
+int sched_lockprof_get(int index, FAR struct lockprof_s *entry)
+{
+  irqstate_t flags;
+
+  if (index < 0 || index >= CONFIG_SCHED_LOCKPROF_NENTRIES)
+    {
+      return -ENOENT;
+    }
+
+  flags = lockprof_lock();
+  memcpy(entry, &g_lockprof[index], sizeof(struct lockprof_s));
+  lockprof_unlock(flags);
+
+  return OK;
+}
+
+#endif /* CONFIG_SCHED_LOCKPROF */
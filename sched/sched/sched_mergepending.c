@@ -152,6 +152,8 @@ bool sched_mergepending(void)
           ptcb->task_state  = TSTATE_TASK_READYTORUN;
         }
 
+      sched_prioindex_insert(ptcb, (FAR dq_queue_t *)&g_readytorun);
+
       /* Set up for the next time through */
 
       rtcb = ptcb;
@@ -161,6 +163,7 @@ bool sched_mergepending(void)
 
   g_pendingtasks.head = NULL;
   g_pendingtasks.tail = NULL;
+  sched_prioindex_rebuild((FAR dq_queue_t *)&g_pendingtasks);
 
   return ret;
 }
@@ -238,7 +241,9 @@ bool sched_mergepending(void)
         {
           /* Remove the task from the pending task list */
 
-          tcb = (FAR struct tcb_s *)dq_remfirst((FAR dq_queue_t *)&g_pendingtasks);
+          tcb = (FAR struct tcb_s *)g_pendingtasks.head;
+          sched_prioindex_remove(tcb, (FAR dq_queue_t *)&g_pendingtasks);
+          (void)dq_remfirst((FAR dq_queue_t *)&g_pendingtasks);
 
           /* Add the pending task to the correct ready-to-run list. */
 
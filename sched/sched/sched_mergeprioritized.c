@@ -128,7 +128,7 @@ void sched_mergeprioritized(FAR dq_queue_t *list1, FAR dq_queue_t *list2,
       /* Special case.. list2 is empty.  Move list1 to list2. */
 
       dq_move(&clone, list2);
-      goto ret_with_lock;
+      goto ret_with_index;
     }
 
   /* Now loop until all entries from list1 have been merged into list2. tcb1
@@ -178,6 +178,15 @@ void sched_mergeprioritized(FAR dq_queue_t *list1, FAR dq_queue_t *list2,
     }
   while (tcb1 != NULL);
 
+ret_with_index:
+
+  /* TCBs have been moved in bulk so the index (if any) of each list must be
+   * regenerated.
+   */
+
+  sched_prioindex_rebuild(list1);
+  sched_prioindex_rebuild(list2);
+
 ret_with_lock:
 
 #ifdef CONFIG_SMP
@@ -40,10 +40,12 @@
 #include <nuttx/config.h>
 
 #include <stdint.h>
+#include <stddef.h>
 #include <string.h>
 #include <assert.h>
 #include <errno.h>
 
+#include <nuttx/arch.h>
 #include <nuttx/sched.h>
 #include <nuttx/clock.h>
 #include <nuttx/spinlock.h>
@@ -57,6 +59,14 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* With CONFIG_SCHED_NOTE_PERCPU, each CPU has its own circular buffer */
+
+#ifdef CONFIG_SCHED_NOTE_PERCPU
+#  define NOTE_NBUFFERS CONFIG_SMP_NCPUS
+#else
+#  define NOTE_NBUFFERS 1
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -92,9 +102,11 @@ static void note_add(FAR const uint8_t *note, uint8_t notelen);
  * Private Data
  ****************************************************************************/
 
-static struct note_info_s g_note_info;
+static struct note_info_s g_note_info[NOTE_NBUFFERS];
 
-#ifdef CONFIG_SMP
+#if defined(CONFIG_SCHED_NOTE_PERCPU)
+static volatile spinlock_t g_note_readlock;
+#elif defined(CONFIG_SMP)
 static volatile spinlock_t g_note_lock;
 #endif
 
@@ -148,7 +160,11 @@ static inline unsigned int note_next(unsigned int ndx, unsigned int offset)
 static void note_common(FAR struct tcb_s *tcb, FAR struct note_common_s *note,
                         uint8_t length, uint8_t type)
 {
+#ifdef CONFIG_SCHED_NOTE_PERFTIME
+  uint32_t systime    = up_perf_gettime();
+#else
   uint32_t systime    = (uint32_t)clock_systimer();
+#endif
 
   /* Save all of the common fields */
 
@@ -161,7 +177,7 @@ static void note_common(FAR struct tcb_s *tcb, FAR struct note_common_s *note,
   note->nc_pid[0]     = (uint8_t)(tcb->pid & 0xff);
   note->nc_pid[1]     = (uint8_t)((tcb->pid >> 8) & 0xff);
 
-  /* Save the LS 32-bits of the system timer in little endian order */
+  /* Save the LS 32-bits of the time stamp in little endian order */
 
   note->nc_systime[0] = (uint8_t)( systime        & 0xff);
   note->nc_systime[1] = (uint8_t)((systime >> 8)  & 0xff);
@@ -209,17 +225,17 @@ void note_spincommon(FAR struct tcb_s *tcb, FAR volatile spinlock_t *spinlock,
  *   Length of data currently in circular buffer.
  *
  * Input Parameters:
- *   None
+ *   ni - The circular buffer
  *
  * Returned Value:
  *   Length of data currently in circular buffer.
  *
  ****************************************************************************/
 
-static unsigned int note_length(void)
+static unsigned int note_length(FAR struct note_info_s *ni)
 {
-  unsigned int head = g_note_info.ni_head;
-  unsigned int tail = g_note_info.ni_tail;
+  unsigned int head = ni->ni_head;
+  unsigned int tail = ni->ni_tail;
 
   if (tail > head)
     {
@@ -236,7 +252,7 @@ static unsigned int note_length(void)
  *   Remove the variable length note from the tail of the circular buffer
  *
  * Input Parameters:
- *   None
+ *   ni - The circular buffer
  *
  * Returned Value:
  *   None
@@ -246,7 +262,7 @@ static unsigned int note_length(void)
  *
  ****************************************************************************/
 
-static void note_remove(void)
+static void note_remove(FAR struct note_info_s *ni)
 {
   FAR struct note_common_s *note;
   unsigned int tail;
@@ -254,20 +270,20 @@ static void note_remove(void)
 
   /* Get the tail index of the circular buffer */
 
-  tail = g_note_info.ni_tail;
+  tail = ni->ni_tail;
   DEBUGASSERT(tail < CONFIG_SCHED_NOTE_BUFSIZE);
 
   /* Get the length of the note at the tail index */
 
-  note   = (FAR struct note_common_s *)&g_note_info.ni_buffer[tail];
+  note   = (FAR struct note_common_s *)&ni->ni_buffer[tail];
   length = note->nc_length;
-  DEBUGASSERT(length <= note_length());
+  DEBUGASSERT(length <= note_length(ni));
 
   /* Increment the tail index to remove the entire note from the circular
    * buffer.
    */
 
-  g_note_info.ni_tail = note_next(tail, length);
+  ni->ni_tail = note_next(tail, length);
 }
 
 /****************************************************************************
@@ -283,14 +299,20 @@ static void note_remove(void)
  *   None
  *
  * Assumptions:
- *   We are within a critical section.
+ *   We are within a critical section.  With CONFIG_SCHED_NOTE_PERCPU, it is
+ *   sufficient that local interrupts are disabled:  Each CPU is then the
+ *   only producer of notes in its own circular buffer.
  *
  ****************************************************************************/
 
 static void note_add(FAR const uint8_t *note, uint8_t notelen)
 {
+  FAR struct note_info_s *ni;
   unsigned int head;
   unsigned int next;
+#ifdef CONFIG_SMP
+  irqstate_t flags;
+#endif
 
 #ifdef CONFIG_SMP
   /* Ignore notes that are not in the set of monitored CPUs */
@@ -303,15 +325,34 @@ static void note_add(FAR const uint8_t *note, uint8_t notelen)
     }
 #endif
 
-#ifdef CONFIG_SMP
-  irqstate_t flags = up_irq_save();
+  DEBUGASSERT(note != NULL && notelen < CONFIG_SCHED_NOTE_BUFSIZE);
+
+#if defined(CONFIG_SCHED_NOTE_PERCPU)
+  flags = up_irq_save();
+  ni    = &g_note_info[this_cpu()];
+
+  /* The tail index belongs to the reader.  If there is no room for the
+   * note, then the new note is discarded rather than removing the oldest
+   * note from the tail.
+   */
+
+  if (notelen >= CONFIG_SCHED_NOTE_BUFSIZE - note_length(ni))
+    {
+      up_irq_restore(flags);
+      return;
+    }
+
+#elif defined(CONFIG_SMP)
+  flags = up_irq_save();
   spin_lock_wo_note(&g_note_lock);
+  ni    = g_note_info;
+#else
+  ni    = g_note_info;
 #endif
 
   /* Get the index to the head of the circular buffer */
 
-  DEBUGASSERT(note != NULL && notelen < CONFIG_SCHED_NOTE_BUFSIZE);
-  head = g_note_info.ni_head;
+  head = ni->ni_head;
 
   /* Loop until all bytes have been transferred to the circular buffer */
 
@@ -322,29 +363,258 @@ static void note_add(FAR const uint8_t *note, uint8_t notelen)
        */
 
       next = note_next(head, 1);
-      if (next == g_note_info.ni_tail)
+      if (next == ni->ni_tail)
         {
           /* Yes, then remove the note at the tail index */
 
-          note_remove();
+          note_remove(ni);
         }
 
       /* Save the next byte at the head index */
 
-      g_note_info.ni_buffer[head] = *note++;
+      ni->ni_buffer[head] = *note++;
 
       head = next;
       notelen--;
     }
 
-  g_note_info.ni_head = head;
+#if defined(CONFIG_SCHED_NOTE_PERCPU)
+  /* The note must be complete in memory before the reader can see it */
 
-#ifdef CONFIG_SMP
+  SP_DMB();
+  ni->ni_head = head;
+  up_irq_restore(flags);
+
+#elif defined(CONFIG_SMP)
+  ni->ni_head = head;
   spin_unlock_wo_note(&g_note_lock);
   up_irq_restore(flags);
+#else
+  ni->ni_head = head;
 #endif
 }
 
+/****************************************************************************
+ * Name: note_readlock and note_readunlock
+ *
+ * Description:
+ *   Serialize readers of the circular buffer(s).  With per-CPU buffers, the
+ *   producers never take this lock so it need only exclude other readers.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_NOTE_GET
+static inline irqstate_t note_readlock(void)
+{
+#ifdef CONFIG_SCHED_NOTE_PERCPU
+  irqstate_t flags = up_irq_save();
+  spin_lock_wo_note(&g_note_readlock);
+  return flags;
+#else
+  return enter_critical_section();
+#endif
+}
+
+static inline void note_readunlock(irqstate_t flags)
+{
+#ifdef CONFIG_SCHED_NOTE_PERCPU
+  spin_unlock_wo_note(&g_note_readlock);
+  up_irq_restore(flags);
+#else
+  leave_critical_section(flags);
+#endif
+}
+#endif
+
+/****************************************************************************
+ * Name: note_systime
+ *
+ * Description:
+ *   Return the time stamp of the note at the tail of the circular buffer.
+ *
+ * Input Parameters:
+ *   ni - The non-empty circular buffer
+ *
+ * Returned Value:
+ *   The 32-bit time stamp of the oldest note
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_SCHED_NOTE_GET) && defined(CONFIG_SCHED_NOTE_PERCPU)
+static uint32_t note_systime(FAR struct note_info_s *ni)
+{
+  unsigned int ndx;
+  uint32_t systime;
+  int i;
+
+  /* The time stamp is little endian and may wrap around the end of the
+   * circular buffer.
+   */
+
+  ndx     = note_next(ni->ni_tail, offsetof(struct note_common_s, nc_systime));
+  systime = 0;
+
+  for (i = 0; i < 4; i++)
+    {
+      systime |= (uint32_t)ni->ni_buffer[ndx] << (8 * i);
+      ndx      = note_next(ndx, 1);
+    }
+
+  return systime;
+}
+#endif
+
+/****************************************************************************
+ * Name: note_select
+ *
+ * Description:
+ *   Select the circular buffer holding the oldest note.  Per-CPU buffers
+ *   are merged in time stamp order so that the notes are returned in the
+ *   order in which they were generated.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   The selected circular buffer or NULL if all buffers are empty.
+ *
+ * Assumptions:
+ *   The caller holds the reader lock.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_NOTE_GET
+static FAR struct note_info_s *note_select(void)
+{
+#ifdef CONFIG_SCHED_NOTE_PERCPU
+  FAR struct note_info_s *oldest = NULL;
+  FAR struct note_info_s *ni;
+  uint32_t oldtime = 0;
+  uint32_t systime;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      ni = &g_note_info[cpu];
+      if (note_length(ni) > 0)
+        {
+          /* Do not look at the note before the head index was seen */
+
+          SP_DMB();
+
+          systime = note_systime(ni);
+          if (oldest == NULL || (int32_t)(systime - oldtime) < 0)
+            {
+              oldest  = ni;
+              oldtime = systime;
+            }
+        }
+    }
+
+  return oldest;
+#else
+  return note_length(g_note_info) > 0 ? g_note_info : NULL;
+#endif
+}
+#endif
+
+/****************************************************************************
+ * Name: note_size
+ *
+ * Description:
+ *   Return the size of the note at the tail of the circular buffer.
+ *
+ * Input Parameters:
+ *   ni - The non-empty circular buffer
+ *
+ * Returned Value:
+ *   The size of the oldest note.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_NOTE_GET
+static inline ssize_t note_size(FAR struct note_info_s *ni)
+{
+  FAR struct note_common_s *note;
+  unsigned int tail;
+
+  tail = ni->ni_tail;
+  DEBUGASSERT(tail < CONFIG_SCHED_NOTE_BUFSIZE);
+
+  note = (FAR struct note_common_s *)&ni->ni_buffer[tail];
+  DEBUGASSERT(note->nc_length <= note_length(ni));
+  return note->nc_length;
+}
+#endif
+
+/****************************************************************************
+ * Name: note_get
+ *
+ * Description:
+ *   Remove the note at the tail of the circular buffer and copy it to the
+ *   user buffer.
+ *
+ * Input Parameters:
+ *   ni     - The non-empty circular buffer
+ *   buffer - Location to return the note
+ *   buflen - The length of the user provided buffer.
+ *
+ * Returned Value:
+ *   The positive, non-zero length of the note or -EFBIG if the note does
+ *   not fit into the user buffer.  The note is discarded in that case.
+ *
+ * Assumptions:
+ *   The caller holds the reader lock.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_NOTE_GET
+static ssize_t note_get(FAR struct note_info_s *ni, FAR uint8_t *buffer,
+                        size_t buflen)
+{
+  unsigned int remaining;
+  unsigned int tail;
+  ssize_t notelen;
+
+  /* Is the user buffer large enough to hold the note? */
+
+  notelen = note_size(ni);
+  if (buflen < notelen)
+    {
+      /* Remove the large note so that we do not get constipated. */
+
+      note_remove(ni);
+      return -EFBIG;
+    }
+
+  /* Loop until the note has been transferred to the user buffer */
+
+  tail      = ni->ni_tail;
+  remaining = (unsigned int)notelen;
+
+  while (remaining > 0)
+    {
+      /* Copy the next byte at the tail index */
+
+      *buffer++ = ni->ni_buffer[tail];
+
+      /* Adjust indices and counts */
+
+      tail = note_next(tail, 1);
+      remaining--;
+    }
+
+#ifdef CONFIG_SCHED_NOTE_PERCPU
+  /* The note must be copied out before the producer may overwrite it */
+
+  SP_DMB();
+#endif
+
+  ni->ni_tail = tail;
+  return notelen;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -607,70 +877,85 @@ void sched_note_spinabort(FAR struct tcb_s *tcb, FAR volatile void *spinlock)
 #ifdef CONFIG_SCHED_NOTE_GET
 ssize_t sched_note_get(FAR uint8_t *buffer, size_t buflen)
 {
-  FAR struct note_common_s *note;
+  FAR struct note_info_s *ni;
   irqstate_t flags;
-  unsigned int remaining;
-  unsigned int tail;
   ssize_t notelen;
-  size_t circlen;
 
   DEBUGASSERT(buffer != NULL);
-  flags = enter_critical_section();
+  flags = note_readlock();
 
   /* Verify that the circular buffer is not empty */
 
-  circlen = note_length();
-  if (circlen <= 0)
+  ni = note_select();
+  if (ni == NULL)
     {
       notelen = 0;
-      goto errout_with_csection;
     }
-
-  /* Get the index to the tail of the circular buffer */
-
-  tail    = g_note_info.ni_tail;
-  DEBUGASSERT(tail < CONFIG_SCHED_NOTE_BUFSIZE);
-
-  /* Get the length of the note at the tail index */
-
-  note    = (FAR struct note_common_s *)&g_note_info.ni_buffer[tail];
-  notelen = note->nc_length;
-  DEBUGASSERT(notelen <= circlen);
-
-  /* Is the user buffer large enough to hold the note? */
-
-  if (buflen < notelen)
+  else
     {
-      /* Remove the large note so that we do not get constipated. */
+      notelen = note_get(ni, buffer, buflen);
+    }
 
-      note_remove();
+  note_readunlock(flags);
+  return notelen;
+}
+#endif
 
-      /* and return an error */
+/****************************************************************************
+ * Name: sched_note_read
+ *
+ * Description:
+ *   Remove as many notes as will fit from the tail of the circular
+ *   buffer(s), copying them back-to-back into the user buffer.
+ *
+ * Input Parameters:
+ *   buffer - Location to return the notes
+ *   buflen - The length of the user provided buffer.
+ *
+ * Returned Value:
+ *   On success, the total length of the returned notes is provided.  Zero
+ *   is returned only if the circular buffer is empty.  A negated errno
+ *   value is returned if not even the first note will fit.
+ *
+ ****************************************************************************/
 
-      notelen = -EFBIG;
-      goto errout_with_csection;
-    }
+#ifdef CONFIG_SCHED_NOTE_GET
+ssize_t sched_note_read(FAR uint8_t *buffer, size_t buflen)
+{
+  FAR struct note_info_s *ni;
+  irqstate_t flags;
+  ssize_t notelen;
+  ssize_t retlen;
 
-  /* Loop until the note has been transferred to the user buffer */
+  DEBUGASSERT(buffer != NULL);
+  flags  = note_readlock();
+  retlen = 0;
 
-  remaining = (unsigned int)notelen;
-  while (remaining > 0)
+  while ((ni = note_select()) != NULL)
     {
-      /* Copy the next byte at the tail index */
+      /* Leave a note that will not fit for the next read unless nothing
+       * has been transferred yet.
+       */
 
-      *buffer++ = g_note_info.ni_buffer[tail];
+      if (retlen > 0 && note_size(ni) > buflen)
+        {
+          break;
+        }
 
-      /* Adjust indices and counts */
+      notelen = note_get(ni, buffer, buflen);
+      if (notelen < 0)
+        {
+          retlen = notelen;
+          break;
+        }
 
-      tail = note_next(tail, 1);
-      remaining--;
+      retlen += notelen;
+      buffer += notelen;
+      buflen -= notelen;
     }
 
-  g_note_info.ni_tail = tail;
-
-errout_with_csection:
-  leave_critical_section(flags);
-  return notelen;
+  note_readunlock(flags);
+  return retlen;
 }
 #endif
 
@@ -692,36 +977,18 @@ errout_with_csection:
 #ifdef CONFIG_SCHED_NOTE_GET
 ssize_t sched_note_size(void)
 {
-  FAR struct note_common_s *note;
+  FAR struct note_info_s *ni;
   irqstate_t flags;
-  unsigned int tail;
   ssize_t notelen;
-  size_t circlen;
 
-  flags = enter_critical_section();
+  flags = note_readlock();
 
   /* Verify that the circular buffer is not empty */
 
-  circlen = note_length();
-  if (circlen <= 0)
-    {
-      notelen = 0;
-      goto errout_with_csection;
-    }
-
-  /* Get the index to the tail of the circular buffer */
-
-  tail = g_note_info.ni_tail;
-  DEBUGASSERT(tail < CONFIG_SCHED_NOTE_BUFSIZE);
+  ni = note_select();
+  notelen = ni != NULL ? note_size(ni) : 0;
 
-  /* Get the length of the note at the tail index */
-
-  note    = (FAR struct note_common_s *)&g_note_info.ni_buffer[tail];
-  notelen = note->nc_length;
-  DEBUGASSERT(notelen <= circlen);
-
-errout_with_csection:
-  leave_critical_section(flags);
+  note_readunlock(flags);
   return notelen;
 }
 #endif
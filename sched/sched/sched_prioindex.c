@@ -0,0 +1,332 @@
+/****************************************************************************
+ * sched/sched/sched_prioindex.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <strings.h>
+#include <queue.h>
+#include <assert.h>
+
+#include "sched/sched.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define PRIOINDEX_NPRIO   (SCHED_PRIORITY_MAX + 1)
+#define PRIOINDEX_NWORDS  ((PRIOINDEX_NPRIO + 31) >> 5)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The index of one prioritized, ready-to-run task list.  A bit is set in
+ * pi_bitmap for each priority that has at least one TCB in the list and
+ * pi_tail[] holds the last (i.e., most recently added) TCB at each such
+ * priority.  The position at which a new TCB must be inserted is then
+ * just after the tail TCB of the lowest priority that is higher than or
+ * equal to its own.
+ */
+
+struct sched_prioindex_s
+{
+  uint32_t pi_bitmap[PRIOINDEX_NWORDS];
+  FAR struct tcb_s *pi_tail[PRIOINDEX_NPRIO];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct sched_prioindex_s g_readytorun_index;
+static struct sched_prioindex_s g_pendingtasks_index;
+#ifdef CONFIG_SMP
+static struct sched_prioindex_s g_assignedtasks_index[CONFIG_SMP_NCPUS];
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_prioindex
+ *
+ * Description:
+ *   Return the index associated with a task list or NULL if the list is
+ *   not indexed.  Only the ready-to-run lists are indexed; the prioritized
+ *   blocked task lists are normally short and are still searched.
+ *
+ ****************************************************************************/
+
+static FAR struct sched_prioindex_s *
+sched_prioindex(DSEG dq_queue_t *list)
+{
+  if (list == (FAR dq_queue_t *)&g_readytorun)
+    {
+      return &g_readytorun_index;
+    }
+
+  if (list == (FAR dq_queue_t *)&g_pendingtasks)
+    {
+      return &g_pendingtasks_index;
+    }
+
+#ifdef CONFIG_SMP
+  if (list >= (FAR dq_queue_t *)&g_assignedtasks[0] &&
+      list <  (FAR dq_queue_t *)&g_assignedtasks[CONFIG_SMP_NCPUS])
+    {
+      return &g_assignedtasks_index[list -
+                                    (FAR dq_queue_t *)&g_assignedtasks[0]];
+    }
+#endif
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_prioindex_lookup
+ *
+ * Description:
+ *   Find the TCB after which a new TCB of priority 'sched_priority' must be
+ *   inserted into 'list':  The last TCB with the same priority if there is
+ *   one (so that TCBs of equal priority remain in FIFO order) or else the
+ *   last TCB of the next higher priority present in the list.
+ *
+ * Input Parameters:
+ *   list - The prioritized task list
+ *   sched_priority - The priority of the TCB to be inserted
+ *   prev - The location to return the TCB.  NULL is returned if the new
+ *          TCB belongs at the head of the list.
+ *
+ * Returned Value:
+ *   true if the list is indexed and 'prev' is valid; false if the caller
+ *   must search the list.
+ *
+ * Assumptions:
+ *   Called from within a critical section.
+ *
+ ****************************************************************************/
+
+bool sched_prioindex_lookup(DSEG dq_queue_t *list, uint8_t sched_priority,
+                            FAR struct tcb_s **prev)
+{
+  FAR struct sched_prioindex_s *index;
+  uint32_t bits;
+  int word;
+
+  index = sched_prioindex(list);
+  if (index == NULL)
+    {
+      return false;
+    }
+
+  /* Look for the lowest priority present that is greater than or equal to
+   * the new priority.  Since the bitmap is bounded, this is a small,
+   * constant number of find-first-set operations.
+   */
+
+  word = sched_priority >> 5;
+  bits = index->pi_bitmap[word] & ~((1u << (sched_priority & 31)) - 1);
+
+  for (; ; )
+    {
+      if (bits != 0)
+        {
+          *prev = index->pi_tail[(word << 5) + ffs((int)bits) - 1];
+          DEBUGASSERT(*prev != NULL);
+          return true;
+        }
+
+      if (++word >= PRIOINDEX_NWORDS)
+        {
+          break;
+        }
+
+      bits = index->pi_bitmap[word];
+    }
+
+  /* There is nothing of equal or higher priority in the list */
+
+  *prev = NULL;
+  return true;
+}
+
+/****************************************************************************
+ * Name: sched_prioindex_insert
+ *
+ * Description:
+ *   Update the index after 'tcb' has been linked into 'list'.  The list
+ *   must already be in priority order.
+ *
+ * Input Parameters:
+ *   tcb - The TCB that was just added to the list
+ *   list - The prioritized task list
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called from within a critical section.
+ *
+ ****************************************************************************/
+
+void sched_prioindex_insert(FAR struct tcb_s *tcb, DSEG dq_queue_t *list)
+{
+  FAR struct sched_prioindex_s *index;
+  FAR struct tcb_s *next;
+  uint8_t sched_priority = tcb->sched_priority;
+
+  index = sched_prioindex(list);
+  if (index != NULL)
+    {
+      /* The TCB becomes the tail of its priority unless another TCB of the
+       * same priority follows it.
+       */
+
+      next = (FAR struct tcb_s *)tcb->flink;
+      if (next == NULL || next->sched_priority != sched_priority)
+        {
+          index->pi_tail[sched_priority] = tcb;
+        }
+
+      index->pi_bitmap[sched_priority >> 5] |=
+        (uint32_t)1 << (sched_priority & 31);
+    }
+}
+
+/****************************************************************************
+ * Name: sched_prioindex_remove
+ *
+ * Description:
+ *   Update the index before 'tcb' is unlinked from 'list'.  The TCB must
+ *   still be in the list and its priority must not have been changed since
+ *   it was added.
+ *
+ * Input Parameters:
+ *   tcb - The TCB that is about to be removed from the list
+ *   list - The prioritized task list
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called from within a critical section.
+ *
+ ****************************************************************************/
+
+void sched_prioindex_remove(FAR struct tcb_s *tcb, DSEG dq_queue_t *list)
+{
+  FAR struct sched_prioindex_s *index;
+  FAR struct tcb_s *prev;
+  uint8_t sched_priority = tcb->sched_priority;
+
+  index = sched_prioindex(list);
+  if (index != NULL && index->pi_tail[sched_priority] == tcb)
+    {
+      /* If another TCB with the same priority precedes this one, then
+       * that TCB becomes the new tail.  Otherwise, this was the only TCB
+       * with this priority.
+       */
+
+      prev = (FAR struct tcb_s *)tcb->blink;
+      if (prev != NULL && prev->sched_priority == sched_priority)
+        {
+          index->pi_tail[sched_priority] = prev;
+        }
+      else
+        {
+          index->pi_tail[sched_priority] = NULL;
+          index->pi_bitmap[sched_priority >> 5] &=
+            ~((uint32_t)1 << (sched_priority & 31));
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: sched_prioindex_rebuild
+ *
+ * Description:
+ *   Regenerate the index of 'list' from its content.  This is used after
+ *   operations that move entire lists, such as sched_mergeprioritized().
+ *
+ * Input Parameters:
+ *   list - The prioritized task list
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called from within a critical section.
+ *
+ ****************************************************************************/
+
+void sched_prioindex_rebuild(DSEG dq_queue_t *list)
+{
+  FAR struct sched_prioindex_s *index;
+  FAR struct tcb_s *tcb;
+  int i;
+
+  index = sched_prioindex(list);
+  if (index != NULL)
+    {
+      for (i = 0; i < PRIOINDEX_NWORDS; i++)
+        {
+          index->pi_bitmap[i] = 0;
+        }
+
+      for (i = 0; i < PRIOINDEX_NPRIO; i++)
+        {
+          index->pi_tail[i] = NULL;
+        }
+
+      for (tcb = (FAR struct tcb_s *)list->head;
+           tcb != NULL;
+           tcb = tcb->flink)
+        {
+          sched_prioindex_insert(tcb, list);
+        }
+    }
+}
@@ -101,6 +101,7 @@ bool sched_removereadytorun(FAR struct tcb_s *rtcb)
    * is always the g_readytorun list.
    */
 
+  sched_prioindex_remove(rtcb, (FAR dq_queue_t *)&g_readytorun);
   dq_rem((FAR dq_entry_t *)rtcb, (FAR dq_queue_t *)&g_readytorun);
 
   /* Since the TCB is not in any list, it is now invalid */
@@ -198,6 +199,7 @@ bool sched_removereadytorun(FAR struct tcb_s *rtcb)
        * or the g_assignedtasks[cpu] list.
        */
 
+      sched_prioindex_remove(rtcb, tasklist);
       dq_rem((FAR dq_entry_t *)rtcb, tasklist);
 
       /* Which task will go at the head of the list?  It will be either the
@@ -232,16 +234,30 @@ bool sched_removereadytorun(FAR struct tcb_s *rtcb)
         {
           FAR struct tcb_s *tmptcb;
 
-          /* The TCB at the head of the ready to run list has the higher
-           * priority.  Remove that task from the head of the g_readytorun
-           * list and add to the head of the g_assignedtasks[cpu] list.
+          /* The TCB from the ready to run list has the higher priority.
+           * Remove that task from the g_readytorun list and add to the
+           * head of the g_assignedtasks[cpu] list.  NOTE that this is not
+           * necessarily the head of the g_readytorun list:  That TCB may
+           * not be permitted to run on this CPU.
            */
 
-          tmptcb = (FAR struct tcb_s *)
-            dq_remfirst((FAR dq_queue_t *)&g_readytorun);
+          tmptcb = rtrtcb;
+          sched_prioindex_remove(tmptcb, (FAR dq_queue_t *)&g_readytorun);
+          dq_rem((FAR dq_entry_t *)tmptcb, (FAR dq_queue_t *)&g_readytorun);
 
           dq_addfirst((FAR dq_entry_t *)tmptcb, tasklist);
+          sched_prioindex_insert(tmptcb, tasklist);
 
+          /* If this CPU would otherwise have gone idle, then it has taken
+           * work that would otherwise have waited for a busy CPU.
+           */
+
+          if (nxttcb->flink == NULL)
+            {
+              sched_smp_stolen(cpu);
+            }
+
+          sched_smp_started(tmptcb, cpu);
           tmptcb->cpu = cpu;
           nxttcb = tmptcb;
         }
@@ -328,6 +344,7 @@ bool sched_removereadytorun(FAR struct tcb_s *rtcb)
        * g_assignedtasks[cpu] list.
        */
 
+      sched_prioindex_remove(rtcb, tasklist);
       dq_rem((FAR dq_entry_t *)rtcb, tasklist);
     }
 
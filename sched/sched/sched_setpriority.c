@@ -164,9 +164,25 @@ static inline void sched_running_setpriority(FAR struct tcb_s *tcb,
 
   else
     {
+#ifdef CONFIG_SCHED_PRIOINDEX
+      FAR dq_queue_t *tasklist;
+
+      /* The TCB stays at the head of its list, but the priority index of
+       * the list must still be updated.
+       */
+
+#  ifdef CONFIG_SMP
+      tasklist = TLIST_HEAD(tcb->task_state, tcb->cpu);
+#  else
+      tasklist = TLIST_HEAD(tcb->task_state);
+#  endif
+      sched_prioindex_remove(tcb, tasklist);
+#endif
+
       /* Change the task priority */
 
       tcb->sched_priority = (uint8_t)sched_priority;
+      sched_prioindex_insert(tcb, tasklist);
     }
 }
 
@@ -0,0 +1,95 @@
+/****************************************************************************
+ * sched/sched/sched_smpstats.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+#include <errno.h>
+
+#include <nuttx/sched.h>
+
+#include "sched/sched.h"
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* Per-CPU task placement statistics */
+
+struct smp_stats_s g_smpstats[CONFIG_SMP_NCPUS];
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_smpstats
+ *
+ * Description:
+ *   Return a snapshot of the scheduling statistics of one CPU:  How often
+ *   tasks were started on the same CPU that they last ran on, how often
+ *   they migrated to another CPU, and how often a CPU that would otherwise
+ *   have run its IDLE task took a task from the shared ready-to-run list.
+ *
+ * Input Parameters:
+ *   cpu   - The index of the CPU of interest
+ *   stats - The location to return the statistics
+ *
+ * Returned Value:
+ *   Zero (OK) if successful.  -EINVAL if the CPU index is not valid.
+ *
+ ****************************************************************************/
+
+int nxsched_smpstats(int cpu, FAR struct smp_stats_s *stats)
+{
+  irqstate_t lock;
+
+  if (cpu < 0 || cpu >= CONFIG_SMP_NCPUS || stats == NULL)
+    {
+      return -EINVAL;
+    }
+
+  /* The statistics are only modified with the task lists locked */
+
+  lock = sched_tasklist_lock();
+  memcpy(stats, &g_smpstats[cpu], sizeof(struct smp_stats_s));
+  sched_tasklist_unlock(lock);
+
+  return OK;
+}
@@ -47,6 +47,7 @@
 
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
+#include <nuttx/lockprof.h>
 
 #include "sched/sched.h"
 #include "semaphore/semaphore.h"
@@ -120,6 +121,7 @@ int nxsem_post(FAR sem_t *sem)
 
       ASSERT(sem->semcount < SEM_VALUE_MAX);
       nxsem_releaseholder(sem);
+      sched_lockprof_released(sem);
       sem->semcount++;
 
 #ifdef CONFIG_PRIORITY_INHERITANCE
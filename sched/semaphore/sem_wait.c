@@ -47,6 +47,7 @@
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
 #include <nuttx/cancelpt.h>
+#include <nuttx/lockprof.h>
 
 #include "sched/sched.h"
 #include "semaphore/semaphore.h"
@@ -88,11 +89,35 @@ int nxsem_wait(FAR sem_t *sem)
   FAR struct tcb_s *rtcb = this_task();
   irqstate_t flags;
   int ret = -EINVAL;
+#ifdef CONFIG_SCHED_LOCKPROF
+  FAR void *caller;
+  uint8_t type;
+  uint32_t start;
+#endif
 
   /* This API should not be called from interrupt handlers */
 
   DEBUGASSERT(sem != NULL && up_interrupt_context() == false);
 
+#ifdef CONFIG_SCHED_LOCKPROF
+  /* Keep the lock profile for the caller provided by sem_wait() or
+   * pthread_mutex_lock(), if any, rather than for the caller of this
+   * function.
+   */
+
+  caller = rtcb->lockprof_caller;
+  type   = rtcb->lockprof_type;
+
+  if (caller == NULL)
+    {
+      caller = LOCKPROF_CALLER();
+      type   = LOCKPROF_SEMAPHORE;
+    }
+
+  sched_lockprof_hint(rtcb, NULL, LOCKPROF_SEMAPHORE);
+  start = sched_lockprof_start();
+#endif
+
   /* The following operations must be performed with interrupts
    * disabled because nxsem_post() may be called from an interrupt
    * handler.
@@ -114,6 +139,8 @@ int nxsem_wait(FAR sem_t *sem)
           nxsem_addholder(sem);
           rtcb->waitsem = NULL;
           ret = OK;
+
+          sched_lockprof_acquired(sem, caller, type, start, false);
         }
 
       /* The semaphore is NOT available, We will have to block the
@@ -200,6 +227,13 @@ int nxsem_wait(FAR sem_t *sem)
           ret           = rtcb->pterrno != OK ? -rtcb->pterrno : OK;
           rtcb->pterrno = saved_errno;
 
+#ifdef CONFIG_SCHED_LOCKPROF
+          if (ret == OK)
+            {
+              sched_lockprof_acquired(sem, caller, type, start, true);
+            }
+#endif
+
 #ifdef CONFIG_PRIORITY_INHERITANCE
           sched_unlock();
 #endif
@@ -252,6 +286,7 @@ int sem_wait(FAR sem_t *sem)
 
   /* Let nxsem_wait() do the real work */
 
+  sched_lockprof_hint(this_task(), LOCKPROF_CALLER(), LOCKPROF_SEMAPHORE);
   ret = nxsem_wait(sem);
   if (ret < 0)
     {
@@ -45,6 +45,7 @@
 
 #include <nuttx/spinlock.h>
 #include <nuttx/sched_note.h>
+#include <nuttx/lockprof.h>
 #include <arch/irq.h>
 
 #include "sched/sched.h"
@@ -120,6 +121,11 @@ void spin_initializer(FAR struct spinlock_s *lock)
 
 void spin_lock(FAR volatile spinlock_t *lock)
 {
+#ifdef CONFIG_SCHED_LOCKPROF
+  uint32_t start = sched_lockprof_start();
+  bool contended = false;
+#endif
+
 #ifdef CONFIG_SCHED_INSTRUMENTATION_SPINLOCKS
   /* Notify that we are waiting for a spinlock */
 
@@ -128,6 +134,9 @@ void spin_lock(FAR volatile spinlock_t *lock)
 
   while (up_testset(lock) == SP_LOCKED)
     {
+#ifdef CONFIG_SCHED_LOCKPROF
+      contended = true;
+#endif
       SP_DSB();
     }
 
@@ -137,6 +146,13 @@ void spin_lock(FAR volatile spinlock_t *lock)
   sched_note_spinlocked(this_task(), lock);
 #endif
   SP_DMB();
+
+#ifdef CONFIG_SCHED_LOCKPROF
+  /* Account for the acquisition in the lock profile */
+
+  sched_lockprof_acquired((FAR const void *)lock, LOCKPROF_CALLER(),
+                          LOCKPROF_SPINLOCK, start, contended);
+#endif
 }
 
 /****************************************************************************
@@ -0,0 +1,198 @@
+/****************************************************************************
+ * sched/semaphore/spinlock_holdtime.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/irq.h>
+#include <nuttx/spinlock.h>
+
+#ifdef CONFIG_SPINLOCK_HOLDTIME
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The list of registered locks and the spinlock that protects it */
+
+static FAR struct spinlock_holdtime_s *g_holdtime_head;
+static volatile spinlock_t g_holdtime_lock SP_SECTION = SP_UNLOCKED;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: spin_holdtime_register
+ *
+ * Description:
+ *   Add a hold time statistics structure to the list of instrumented locks
+ *   reported by /proc/locks.  The structure must persist for the life of
+ *   the system.
+ *
+ * Input Parameters:
+ *   ht   - The hold time statistics structure to register
+ *   name - The name of the lock
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void spin_holdtime_register(FAR struct spinlock_holdtime_s *ht,
+                            FAR const char *name)
+{
+  irqstate_t flags;
+
+  ht->ht_name  = name;
+  ht->ht_held  = false;
+  ht->ht_count = 0;
+  ht->ht_max   = 0;
+  ht->ht_total = 0;
+
+  flags = up_irq_save();
+  spin_lock(&g_holdtime_lock);
+
+  ht->ht_flink    = g_holdtime_head;
+  g_holdtime_head = ht;
+
+  spin_unlock(&g_holdtime_lock);
+  up_irq_restore(flags);
+}
+
+/****************************************************************************
+ * Name: spin_holdtime_begin
+ *
+ * Description:
+ *   Mark the beginning of a period in which the lock described by 'ht' is
+ *   held.  Must be called just after the lock has been taken.
+ *
+ * Input Parameters:
+ *   ht - The hold time statistics structure of the lock
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void spin_holdtime_begin(FAR struct spinlock_holdtime_s *ht)
+{
+  ht->ht_start = up_perf_gettime();
+  ht->ht_held  = true;
+}
+
+/****************************************************************************
+ * Name: spin_holdtime_end
+ *
+ * Description:
+ *   Mark the end of a period in which the lock described by 'ht' is held
+ *   and account for the elapsed time.  Must be called just before the lock
+ *   is released.
+ *
+ * Input Parameters:
+ *   ht - The hold time statistics structure of the lock
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void spin_holdtime_end(FAR struct spinlock_holdtime_s *ht)
+{
+  uint32_t elapsed;
+
+  /* Ignore the release if we did not see the lock being taken.  That can
+   * happen if the lock was taken before it was registered.
+   */
+
+  if (ht->ht_held)
+    {
+      /* Unsigned arithmetic handles the wrap-around of the counter */
+
+      elapsed      = up_perf_gettime() - ht->ht_start;
+      ht->ht_held  = false;
+      ht->ht_count++;
+      ht->ht_total += elapsed;
+
+      if (elapsed > ht->ht_max)
+        {
+          ht->ht_max = elapsed;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: spin_holdtime_foreach
+ *
+ * Description:
+ *   Call the provided handler once for each registered lock.  The handler
+ *   is called with the registry locked and so must not block nor register
+ *   new locks.
+ *
+ * Input Parameters:
+ *   handler - The function to call for each lock
+ *   arg     - An opaque argument passed to the handler
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void spin_holdtime_foreach(spin_holdtime_handler_t handler, FAR void *arg)
+{
+  FAR struct spinlock_holdtime_s *ht;
+  irqstate_t flags;
+
+  flags = up_irq_save();
+  spin_lock(&g_holdtime_lock);
+
+  for (ht = g_holdtime_head; ht != NULL; ht = ht->ht_flink)
+    {
+      handler(ht, arg);
+    }
+
+  spin_unlock(&g_holdtime_lock);
+  up_irq_restore(flags);
+}
+
+#endif /* CONFIG_SPINLOCK_HOLDTIME */
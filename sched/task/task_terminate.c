@@ -159,6 +159,7 @@ int task_terminate(pid_t pid, bool nonblocking)
 
   /* Remove the task from the task list */
 
+  sched_prioindex_remove(dtcb, tasklist);
   dq_rem((FAR dq_entry_t *)dtcb, tasklist);
   dtcb->task_state = TSTATE_TASK_INVALID;
 
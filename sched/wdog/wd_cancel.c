@@ -72,8 +72,10 @@
 
 int wd_cancel(WDOG_ID wdog)
 {
+#ifndef CONFIG_WDOG_WHEEL
   FAR struct wdog_s *curr;
   FAR struct wdog_s *prev;
+#endif
   irqstate_t flags;
   int ret = -EINVAL;
 
@@ -81,7 +83,7 @@ int wd_cancel(WDOG_ID wdog)
    * cancellation is complete
    */
 
-  flags = enter_critical_section();
+  flags = wd_lock();
 
   /* Make sure that the watchdog is initialized (non-NULL) and is still
    * active.
@@ -89,6 +91,15 @@ int wd_cancel(WDOG_ID wdog)
 
   if (wdog != NULL && WDOG_ISACTIVE(wdog))
     {
+#ifdef CONFIG_WDOG_WHEEL
+      /* Unlink the watchdog from its timing wheel slot.  The interval
+       * timer is not reassessed:  If this was the next watchdog to expire,
+       * the interval timer will simply expire with nothing to do.
+       */
+
+      wd_wheel_remove(wdog);
+
+#else
       /* Search the g_wdactivelist for the target FCB.  We can't use sq_rem
        * to do this because there are additional operations that need to be
        * done.
@@ -139,9 +150,11 @@ int wd_cancel(WDOG_ID wdog)
           sched_timer_reassess();
         }
 
+      wdog->next = NULL;
+#endif
+
       /* Mark the watchdog inactive */
 
-      wdog->next = NULL;
       WDOG_CLRACTIVE(wdog);
 
       /* Return success */
@@ -149,6 +162,6 @@ int wd_cancel(WDOG_ID wdog)
       ret = OK;
     }
 
-  leave_critical_section(flags);
+  wd_unlock(flags);
   return ret;
 }
@@ -86,7 +86,7 @@ int wd_delete(WDOG_ID wdog)
    * it is being deallocated.
    */
 
-  flags = enter_critical_section();
+  flags = wd_lock();
 
   /* Check if the watchdog has been started. */
 
@@ -111,7 +111,7 @@ int wd_delete(WDOG_ID wdog)
        * We don't need interrupts disabled to do this.
        */
 
-      leave_critical_section(flags);
+      wd_unlock(flags);
       sched_kfree(wdog);
     }
 
@@ -126,14 +126,14 @@ int wd_delete(WDOG_ID wdog)
       sq_addlast((FAR sq_entry_t *)wdog, &g_wdfreelist);
       g_wdnfree++;
       DEBUGASSERT(g_wdnfree <= CONFIG_PREALLOC_WDOGS);
-      leave_critical_section(flags);
+      wd_unlock(flags);
     }
 
   /* This function should not be called for statically allocated timers. */
 
   else
     {
-      leave_critical_section(flags);
+      wd_unlock(flags);
     }
 
   /* Return success */
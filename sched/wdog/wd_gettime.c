@@ -71,9 +71,17 @@ int wd_gettime(WDOG_ID wdog)
 
   /* Verify the wdog */
 
-  flags = enter_critical_section();
+  flags = wd_lock();
   if (wdog != NULL && WDOG_ISACTIVE(wdog))
     {
+#ifdef CONFIG_WDOG_WHEEL
+      /* The lag holds the tick on which the watchdog expires */
+
+      int delay = (int)((uint32_t)wdog->lag - g_wdwheel.tick) + 1;
+
+      wd_unlock(flags);
+      return delay > 0 ? delay : 0;
+#else
       /* Traverse the watchdog list accumulating lag times until we find the
        * wdog that we are looking for
        */
@@ -88,12 +96,13 @@ int wd_gettime(WDOG_ID wdog)
           delay += curr->lag;
           if (curr == wdog)
             {
-              leave_critical_section(flags);
+              wd_unlock(flags);
               return delay;
             }
         }
+#endif
     }
 
-  leave_critical_section(flags);
+  wd_unlock(flags);
   return 0;
 }
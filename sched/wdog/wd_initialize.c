@@ -39,6 +39,7 @@
 
 #include <nuttx/config.h>
 
+#include <string.h>
 #include <queue.h>
 
 #include "wdog/wdog.h"
@@ -53,12 +54,14 @@
 
 sq_queue_t g_wdfreelist;
 
+#ifndef CONFIG_WDOG_WHEEL
 /* The g_wdactivelist data structure is a singly linked list ordered by
  * watchdog expiration time. When watchdog timers expire,the functions on
  * this linked list are removed and the function is called.
  */
 
 sq_queue_t g_wdactivelist;
+#endif
 
 /* This is the number of free, pre-allocated watchdog structures in the
  * g_wdfreelist.  This value is used to enforce a reserve for interrupt
@@ -108,7 +111,11 @@ void wd_initialize(void)
   /* Initialize watchdog lists */
 
   sq_init(&g_wdfreelist);
+#ifdef CONFIG_WDOG_WHEEL
+  memset(&g_wdwheel, 0, sizeof(struct wdog_wheel_s));
+#else
   sq_init(&g_wdactivelist);
+#endif
 
   /* The g_wdfreelist must be loaded at initialization time to hold the
    * configured number of watchdogs.
@@ -122,4 +129,10 @@ void wd_initialize(void)
   /* All watchdogs are free */
 
   g_wdnfree = CONFIG_PREALLOC_WDOGS;
+
+#if defined(WDOG_HAVE_LOCK) && defined(CONFIG_SPINLOCK_HOLDTIME)
+  /* Start collecting hold time statistics for the watchdog lock */
+
+  spin_holdtime_register(&g_wdhold, "wdog");
+#endif
 }
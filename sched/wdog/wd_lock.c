@@ -0,0 +1,227 @@
+/****************************************************************************
+ * sched/wdog/wd_lock.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/arch.h>
+#include <nuttx/spinlock.h>
+
+#include "sched/sched.h"
+#include "wdog/wdog.h"
+
+#ifdef WDOG_HAVE_LOCK
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define IMPOSSIBLE_CPU 0xff
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The spinlock that protects the watchdog lists, the CPU that holds it and
+ * the number of references that CPU has on the lock.
+ */
+
+static volatile spinlock_t g_wdlock SP_SECTION = SP_UNLOCKED;
+static volatile uint8_t g_wdcpu = IMPOSSIBLE_CPU;
+static uint16_t g_wdcount;
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#ifdef CONFIG_SPINLOCK_HOLDTIME
+/* Hold time statistics of the watchdog lock */
+
+struct spinlock_holdtime_s g_wdhold;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_waitlock
+ *
+ * Description:
+ *   Spin until g_wdlock is taken, unless there is a pending pause request
+ *   for this CPU.  This is the same logic as irq_waitlock():  The holder of
+ *   the lock may be running a watchdog function that readies a task and
+ *   so must pause this CPU.  Interrupts are disabled here, so waiting for
+ *   the lock without servicing the pause request would deadlock.
+ *
+ * Input Parameters:
+ *   cpu - The index of this CPU
+ *
+ * Returned Value:
+ *   True:  g_wdlock has been taken.
+ *   False: g_wdlock has not been taken, but there is a pending pause
+ *          request.
+ *
+ ****************************************************************************/
+
+static inline bool wd_waitlock(int cpu)
+{
+  while (spin_trylock(&g_wdlock) == SP_LOCKED)
+    {
+      if (up_cpu_pausereq(cpu))
+        {
+          return false;
+        }
+
+      SP_DSB();
+    }
+
+  SP_DMB();
+  return true;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_lock
+ *
+ * Description:
+ *   Lock the watchdog lists.  Local interrupts are disabled because
+ *   watchdogs may be started and cancelled from interrupt handlers;  the
+ *   spinlock serializes access from the other CPUs.
+ *
+ *   While waiting for the lock, pause requests from other CPUs are
+ *   serviced:  wd_timer() holds the lock while the watchdog functions run
+ *   and these may pause this CPU in order to ready a task.
+ *
+ *   The lock is re-entrant on the CPU that holds it.  Since interrupts are
+ *   disabled while the lock is held, a nested call can only come from the
+ *   same thread of execution, i.e., from a watchdog function called by
+ *   wd_timer().
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   The interrupt state to be passed to wd_unlock().
+ *
+ ****************************************************************************/
+
+irqstate_t wd_lock(void)
+{
+  irqstate_t flags;
+  uint8_t cpu;
+
+try_again:
+  flags = up_irq_save();
+  cpu   = this_cpu();
+
+  if (g_wdcpu == cpu)
+    {
+      /* We already hold the lock on this CPU */
+
+      DEBUGASSERT(g_wdcount > 0 && g_wdcount < UINT16_MAX);
+      g_wdcount++;
+    }
+  else
+    {
+      while (!wd_waitlock(cpu))
+        {
+          /* Another CPU is waiting for this CPU to pause.  In an interrupt
+           * handler, service the pause request now.  Otherwise, briefly
+           * re-enable interrupts so that the pause interrupt is taken and
+           * try again (see enter_critical_section()).
+           */
+
+          if (up_interrupt_context())
+            {
+              DEBUGVERIFY(up_cpu_paused(cpu));
+            }
+          else
+            {
+              up_irq_restore(flags);
+              goto try_again;
+            }
+        }
+
+      spin_holdtime_begin(&g_wdhold);
+
+      g_wdcpu   = cpu;
+      g_wdcount = 1;
+    }
+
+  return flags;
+}
+
+/****************************************************************************
+ * Name: wd_unlock
+ *
+ * Description:
+ *   Release one count on the watchdog lock and restore the interrupt state.
+ *
+ * Input Parameters:
+ *   flags - The value returned by wd_lock()
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void wd_unlock(irqstate_t flags)
+{
+  DEBUGASSERT(g_wdcpu == this_cpu() && g_wdcount > 0);
+
+  if (--g_wdcount == 0)
+    {
+      g_wdcpu = IMPOSSIBLE_CPU;
+
+      spin_holdtime_end(&g_wdhold);
+      spin_unlock(&g_wdlock);
+    }
+
+  up_irq_restore(flags);
+}
+
+#endif /* WDOG_HAVE_LOCK */
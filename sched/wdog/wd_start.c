@@ -91,6 +91,64 @@ typedef void (*wdentry4_t)(int argc, wdparm_t arg1, wdparm_t arg2,
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: wd_dispatch
+ *
+ * Description:
+ *   Execute the function associated with an expired watchdog.
+ *
+ * Input Parameters:
+ *   wdog - The expired watchdog.  It has already been removed from the
+ *          active watchdogs and marked inactive.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static inline void wd_dispatch(FAR struct wdog_s *wdog)
+{
+  /* Execute the watchdog function */
+
+  up_setpicbase(wdog->picbase);
+  switch (wdog->argc)
+    {
+      default:
+        DEBUGPANIC();
+        break;
+
+      case 0:
+        (*((wdentry0_t)(wdog->func)))(0);
+        break;
+
+#if CONFIG_MAX_WDOGPARMS > 0
+      case 1:
+        (*((wdentry1_t)(wdog->func)))(1, wdog->parm[0]);
+        break;
+#endif
+#if CONFIG_MAX_WDOGPARMS > 1
+      case 2:
+        (*((wdentry2_t)(wdog->func)))(2,
+                        wdog->parm[0], wdog->parm[1]);
+        break;
+#endif
+#if CONFIG_MAX_WDOGPARMS > 2
+      case 3:
+        (*((wdentry3_t)(wdog->func)))(3,
+                        wdog->parm[0], wdog->parm[1],
+                        wdog->parm[2]);
+        break;
+#endif
+#if CONFIG_MAX_WDOGPARMS > 3
+      case 4:
+        (*((wdentry4_t)(wdog->func)))(4,
+                        wdog->parm[0], wdog->parm[1],
+                        wdog->parm[2], wdog->parm[3]);
+        break;
+#endif
+    }
+}
+
 /****************************************************************************
  * Name: wd_expiration
  *
@@ -98,6 +156,9 @@ typedef void (*wdentry4_t)(int argc, wdparm_t arg1, wdparm_t arg2,
  *   Check if the timer for the watchdog at the head of list is ready to
  *   run.  If so, remove the watchdog from the list and execute it.
  *
+ *   If CONFIG_WDOG_WHEEL is selected, execute all of the watchdogs that
+ *   the timing wheel has moved to the list of expired watchdogs.
+ *
  * Input Parameters:
  *   None
  *
@@ -106,6 +167,31 @@ typedef void (*wdentry4_t)(int argc, wdparm_t arg1, wdparm_t arg2,
  *
  ****************************************************************************/
 
+#ifdef CONFIG_WDOG_WHEEL
+static inline void wd_expiration(void)
+{
+  FAR struct wdog_s *wdog;
+
+  /* The watchdog function may restart or cancel other expired watchdogs,
+   * so always take the one at the head of the list.
+   */
+
+  while ((wdog = g_wdwheel.expired) != NULL)
+    {
+      /* Remove the watchdog from the expired list and indicate that the
+       * watchdog is no longer active.
+       */
+
+      wd_wheel_remove(wdog);
+      WDOG_CLRACTIVE(wdog);
+
+      /* Execute the watchdog function */
+
+      wd_dispatch(wdog);
+    }
+}
+
+#else
 static inline void wd_expiration(void)
 {
   FAR struct wdog_s *wdog;
@@ -140,46 +226,11 @@ static inline void wd_expiration(void)
 
           /* Execute the watchdog function */
 
-          up_setpicbase(wdog->picbase);
-          switch (wdog->argc)
-            {
-              default:
-                DEBUGPANIC();
-                break;
-
-              case 0:
-                (*((wdentry0_t)(wdog->func)))(0);
-                break;
-
-#if CONFIG_MAX_WDOGPARMS > 0
-              case 1:
-                (*((wdentry1_t)(wdog->func)))(1, wdog->parm[0]);
-                break;
-#endif
-#if CONFIG_MAX_WDOGPARMS > 1
-              case 2:
-                (*((wdentry2_t)(wdog->func)))(2,
-                                wdog->parm[0], wdog->parm[1]);
-                break;
-#endif
-#if CONFIG_MAX_WDOGPARMS > 2
-              case 3:
-                (*((wdentry3_t)(wdog->func)))(3,
-                                wdog->parm[0], wdog->parm[1],
-                                wdog->parm[2]);
-                break;
-#endif
-#if CONFIG_MAX_WDOGPARMS > 3
-              case 4:
-                (*((wdentry4_t)(wdog->func)))(4,
-                                wdog->parm[0], wdog->parm[1],
-                                wdog->parm[2], wdog->parm[3]);
-                break;
-#endif
-            }
+          wd_dispatch(wdog);
         }
     }
 }
+#endif
 
 /****************************************************************************
  * Public Functions
@@ -222,10 +273,12 @@ static inline void wd_expiration(void)
 int wd_start(WDOG_ID wdog, int32_t delay, wdentry_t wdentry,  int argc, ...)
 {
   va_list ap;
+#ifndef CONFIG_WDOG_WHEEL
   FAR struct wdog_s *curr;
   FAR struct wdog_s *prev;
   FAR struct wdog_s *next;
   int32_t now;
+#endif
   irqstate_t flags;
   int i;
 
@@ -239,10 +292,10 @@ int wd_start(WDOG_ID wdog, int32_t delay, wdentry_t wdentry,  int argc, ...)
   /* Check if the watchdog has been started. If so, stop it.
    * NOTE:  There is a race condition here... the caller may receive
    * the watchdog between the time that wd_start is called and
-   * the critical section is established.
+   * the watchdog lock is taken.
    */
 
-  flags = enter_critical_section();
+  flags = wd_lock();
   if (WDOG_ISACTIVE(wdog))
     {
       wd_cancel(wdog);
@@ -288,6 +341,16 @@ int wd_start(WDOG_ID wdog, int32_t delay, wdentry_t wdentry,  int argc, ...)
   (void)sched_timer_cancel();
 #endif
 
+#ifdef CONFIG_WDOG_WHEEL
+  /* The watchdog expires when the timing wheel processes tick
+   * (g_wdwheel.tick + delay - 1).  Save that absolute time in the lag
+   * field and add the watchdog to the timing wheel.
+   */
+
+  wdog->lag = (int)(g_wdwheel.tick + (uint32_t)delay - 1);
+  wd_wheel_insert(wdog);
+
+#else
   /* Do the easy case first -- when the watchdog timer queue is empty. */
 
   if (g_wdactivelist.head == NULL)
@@ -373,9 +436,13 @@ int wd_start(WDOG_ID wdog, int32_t delay, wdentry_t wdentry,  int argc, ...)
         }
     }
 
-  /* Put the lag into the watchdog structure and mark it as active. */
+  /* Put the lag into the watchdog structure */
 
   wdog->lag = delay;
+#endif
+
+  /* Mark the watchdog as active. */
+
   WDOG_SETACTIVE(wdog);
 
 #ifdef CONFIG_SCHED_TICKLESS
@@ -387,7 +454,7 @@ int wd_start(WDOG_ID wdog, int32_t delay, wdentry_t wdentry,  int argc, ...)
   sched_timer_resume();
 #endif
 
-  leave_critical_section(flags);
+  wd_unlock(flags);
   return OK;
 }
 
@@ -419,12 +486,19 @@ int wd_start(WDOG_ID wdog, int32_t delay, wdentry_t wdentry,  int argc, ...)
 #ifdef CONFIG_SCHED_TICKLESS
 unsigned int wd_timer(int ticks)
 {
+#ifdef CONFIG_WDOG_WHEEL
+  int32_t next;
+#else
   FAR struct wdog_s *wdog;
+  int decr;
+#endif
 #ifdef CONFIG_SMP
   irqstate_t flags;
+#endif
+#ifdef WDOG_HAVE_LOCK
+  irqstate_t wdflags;
 #endif
   unsigned int ret;
-  int decr;
 
 #ifdef CONFIG_SMP
   /* We are in an interrupt handler as, as a consequence, interrupts are
@@ -439,6 +513,47 @@ unsigned int wd_timer(int ticks)
   flags = enter_critical_section();
 #endif
 
+#ifdef WDOG_HAVE_LOCK
+  /* The watchdog lock is held while the expired watchdog functions run so
+   * that they cannot race with wd_start() or wd_cancel() on another CPU.
+   * The lock is re-entrant so the watchdog functions may restart
+   * themselves.
+   */
+
+  wdflags = wd_lock();
+#endif
+
+#ifdef CONFIG_WDOG_WHEEL
+  /* Step the timing wheel from event to event through the interval that
+   * just expired.  Ticks with no event are skipped.
+   */
+
+  while (ticks > 0)
+    {
+      next = wd_wheel_next();
+      if (next < 0 || next >= ticks)
+        {
+          g_wdwheel.tick += ticks;
+          break;
+        }
+
+      g_wdwheel.tick += next;
+      ticks          -= next + 1;
+
+      /* Process the tick and execute the watchdogs that expired */
+
+      wd_wheel_tick();
+      wd_expiration();
+    }
+
+  /* Return the delay to the next event.  It may be a cascade of timing
+   * wheel slots rather than a watchdog expiration.
+   */
+
+  next = wd_wheel_next();
+  ret  = next < 0 ? 0 : (unsigned int)next + 1;
+
+#else
   /* Check if there are any active watchdogs to process */
 
   while (g_wdactivelist.head != NULL && ticks > 0)
@@ -473,6 +588,11 @@ unsigned int wd_timer(int ticks)
 
   ret = g_wdactivelist.head ?
           ((FAR struct wdog_s *)g_wdactivelist.head)->lag : 0;
+#endif
+
+#ifdef WDOG_HAVE_LOCK
+  wd_unlock(wdflags);
+#endif
 
 #ifdef CONFIG_SMP
   leave_critical_section(flags);
@@ -486,6 +606,9 @@ unsigned int wd_timer(int ticks)
 #else
 void wd_timer(void)
 {
+#ifdef WDOG_HAVE_LOCK
+  irqstate_t wdflags;
+#endif
 #ifdef CONFIG_SMP
   irqstate_t flags;
 
@@ -501,6 +624,21 @@ void wd_timer(void)
   flags = enter_critical_section();
 #endif
 
+#ifdef WDOG_HAVE_LOCK
+  /* Hold the watchdog lock while the expired watchdogs run.  See the
+   * tickless version of wd_timer() above.
+   */
+
+  wdflags = wd_lock();
+#endif
+
+#ifdef CONFIG_WDOG_WHEEL
+  /* Process this tick and execute the watchdogs that expired */
+
+  wd_wheel_tick();
+  wd_expiration();
+
+#else
   /* Check if there are any active watchdogs to process */
 
   if (g_wdactivelist.head)
@@ -513,6 +651,11 @@ void wd_timer(void)
 
       wd_expiration();
     }
+#endif
+
+#ifdef WDOG_HAVE_LOCK
+  wd_unlock(wdflags);
+#endif
 
 #ifdef CONFIG_SMP
   leave_critical_section(flags);
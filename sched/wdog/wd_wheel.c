@@ -0,0 +1,361 @@
+/****************************************************************************
+ * sched/wdog/wd_wheel.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <strings.h>
+#include <assert.h>
+
+#include <nuttx/wdog.h>
+
+#include "wdog/wdog.h"
+
+#ifdef CONFIG_WDOG_WHEEL
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The number of ticks covered by one slot at level 'l' */
+
+#define WDOG_WHEEL_SHIFT(l)   ((l) * WDOG_WHEEL_BITS)
+
+/* The number of ticks covered by all of the slots of levels 0..l */
+
+#define WDOG_WHEEL_RANGE(l)   ((uint32_t)1 << WDOG_WHEEL_SHIFT((l) + 1))
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* The g_wdwheel data structure holds all active watchdogs, sorted into the
+ * slots of the timing wheel by expiration time.
+ */
+
+struct wdog_wheel_s g_wdwheel;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_wheel_link
+ *
+ * Description:
+ *   Add a watchdog to the head of the list 'head'.
+ *
+ ****************************************************************************/
+
+static inline void wd_wheel_link(FAR struct wdog_s **head,
+                                 FAR struct wdog_s *wdog)
+{
+  wdog->next  = *head;
+  wdog->pprev = head;
+
+  if (*head != NULL)
+    {
+      (*head)->pprev = &wdog->next;
+    }
+
+  *head = wdog;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_cascade
+ *
+ * Description:
+ *   Re-insert all of the watchdogs in one slot of an upper level.  Each
+ *   watchdog moves to a lower level (or, if its expiration time is beyond
+ *   the range of the wheel, to another slot of the top level).
+ *
+ ****************************************************************************/
+
+static void wd_wheel_cascade(int level, int index)
+{
+  FAR struct wdog_s *wdog;
+  FAR struct wdog_s *next;
+
+  wdog = g_wdwheel.slot[level][index];
+  g_wdwheel.slot[level][index] = NULL;
+  g_wdwheel.bitmap[level] &= ~(1ul << index);
+
+  for (; wdog != NULL; wdog = next)
+    {
+      next = wdog->next;
+      wd_wheel_insert(wdog);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_wheel_insert
+ *
+ * Description:
+ *   Add an active watchdog to the timing wheel.  The lag field of the
+ *   watchdog must hold the absolute expiration time.
+ *
+ * Assumptions:
+ *   Called with the watchdog lock held (see wd_lock()).
+ *
+ ****************************************************************************/
+
+void wd_wheel_insert(FAR struct wdog_s *wdog)
+{
+  uint32_t expire = (uint32_t)wdog->lag;
+  int32_t delta   = (int32_t)(expire - g_wdwheel.tick);
+  int level;
+  int index;
+
+  /* A watchdog that is already due goes into the current slot */
+
+  if (delta < 0)
+    {
+      expire = g_wdwheel.tick;
+      delta  = 0;
+    }
+
+  /* Find the lowest level that covers the delay */
+
+  for (level = 0; level < WDOG_WHEEL_NLEVELS - 1; level++)
+    {
+      if ((uint32_t)delta < WDOG_WHEEL_RANGE(level))
+        {
+          break;
+        }
+    }
+
+  /* Delays beyond the range of the wheel wait in the last slot of the top
+   * level and are re-inserted when that slot cascades.
+   */
+
+  if ((uint32_t)delta >= WDOG_WHEEL_RANGE(level))
+    {
+      expire = g_wdwheel.tick + WDOG_WHEEL_RANGE(level) - 1;
+    }
+
+  index = (expire >> WDOG_WHEEL_SHIFT(level)) & WDOG_WHEEL_MASK;
+
+  wd_wheel_link(&g_wdwheel.slot[level][index], wdog);
+  g_wdwheel.bitmap[level] |= (1ul << index);
+  wdog->slot = (uint8_t)(level * WDOG_WHEEL_NSLOTS + index);
+}
+
+/****************************************************************************
+ * Name: wd_wheel_remove
+ *
+ * Description:
+ *   Remove a watchdog from the timing wheel (or from the list of expired
+ *   watchdogs).
+ *
+ * Assumptions:
+ *   Called with the watchdog lock held (see wd_lock()).
+ *
+ ****************************************************************************/
+
+void wd_wheel_remove(FAR struct wdog_s *wdog)
+{
+  int level;
+  int index;
+
+  DEBUGASSERT(wdog->pprev != NULL);
+
+  *wdog->pprev = wdog->next;
+  if (wdog->next != NULL)
+    {
+      wdog->next->pprev = wdog->pprev;
+    }
+
+  /* Clear the bit in the bitmap if the slot is now empty */
+
+  if (wdog->slot != WDOG_WHEEL_EXPIRED)
+    {
+      level = wdog->slot / WDOG_WHEEL_NSLOTS;
+      index = wdog->slot & WDOG_WHEEL_MASK;
+
+      if (g_wdwheel.slot[level][index] == NULL)
+        {
+          g_wdwheel.bitmap[level] &= ~(1ul << index);
+        }
+    }
+
+  wdog->next  = NULL;
+  wdog->pprev = NULL;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_next
+ *
+ * Description:
+ *   Return the number of ticks from g_wdwheel.tick until the next event:
+ *   Either the expiration of a watchdog or the cascade of a non-empty slot
+ *   of an upper level.  Zero means that there is an event at
+ *   g_wdwheel.tick.
+ *
+ * Returned Value:
+ *   The number of ticks until the next event or -1 if there are no active
+ *   watchdogs.
+ *
+ * Assumptions:
+ *   Called with the watchdog lock held (see wd_lock()).
+ *
+ ****************************************************************************/
+
+int32_t wd_wheel_next(void)
+{
+  uint32_t tick = g_wdwheel.tick;
+  uint32_t bitmap;
+  uint32_t delta;
+  uint32_t next = UINT32_MAX;
+  int shift;
+  int index;
+  int level;
+  int k;
+
+  for (level = 0; level < WDOG_WHEEL_NLEVELS; level++)
+    {
+      bitmap = g_wdwheel.bitmap[level];
+      if (bitmap == 0)
+        {
+          continue;
+        }
+
+      /* Rotate the bitmap so that bit 0 corresponds to the current slot
+       * of this level.
+       */
+
+      shift = WDOG_WHEEL_SHIFT(level);
+      index = (tick >> shift) & WDOG_WHEEL_MASK;
+
+      if (index != 0)
+        {
+          bitmap = (bitmap >> index) |
+                   (bitmap << (WDOG_WHEEL_NSLOTS - index));
+        }
+
+      /* The current slot of an upper level is processed on the next
+       * boundary of the level, unless we are exactly on that boundary now.
+       * Level 0 is always on a boundary.
+       */
+
+      if ((tick & (((uint32_t)1 << shift) - 1)) == 0)
+        {
+          k = ffs((int)bitmap) - 1;
+        }
+      else if ((bitmap & ~1ul) != 0)
+        {
+          k = ffs((int)(bitmap & ~1ul)) - 1;
+        }
+      else
+        {
+          k = WDOG_WHEEL_NSLOTS;
+        }
+
+      delta = ((((tick >> shift) + k) << shift) - tick);
+      if (delta < next)
+        {
+          next = delta;
+        }
+    }
+
+  return next == UINT32_MAX ? -1 : (int32_t)next;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_tick
+ *
+ * Description:
+ *   Process the tick g_wdwheel.tick:  Cascade the upper level slots that
+ *   are due and move the watchdogs that expire on this tick to the list of
+ *   expired watchdogs (g_wdwheel.expired).  Then advance g_wdwheel.tick.
+ *
+ * Assumptions:
+ *   Called with the watchdog lock held (see wd_lock()).
+ *
+ ****************************************************************************/
+
+void wd_wheel_tick(void)
+{
+  FAR struct wdog_s *wdog;
+  FAR struct wdog_s *next;
+  uint32_t tick = g_wdwheel.tick;
+  int level;
+  int index;
+
+  /* On a level 0 boundary, cascade the current slot of level 1.  On a
+   * level 1 boundary, also cascade the current slot of level 2, etc.
+   */
+
+  index = tick & WDOG_WHEEL_MASK;
+  for (level = 1; index == 0 && level < WDOG_WHEEL_NLEVELS; level++)
+    {
+      index = (tick >> WDOG_WHEEL_SHIFT(level)) & WDOG_WHEEL_MASK;
+      if ((g_wdwheel.bitmap[level] & (1ul << index)) != 0)
+        {
+          wd_wheel_cascade(level, index);
+        }
+    }
+
+  /* Move the watchdogs in the current level 0 slot to the expired list */
+
+  index = tick & WDOG_WHEEL_MASK;
+  wdog  = g_wdwheel.slot[0][index];
+
+  if (wdog != NULL)
+    {
+      g_wdwheel.slot[0][index] = NULL;
+      g_wdwheel.bitmap[0] &= ~(1ul << index);
+
+      for (; wdog != NULL; wdog = next)
+        {
+          next       = wdog->next;
+          wdog->slot = WDOG_WHEEL_EXPIRED;
+          wd_wheel_link(&g_wdwheel.expired, wdog);
+        }
+    }
+
+  g_wdwheel.tick = tick + 1;
+}
+
+#endif /* CONFIG_WDOG_WHEEL */
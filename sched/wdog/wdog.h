@@ -46,8 +46,62 @@
 #include <stdbool.h>
 
 #include <nuttx/compiler.h>
+#include <nuttx/irq.h>
+#include <nuttx/spinlock.h>
 #include <nuttx/wdog.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_WDOG_WHEEL
+/* Timing wheel geometry.  Each level of the timing wheel has 32 slots (one
+ * bit of a uint32_t bitmap per slot).  A slot at level n holds the watchdog
+ * timers that expire within one 32**n tick period.
+ */
+
+#  define WDOG_WHEEL_BITS     5
+#  define WDOG_WHEEL_NSLOTS   (1 << WDOG_WHEEL_BITS)
+#  define WDOG_WHEEL_MASK     (WDOG_WHEEL_NSLOTS - 1)
+#  define WDOG_WHEEL_NLEVELS  CONFIG_WDOG_WHEEL_NLEVELS
+
+/* Slot value of expired watchdogs that are waiting to be run */
+
+#  define WDOG_WHEEL_EXPIRED  0xff
+#endif
+
+/* In the SMP case, the watchdog lists are protected by a dedicated spinlock
+ * (with local interrupts disabled) rather than by the global critical
+ * section.  In tickless mode, the critical section is still used because
+ * the interval timer logic (sched_timer_*) relies on it.
+ */
+
+#if defined(CONFIG_SMP) && !defined(CONFIG_SCHED_TICKLESS)
+#  define WDOG_HAVE_LOCK 1
+#else
+#  define wd_lock()         enter_critical_section()
+#  define wd_unlock(f)      leave_critical_section(f)
+#endif
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+#ifdef CONFIG_WDOG_WHEEL
+/* This is the hierarchical timing wheel.  The lag field of each active
+ * watchdog holds its absolute expiration time (in ticks) rather than the
+ * delay relative to the preceding watchdog.
+ */
+
+struct wdog_wheel_s
+{
+  uint32_t tick;                               /* Next tick to be processed */
+  uint32_t bitmap[WDOG_WHEEL_NLEVELS];         /* Non-empty slots */
+  FAR struct wdog_s *slot[WDOG_WHEEL_NLEVELS][WDOG_WHEEL_NSLOTS];
+  FAR struct wdog_s *expired;                  /* Expired, waiting to run */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -66,12 +120,20 @@ extern "C"
 
 extern sq_queue_t g_wdfreelist;
 
+#ifdef CONFIG_WDOG_WHEEL
+/* The g_wdwheel data structure holds all active watchdogs, sorted into the
+ * slots of the timing wheel by expiration time.
+ */
+
+extern struct wdog_wheel_s g_wdwheel;
+#else
 /* The g_wdactivelist data structure is a singly linked list ordered by
  * watchdog expiration time. When watchdog timers expire,the functions on
  * this linked list are removed and the function is called.
  */
 
 extern sq_queue_t g_wdactivelist;
+#endif
 
 /* This is the number of free, pre-allocated watchdog structures in the
  * g_wdfreelist.  This value is used to enforce a reserve for interrupt
@@ -80,6 +142,12 @@ extern sq_queue_t g_wdactivelist;
 
 extern uint16_t g_wdnfree;
 
+#if defined(WDOG_HAVE_LOCK) && defined(CONFIG_SPINLOCK_HOLDTIME)
+/* Hold time statistics of the watchdog lock */
+
+extern struct spinlock_holdtime_s g_wdhold;
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -136,6 +204,102 @@ unsigned int wd_timer(int ticks);
 void wd_timer(void);
 #endif
 
+/****************************************************************************
+ * Name: wd_wheel_insert
+ *
+ * Description:
+ *   Add an active watchdog to the timing wheel.  The lag field of the
+ *   watchdog must hold the absolute expiration time.
+ *
+ * Assumptions:
+ *   Called with the watchdog lock held (see wd_lock()).
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_WDOG_WHEEL
+void wd_wheel_insert(FAR struct wdog_s *wdog);
+#endif
+
+/****************************************************************************
+ * Name: wd_wheel_remove
+ *
+ * Description:
+ *   Remove a watchdog from the timing wheel (or from the list of expired
+ *   watchdogs).
+ *
+ * Assumptions:
+ *   Called with the watchdog lock held (see wd_lock()).
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_WDOG_WHEEL
+void wd_wheel_remove(FAR struct wdog_s *wdog);
+#endif
+
+/****************************************************************************
+ * Name: wd_wheel_next
+ *
+ * Description:
+ *   Return the number of ticks from g_wdwheel.tick until the next event:
+ *   Either the expiration of a watchdog or the cascade of a non-empty slot
+ *   of an upper level.  Zero means that there is an event at
+ *   g_wdwheel.tick.
+ *
+ * Returned Value:
+ *   The number of ticks until the next event or -1 if there are no active
+ *   watchdogs.
+ *
+ * Assumptions:
+ *   Called with the watchdog lock held (see wd_lock()).
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_WDOG_WHEEL
+int32_t wd_wheel_next(void);
+#endif
+
+/****************************************************************************
+ * Name: wd_wheel_tick
+ *
+ * Description:
+ *   Process the tick g_wdwheel.tick:  Cascade the upper level slots that
+ *   are due and move the watchdogs that expire on this tick to the list of
+ *   expired watchdogs (g_wdwheel.expired).  Then advance g_wdwheel.tick.
+ *
+ * Assumptions:
+ *   Called with the watchdog lock held (see wd_lock()).
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_WDOG_WHEEL
+void wd_wheel_tick(void);
+#endif
+
+/****************************************************************************
+ * Name: wd_lock and wd_unlock
+ *
+ * Description:
+ *   Lock or unlock the watchdog lists.  In the SMP case, local interrupts
+ *   are disabled and the watchdog spinlock is taken.  Otherwise, these are
+ *   simply the critical section.
+ *
+ *   The lock is re-entrant on the CPU that holds it:  The watchdog
+ *   functions run with the lock held and may call wd_start() or
+ *   wd_cancel().
+ *
+ * Input Parameters:
+ *   flags - The value returned by wd_lock()
+ *
+ * Returned Value:
+ *   wd_lock() returns the interrupt state to be passed to wd_unlock().
+ *
+ ****************************************************************************/
+
+#ifdef WDOG_HAVE_LOCK
+irqstate_t wd_lock(void);
+void wd_unlock(irqstate_t flags);
+#endif
+
 /****************************************************************************
  * Name: wd_recover
  *
@@ -55,6 +55,49 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: work_qremove
+ *
+ * Description:
+ *   Remove previously queued work from the work queue.  The work queue must
+ *   be locked by the caller.
+ *
+ * Input Parameters:
+ *   wqueue - The work queue
+ *   work   - The previously queue work structure to cancel
+ *
+ * Returned Value:
+ *   Zero (OK) on success, -ENOENT if there is no such work queued.
+ *
+ ****************************************************************************/
+
+static int work_qremove(FAR struct kwork_wqueue_s *wqueue,
+                        FAR struct work_s *work)
+{
+  int ret = -ENOENT;
+
+  if (work->worker != NULL)
+    {
+      /* A little test of the integrity of the work queue */
+
+      DEBUGASSERT(work->dq.flink != NULL ||
+                  (FAR dq_entry_t *)work == WORK_QUEUE(wqueue, work)->tail);
+      DEBUGASSERT(work->dq.blink != NULL ||
+                  (FAR dq_entry_t *)work == WORK_QUEUE(wqueue, work)->head);
+
+      /* Remove the entry from the work queue (ready or delayed) and make
+       * sure that it is marked as available (i.e., the worker field is
+       * nullified).
+       */
+
+      dq_rem((FAR dq_entry_t *)work, WORK_QUEUE(wqueue, work));
+      work->worker = NULL;
+      ret = OK;
+    }
+
+  return ret;
+}
+
 /****************************************************************************
  * Name: work_qcancel
  *
@@ -64,7 +107,7 @@
  *   again.
  *
  * Input Parameters:
- *   qid    - The work queue ID
+ *   wqueue - The work queue
  *   work   - The previously queue work structure to cancel
  *
  * Returned Value:
@@ -72,15 +115,15 @@
  *   reported:
  *
  *   -ENOENT - There is no such work queued.
- *   -EINVAL - An invalid work queue was specified
  *
  ****************************************************************************/
 
+#if !defined(CONFIG_SCHED_HPWORK_PERCPU) || defined(CONFIG_SCHED_LPWORK)
 static int work_qcancel(FAR struct kwork_wqueue_s *wqueue,
                         FAR struct work_s *work)
 {
   irqstate_t flags;
-  int ret = -ENOENT;
+  int ret;
 
   DEBUGASSERT(work != NULL);
 
@@ -89,28 +132,59 @@ static int work_qcancel(FAR struct kwork_wqueue_s *wqueue,
    * new work is typically added to the work queue from interrupt handlers.
    */
 
-  flags = enter_critical_section();
-  if (work->worker != NULL)
-    {
-      /* A little test of the integrity of the work queue */
+  flags = work_lock(wqueue);
+  ret   = work_qremove(wqueue, work);
+  work_unlock(wqueue, flags);
+  return ret;
+}
+#endif
 
-      DEBUGASSERT(work->dq.flink != NULL ||
-                  (FAR dq_entry_t *)work == wqueue->q.tail);
-      DEBUGASSERT(work->dq.blink != NULL ||
-                  (FAR dq_entry_t *)work == wqueue->q.head);
+/****************************************************************************
+ * Name: work_hpcancel
+ *
+ * Description:
+ *   Cancel previously queued high priority work.  The work can only be
+ *   pending on the queue of the CPU that it was last queued on, but it may
+ *   be moved to the queue of another CPU by work_queue_cpu() until that
+ *   queue is locked.
+ *
+ * Input Parameters:
+ *   work   - The previously queue work structure to cancel
+ *
+ * Returned Value:
+ *   Zero (OK) on success, -ENOENT if there is no such work queued.
+ *
+ ****************************************************************************/
 
-      /* Remove the entry from the work queue and make sure that it is
-       * marked as available (i.e., the worker field is nullified).
-       */
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+static int work_hpcancel(FAR struct work_s *work)
+{
+  FAR struct kwork_wqueue_s *wqueue;
+  irqstate_t flags;
+  int cpu;
+  int ret;
 
-      dq_rem((FAR dq_entry_t *)work, &wqueue->q);
-      work->worker = NULL;
-      ret = OK;
+  DEBUGASSERT(work != NULL);
+
+  for (; ; )
+    {
+      cpu    = WORK_CPU(work);
+      wqueue = (FAR struct kwork_wqueue_s *)&g_hpwork[cpu];
+      flags  = work_lock(wqueue);
+
+      if (WORK_CPU(work) == cpu)
+        {
+          break;
+        }
+
+      work_unlock(wqueue, flags);
     }
 
-  leave_critical_section(flags);
+  ret = work_qremove(wqueue, work);
+  work_unlock(wqueue, flags);
   return ret;
 }
+#endif
 
 /****************************************************************************
  * Public Functions
@@ -144,7 +218,11 @@ int work_cancel(int qid, FAR struct work_s *work)
     {
       /* Cancel high priority work */
 
-      return work_qcancel((FAR struct kwork_wqueue_s *)&g_hpwork, work);
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+      return work_hpcancel(work);
+#else
+      return work_qcancel((FAR struct kwork_wqueue_s *)&g_hpwork[0], work);
+#endif
     }
   else
 #endif
@@ -39,10 +39,18 @@
 
 #include <nuttx/config.h>
 
+#include <sched.h>
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
 #include <errno.h>
 #include <queue.h>
+#include <assert.h>
 #include <debug.h>
 
+#include <nuttx/sched.h>
+#include <nuttx/signal.h>
 #include <nuttx/wqueue.h>
 #include <nuttx/kthread.h>
 #include <nuttx/kmalloc.h>
@@ -52,13 +60,29 @@
 
 #ifdef CONFIG_SCHED_HPWORK
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define HPNAME_SIZE 12
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_SPINLOCK_HOLDTIME
+/* Names of the high priority work queue locks as shown in /proc/locks */
+
+static char g_hpname[HPWORK_NQUEUES][HPNAME_SIZE];
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
 
-/* The state of the kernel mode, high priority work queue. */
+/* The state of the kernel mode, high priority work queue(s). */
 
-struct hp_wqueue_s g_hpwork;
+struct hp_wqueue_s g_hpwork[HPWORK_NQUEUES];
 
 /****************************************************************************
  * Private Functions
@@ -78,6 +102,10 @@ struct hp_wqueue_s g_hpwork;
  *   That will be the higher priority worker thread only if a lower priority
  *   worker thread is available.
  *
+ *   If CONFIG_SCHED_HPWORK_PERCPU is selected, there is one high priority
+ *   worker thread for each CPU.  Only the thread of CPU0 performs garbage
+ *   collection.
+ *
  *   All kernel mode worker threads are started by the OS during normal
  *   bring up.  This entry point is referenced by OS internally and should
  *   not be accessed by application logic.
@@ -92,6 +120,35 @@ struct hp_wqueue_s g_hpwork;
 
 static int work_hpthread(int argc, char *argv[])
 {
+  FAR struct kwork_wqueue_s *wqueue;
+  sigset_t set;
+  int qndx = 0;
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+  pid_t me = getpid();
+
+  /* Find our work queue by searching the workers in g_hpwork */
+
+  for (qndx = 0; qndx < HPWORK_NQUEUES; qndx++)
+    {
+      if (g_hpwork[qndx].worker[0].pid == me)
+        {
+          break;
+        }
+    }
+
+  DEBUGASSERT(qndx < HPWORK_NQUEUES);
+#endif
+
+  wqueue = (FAR struct kwork_wqueue_s *)&g_hpwork[qndx];
+
+  /* Block SIGWORK.  The worker waits for SIGWORK in work_process() and a
+   * SIGWORK received while the worker is busy must remain pending.
+   */
+
+  sigemptyset(&set);
+  sigaddset(&set, SIGWORK);
+  (void)nxsig_procmask(SIG_BLOCK, &set, NULL);
+
   /* Loop forever */
 
   for (; ; )
@@ -108,15 +165,24 @@ static int work_hpthread(int argc, char *argv[])
        * thread instead.
        */
 
-      sched_garbage_collection();
+      if (qndx == 0)
+        {
+          sched_garbage_collection();
+        }
 #endif
 
       /* Then process queued work.  work_process will not return until: (1)
-       * there is no further work in the work queue, and (2) the polling
-       * period provided by g_hpwork.delay expires.
+       * there is no further work in the work queue, and (2) the next
+       * delayed work expires, the thread is signalled, or (if this thread
+       * performs garbage collection) the period provided by g_hpwork.delay
+       * expires.
        */
 
-      work_process((FAR struct kwork_wqueue_s *)&g_hpwork, g_hpwork.delay, 0);
+#ifdef CONFIG_SCHED_LPWORK
+      work_process(wqueue, 0, 0);
+#else
+      work_process(wqueue, qndx == 0 ? wqueue->delay : 0, 0);
+#endif
     }
 
   return OK; /* To keep some compilers happy */
@@ -130,45 +196,87 @@ static int work_hpthread(int argc, char *argv[])
  * Name: work_hpstart
  *
  * Description:
- *   Start the high-priority, kernel-mode work queue.
+ *   Start the high-priority, kernel-mode work queue(s).
  *
  * Input Parameters:
  *   None
  *
  * Returned Value:
  *   The task ID of the worker thread is returned on success.  A negated
- *   errno value is returned on failure.
+ *   errno value is returned on failure.  If there are per-CPU work queues,
+ *   the task ID of the worker thread of CPU0 is returned.
  *
  ****************************************************************************/
 
 int work_hpstart(void)
 {
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+  cpu_set_t cpuset;
+  int ret;
+#endif
   pid_t pid;
+  int qndx;
 
   /* Initialize work queue data structures */
 
-  g_hpwork.delay          = CONFIG_SCHED_HPWORKPERIOD / USEC_PER_TICK;
-  dq_init(&g_hpwork.q);
+  memset(g_hpwork, 0, sizeof(g_hpwork));
 
-  /* Start the high-priority, kernel mode worker thread */
+  for (qndx = 0; qndx < HPWORK_NQUEUES; qndx++)
+    {
+      g_hpwork[qndx].delay = CONFIG_SCHED_HPWORKPERIOD / USEC_PER_TICK;
+      dq_init(&g_hpwork[qndx].q);
+      dq_init(&g_hpwork[qndx].dlyq);
+#ifdef CONFIG_SMP
+      spin_initialize(&g_hpwork[qndx].lock, SP_UNLOCKED);
+#endif
+#ifdef CONFIG_SPINLOCK_HOLDTIME
+      snprintf(g_hpname[qndx], HPNAME_SIZE, "hpwork%d", qndx);
+      spin_holdtime_register(&g_hpwork[qndx].holdtime, g_hpname[qndx]);
+#endif
+    }
 
-  sinfo("Starting high-priority kernel worker thread\n");
+  /* Don't permit any of the threads to run until we have fully initialized
+   * g_hpwork.
+   */
 
-  pid = kthread_create(HPWORKNAME, CONFIG_SCHED_HPWORKPRIORITY,
-                       CONFIG_SCHED_HPWORKSTACKSIZE,
-                       (main_t)work_hpthread,
-                       (FAR char * const *)NULL);
+  sched_lock();
 
-  DEBUGASSERT(pid > 0);
-  if (pid < 0)
+  /* Start the high-priority, kernel mode worker thread(s) */
+
+  sinfo("Starting high-priority kernel worker thread(s)\n");
+
+  for (qndx = 0; qndx < HPWORK_NQUEUES; qndx++)
     {
-      serr("ERROR: kthread_create failed: %d\n", (int)pid);
-      return (int)pid;
+      pid = kthread_create(HPWORKNAME, CONFIG_SCHED_HPWORKPRIORITY,
+                           CONFIG_SCHED_HPWORKSTACKSIZE,
+                           (main_t)work_hpthread,
+                           (FAR char * const *)NULL);
+
+      DEBUGASSERT(pid > 0);
+      if (pid < 0)
+        {
+          serr("ERROR: kthread_create %d failed: %d\n", qndx, (int)pid);
+          sched_unlock();
+          return (int)pid;
+        }
+
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+      /* Bind the worker thread to its CPU */
+
+      CPU_ZERO(&cpuset);
+      CPU_SET(qndx, &cpuset);
+
+      ret = nxsched_setaffinity(pid, sizeof(cpu_set_t), &cpuset);
+      DEBUGASSERT(ret == OK);
+      UNUSED(ret);
+#endif
+
+      g_hpwork[qndx].worker[0].pid  = pid;
+      g_hpwork[qndx].worker[0].busy = true;
     }
 
-  g_hpwork.worker[0].pid  = pid;
-  g_hpwork.worker[0].busy = true;
-  return pid;
+  sched_unlock();
+  return g_hpwork[0].worker[0].pid;
 }
 
 #endif /* CONFIG_SCHED_HPWORK */
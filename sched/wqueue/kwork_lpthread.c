@@ -41,11 +41,13 @@
 
 #include <unistd.h>
 #include <sched.h>
+#include <signal.h>
 #include <string.h>
 #include <errno.h>
 #include <queue.h>
 #include <debug.h>
 
+#include <nuttx/signal.h>
 #include <nuttx/wqueue.h>
 #include <nuttx/kthread.h>
 #include <nuttx/kmalloc.h>
@@ -94,6 +96,7 @@ struct lp_wqueue_s g_lpwork;
 
 static int work_lpthread(int argc, char *argv[])
 {
+  sigset_t set;
 #if CONFIG_SCHED_LPNTHREADS > 0
   int wndx;
   pid_t me = getpid();
@@ -113,6 +116,14 @@ static int work_lpthread(int argc, char *argv[])
   DEBUGASSERT(i < CONFIG_SCHED_LPNTHREADS);
 #endif
 
+  /* Block SIGWORK.  The worker waits for SIGWORK in work_process() and a
+   * SIGWORK received while the worker is busy must remain pending.
+   */
+
+  sigemptyset(&set);
+  sigaddset(&set, SIGWORK);
+  (void)nxsig_procmask(SIG_BLOCK, &set, NULL);
+
   /* Loop forever */
 
   for (; ; )
@@ -147,8 +158,9 @@ static int work_lpthread(int argc, char *argv[])
           sched_garbage_collection();
 
           /* Then process queued work.  work_process will not return until:
-           * (1) there is no further work in the work queue, and (2) the polling
-           * period provided by g_lpwork.delay expires.
+           * (1) there is no further work in the work queue, and (2) the next
+           * delayed work expires, the thread is signalled, or the garbage
+           * collection period provided by g_lpwork.delay expires.
            */
 
           work_process((FAR struct kwork_wqueue_s *)&g_lpwork, g_lpwork.delay, 0);
@@ -188,6 +200,13 @@ int work_lpstart(void)
 
   g_lpwork.delay = CONFIG_SCHED_LPWORKPERIOD / USEC_PER_TICK;
   dq_init(&g_lpwork.q);
+  dq_init(&g_lpwork.dlyq);
+#ifdef CONFIG_SMP
+  spin_initialize(&g_lpwork.lock, SP_UNLOCKED);
+#endif
+#ifdef CONFIG_SPINLOCK_HOLDTIME
+  spin_holdtime_register(&g_lpwork.holdtime, "lpwork");
+#endif
 
   /* Don't permit any of the threads to run until we have fully initialized
    * g_lpwork.
@@ -50,6 +50,7 @@
 #include <nuttx/signal.h>
 #include <nuttx/wqueue.h>
 
+#include "clock/clock.h"
 #include "wqueue/wqueue.h"
 
 #ifdef CONFIG_SCHED_WORKQUEUE
@@ -68,10 +69,6 @@
 #  define WORK_CLOCK CLOCK_REALTIME
 #endif
 
-#ifndef MIN
-#  define MIN(a,b) ((a) < (b) ? (a) : (b))
-#endif
-
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -85,8 +82,14 @@
  *   part of the internal implementation of each work queue; it should not
  *   be called from application level logic.
  *
+ *   Work is performed until the ready queue is empty.  Then the first
+ *   worker thread waits until the next delayed work expires.  The other
+ *   worker threads wait until they are signalled.
+ *
  * Input Parameters:
  *   wqueue - Describes the work queue to be processed
+ *   period - The maximum time to wait (ticks).  Zero means no limit.
+ *   wndx   - The worker thread index
  *
  * Returned Value:
  *   None
@@ -100,171 +103,142 @@ void work_process(FAR struct kwork_wqueue_s *wqueue, systime_t period, int wndx)
   irqstate_t flags;
   FAR void *arg;
   systime_t elapsed;
-  systime_t remaining;
+  ssystime_t remaining;
   systime_t stick;
   systime_t ctick;
   systime_t next;
+  sigset_t set;
 
-  /* Then process queued work.  We need to keep interrupts disabled while
-   * we process items in the work list.
+  /* Then process queued work.  We need to keep the work queue locked
+   * while we process items in the work list.
    */
 
-  next  = period;
-  flags = enter_critical_section();
+  flags = work_lock(wqueue);
 
   /* Get the time that we started this polling cycle in clock ticks. */
 
   stick = clock_systimer();
 
-  /* And check each entry in the work queue.  Since we have disabled
-   * interrupts we know:  (1) we will not be suspended unless we do
-   * so ourselves, and (2) there will be no changes to the work queue
-   */
-
-  work = (FAR struct work_s *)wqueue->q.head;
-  while (work)
+  for (; ; )
     {
-      /* Is this work ready?  It is ready if there is no delay or if
-       * the delay has elapsed. qtime is the time that the work was added
-       * to the work queue.  It will always be greater than or equal to
-       * zero.  Therefore a delay of zero will always execute immediately.
+      /* Move all delayed work that has expired to the end of the ready
+       * queue.  The delayed work queue is in order of expiration so we
+       * only need to look at the head of the queue.
        */
 
-      ctick   = clock_systimer();
-      elapsed = ctick - work->qtime;
-      if (elapsed >= work->delay)
+      ctick = clock_systimer();
+      while ((work = (FAR struct work_s *)wqueue->dlyq.head) != NULL &&
+             (ssystime_t)(ctick - WORK_EXPIRATION(work)) >= 0)
         {
-          /* Remove the ready-to-execute work from the list */
-
-          (void)dq_rem((struct dq_entry_s *)work, &wqueue->q);
-
-          /* Extract the work description from the entry (in case the work
-           * instance by the re-used after it has been de-queued).
-           */
+          (void)dq_rem((FAR dq_entry_t *)work, &wqueue->dlyq);
+          work->delay = 0;
+          dq_addlast((FAR dq_entry_t *)work, &wqueue->q);
+        }
 
-          worker = work->worker;
+      /* Then take the next work from the ready queue */
 
-          /* Check for a race condition where the work may be nullified
-           * before it is removed from the queue.
-           */
+      work = (FAR struct work_s *)dq_remfirst(&wqueue->q);
+      if (work == NULL)
+        {
+          break;
+        }
 
-          if (worker != NULL)
-            {
-              /* Extract the work argument (before re-enabling interrupts) */
+      /* Extract the work description from the entry (in case the work
+       * instance by the re-used after it has been de-queued).
+       */
 
-              arg = work->arg;
+      worker = work->worker;
 
-              /* Mark the work as no longer being queued */
+      /* Check for a race condition where the work may be nullified
+       * before it is removed from the queue.
+       */
 
-              work->worker = NULL;
+      if (worker != NULL)
+        {
+          /* Extract the work argument (before re-enabling interrupts) */
 
-              /* Do the work.  Re-enable interrupts while the work is being
-               * performed... we don't have any idea how long this will take!
-               */
+          arg = work->arg;
 
-              leave_critical_section(flags);
-              worker(arg);
+          /* Mark the work as no longer being queued */
 
-              /* Now, unfortunately, since we re-enabled interrupts we don't
-               * know the state of the work list and we will have to start
-               * back at the head of the list.
-               */
+          work->worker = NULL;
 
-              flags = enter_critical_section();
-              work  = (FAR struct work_s *)wqueue->q.head;
-            }
-          else
-            {
-              /* Cancelled.. Just move to the next work in the list with
-               * interrupts still disabled.
-               */
+          /* Do the work.  Re-enable interrupts while the work is being
+           * performed... we don't have any idea how long this will take!
+           */
 
-              work = (FAR struct work_s *)work->dq.flink;
-            }
+          work_unlock(wqueue, flags);
+          worker(arg);
+          flags = work_lock(wqueue);
         }
-      else /* elapsed < work->delay */
-        {
-          /* This one is not ready.
-           *
-           * NOTE that elapsed is relative to the current time,
-           * not the time of beginning of this queue processing pass.
-           * So it may need an adjustment.
-           */
+    }
 
-          elapsed += (ctick - stick);
-          if (elapsed > work->delay)
-            {
-              /* The delay has expired while we are processing */
+  /* There is no more ready work.  Determine how long to wait.  A value of
+   * zero for next means that we should wait indefinitely until signalled.
+   * A non-zero period limits the wait so that the caller can perform its
+   * periodic housekeeping (i.e., garbage collection).
+   */
 
-              elapsed = work->delay;
-            }
+  next = 0;
+  if (period > 0)
+    {
+      elapsed = clock_systimer() - stick;
+      if (elapsed >= period)
+        {
+          work_unlock(wqueue, flags);
+          return;
+        }
 
-          /* Will it be ready before the next scheduled wakeup interval? */
+      next = period - elapsed;
+    }
 
-          remaining = work->delay - elapsed;
-          if (remaining < next)
-            {
-              /* Yes.. Then schedule to wake up when the work is ready */
+  /* The first worker thread also waits for the next delayed work to
+   * expire.
+   */
 
-              next = remaining;
-            }
+  work = (FAR struct work_s *)wqueue->dlyq.head;
+  if (wndx == 0 && work != NULL)
+    {
+      remaining = (ssystime_t)(WORK_EXPIRATION(work) - clock_systimer());
+      if (remaining <= 0)
+        {
+          /* The delay has expired while we were processing */
 
-          /* Then try the next in the list. */
+          work_unlock(wqueue, flags);
+          return;
+        }
 
-          work = (FAR struct work_s *)work->dq.flink;
+      if (next == 0 || (systime_t)remaining < next)
+        {
+          next = (systime_t)remaining;
         }
     }
 
-#if defined(CONFIG_SCHED_LPWORK) && CONFIG_SCHED_LPNTHREADS > 0
-  /* Value of zero for period means that we should wait indefinitely until
-   * signalled.  This option is used only for the case where there are
-   * multiple, low-priority worker threads.  In that case, only one of
-   * the threads does the poll... the others simple.  In all other cases
-   * period will be non-zero and equal to wqueue->delay.
+  /* Wait until the time elapses or until we are awakened by SIGWORK.  The
+   * worker is marked as idle before the work queue is unlocked.  SIGWORK is
+   * blocked on the worker threads so a signal sent after the work queue is
+   * unlocked, but before we wait, remains pending and is not lost.
    */
 
-  if (period == 0)
-    {
-      sigset_t set;
-
-      /* Wait indefinitely until signalled with SIGWORK */
+  wqueue->worker[wndx].busy = false;
+  work_unlock(wqueue, flags);
 
-      sigemptyset(&set);
-      sigaddset(&set, SIGWORK);
+  sigemptyset(&set);
+  sigaddset(&set, SIGWORK);
 
-      wqueue->worker[wndx].busy = false;
+  if (next == 0)
+    {
       DEBUGVERIFY(nxsig_waitinfo(&set, NULL));
-      wqueue->worker[wndx].busy = true;
     }
   else
-#endif
     {
-      /* Get the delay (in clock ticks) since we started the sampling */
-
-      elapsed = clock_systimer() - stick;
-      if (elapsed < period && next > 0)
-        {
-          /* How much time would we need to delay to get to the end of the
-           * sampling period?  The amount of time we delay should be the smaller
-           * of the time to the end of the sampling period and the time to the
-           * next work expiry.
-           */
-
-          remaining = period - elapsed;
-          next      = MIN(next, remaining);
+      struct timespec timeout;
 
-          /* Wait awhile to check the work list.  We will wait here until
-           * either the time elapses or until we are awakened by a signal.
-           * Interrupts will be re-enabled while we wait.
-           */
-
-          wqueue->worker[wndx].busy = false;
-          nxsig_usleep(next * USEC_PER_TICK);
-          wqueue->worker[wndx].busy = true;
-        }
+      (void)clock_ticks2time((ssystime_t)next, &timeout);
+      (void)nxsig_timedwait(&set, NULL, &timeout);
     }
 
-  leave_critical_section(flags);
+  wqueue->worker[wndx].busy = true;
 }
 
 #endif /* CONFIG_SCHED_WORKQUEUE */
@@ -40,6 +40,7 @@
 #include <nuttx/config.h>
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <queue.h>
 #include <assert.h>
 #include <errno.h>
@@ -58,57 +59,38 @@
  ****************************************************************************/
 
 /****************************************************************************
- * Name: work_qqueue
+ * Name: work_qinsert
  *
  * Description:
- *   Queue work to be performed at a later time.  All queued work will be
- *   performed on the worker thread of of execution (not the caller's).
- *
- *   The work structure is allocated by caller, but completely managed by
- *   the work queue logic.  The caller should never modify the contents of
- *   the work queue structure; the caller should not call work_qqueue()
- *   again until either (1) the previous work has been performed and removed
- *   from the queue, or (2) work_cancel() has been called to cancel the work
- *   and remove it from the work queue.
+ *   Add work to the ready or delayed work queue, replacing any pending
+ *   instance of the same work.  The work queue must be locked by the
+ *   caller.
  *
  * Input Parameters:
- *   qid    - The work queue ID (index)
- *   work   - The work structure to queue
- *   worker - The worker callback to be invoked.  The callback will invoked
- *            on the worker thread of execution.
- *   arg    - The argument that will be passed to the workder callback when
- *            int is invoked.
- *   delay  - Delay (in clock ticks) from the time queue until the worker
- *            is invoked. Zero means to perform the work immediately.
+ *   Same as work_qqueue()
  *
  * Returned Value:
- *   None
+ *   The number of worker threads that must be signalled once the work
+ *   queue has been unlocked (zero if none).
  *
  ****************************************************************************/
 
-static void work_qqueue(FAR struct kwork_wqueue_s *wqueue,
+static int work_qinsert(FAR struct kwork_wqueue_s *wqueue, int nthreads,
                         FAR struct work_s *work, worker_t worker,
                         FAR void *arg, systime_t delay)
 {
-  irqstate_t flags;
-
-  DEBUGASSERT(work != NULL && worker != NULL);
-
-  /* Interrupts are disabled so that this logic can be called from with task
-   * logic or ifrom nterrupt handling logic.
-   */
-
-  flags = enter_critical_section();
+  FAR struct work_s *prev;
+  systime_t expiration;
 
   /* Is there already pending work? */
 
   if (work->worker != NULL)
     {
-      /* Remove the entry from the work queue.  It will re requeued at the
-       * end of the work queue.
+      /* Remove the entry from the ready or delayed work queue.  It will be
+       * re-queued below with the new delay.
        */
 
-      dq_rem((FAR dq_entry_t *)work, &wqueue->q);
+      dq_rem((FAR dq_entry_t *)work, WORK_QUEUE(wqueue, work));
     }
 
   /* Initialize the work structure. */
@@ -121,9 +103,97 @@ static void work_qqueue(FAR struct kwork_wqueue_s *wqueue,
 
   work->qtime  = clock_systimer(); /* Time work queued */
 
-  dq_addlast((FAR dq_entry_t *)work, &wqueue->q);
+  if (delay == 0)
+    {
+      /* The work is ready now.  Add it to the end of the ready queue and
+       * wake up a worker thread to perform it.
+       */
+
+      dq_addlast((FAR dq_entry_t *)work, &wqueue->q);
+      return nthreads;
+    }
+
+  /* Search backward from the end of the delayed work queue for the last
+   * work that expires no later than this work.  New work is usually
+   * queued with a delay similar to the work already queued so this search
+   * is normally short.
+   */
+
+  expiration = WORK_EXPIRATION(work);
+  prev       = (FAR struct work_s *)wqueue->dlyq.tail;
+
+  while (prev != NULL &&
+         (ssystime_t)(WORK_EXPIRATION(prev) - expiration) > 0)
+    {
+      prev = (FAR struct work_s *)prev->dq.blink;
+    }
+
+  if (prev == NULL)
+    {
+      /* Only the first worker thread waits for delayed work to expire.  It
+       * needs to be awakened only if the next expiration time has changed.
+       */
+
+      dq_addfirst((FAR dq_entry_t *)work, &wqueue->dlyq);
+      return 1;
+    }
+
+  dq_addafter((FAR dq_entry_t *)prev, (FAR dq_entry_t *)work,
+              &wqueue->dlyq);
+  return 0;
+}
+
+/****************************************************************************
+ * Name: work_qqueue
+ *
+ * Description:
+ *   Queue work to be performed at a later time.  All queued work will be
+ *   performed on the worker thread of of execution (not the caller's).
+ *
+ *   The work structure is allocated by caller, but completely managed by
+ *   the work queue logic.  The caller should never modify the contents of
+ *   the work queue structure; the caller should not call work_qqueue()
+ *   again until either (1) the previous work has been performed and removed
+ *   from the queue, or (2) work_cancel() has been called to cancel the work
+ *   and remove it from the work queue.
+ *
+ *   Work with no delay is added to the end of the ready queue.  Delayed
+ *   work is inserted into the delayed work queue in order of expiration.
+ *   Work with the same expiration time is performed in the order queued.
+ *
+ * Input Parameters:
+ *   wqueue   - The work queue
+ *   nthreads - The number of worker threads of the work queue
+ *   work     - The work structure to queue
+ *   worker   - The worker callback to be invoked.  The callback will
+ *              invoked on the worker thread of execution.
+ *   arg      - The argument that will be passed to the workder callback
+ *              when int is invoked.
+ *   delay    - Delay (in clock ticks) from the time queue until the worker
+ *              is invoked. Zero means to perform the work immediately.
+ *
+ * Returned Value:
+ *   Zero (OK) on success, a negated errno on failure
+ *
+ ****************************************************************************/
+
+static int work_qqueue(FAR struct kwork_wqueue_s *wqueue, int nthreads,
+                       FAR struct work_s *work, worker_t worker,
+                       FAR void *arg, systime_t delay)
+{
+  irqstate_t flags;
+
+  DEBUGASSERT(work != NULL && worker != NULL);
+
+  /* Interrupts are disabled so that this logic can be called from with task
+   * logic or ifrom nterrupt handling logic.
+   */
+
+  flags    = work_lock(wqueue);
+  nthreads = work_qinsert(wqueue, nthreads, work, worker, arg, delay);
+  work_unlock(wqueue, flags);
 
-  leave_critical_section(flags);
+  return nthreads > 0 ? work_qsignal(wqueue, nthreads) : OK;
 }
 
 /****************************************************************************
@@ -167,10 +237,14 @@ int work_queue(int qid, FAR struct work_s *work, worker_t worker,
 #ifdef CONFIG_SCHED_HPWORK
   if (qid == HPWORK)
     {
-      /* Queue high priority work */
+      /* Queue high priority work (on the queue of this CPU) */
 
-      work_qqueue((FAR struct kwork_wqueue_s *)&g_hpwork, work, worker, arg, delay);
-      return work_signal(HPWORK);
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+      return work_queue_cpu(up_cpu_index(), work, worker, arg, delay);
+#else
+      return work_qqueue((FAR struct kwork_wqueue_s *)&g_hpwork[0], 1,
+                         work, worker, arg, delay);
+#endif
     }
   else
 #endif
@@ -179,8 +253,8 @@ int work_queue(int qid, FAR struct work_s *work, worker_t worker,
     {
       /* Queue low priority work */
 
-      work_qqueue((FAR struct kwork_wqueue_s *)&g_lpwork, work, worker, arg, delay);
-      return work_signal(LPWORK);
+      return work_qqueue((FAR struct kwork_wqueue_s *)&g_lpwork,
+                         CONFIG_SCHED_LPNTHREADS, work, worker, arg, delay);
     }
   else
 #endif
@@ -189,4 +263,109 @@ int work_queue(int qid, FAR struct work_s *work, worker_t worker,
     }
 }
 
+/****************************************************************************
+ * Name: work_queue_cpu
+ *
+ * Description:
+ *   Queue high priority work to be performed on a specific CPU.  This is
+ *   the same as work_queue(HPWORK, ...) except that the work is added to
+ *   the high priority work queue of the CPU 'cpu' rather than to the queue
+ *   of the current CPU.  If the work is already queued on another CPU, it
+ *   is first removed from that CPU's queue.
+ *
+ * Input Parameters:
+ *   cpu    - The CPU whose worker thread will perform the work
+ *   work   - The work structure to queue
+ *   worker - The worker callback to be invoked.  The callback will invoked
+ *            on the worker thread of execution.
+ *   arg    - The argument that will be passed to the workder callback when
+ *            int is invoked.
+ *   delay  - Delay (in clock ticks) from the time queue until the worker
+ *            is invoked. Zero means to perform the work immediately.
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+int work_queue_cpu(int cpu, FAR struct work_s *work, worker_t worker,
+                   FAR void *arg, systime_t delay)
+{
+  FAR struct kwork_wqueue_s *oldq;
+  FAR struct kwork_wqueue_s *newq;
+  FAR struct kwork_wqueue_s *lock1;
+  FAR struct kwork_wqueue_s *lock2;
+  irqstate_t flags1;
+  irqstate_t flags2 = 0;
+  int nthreads;
+  int oldcpu;
+
+  DEBUGASSERT(work != NULL && worker != NULL);
+
+  if (cpu < 0 || cpu >= CONFIG_SMP_NCPUS)
+    {
+      return -EINVAL;
+    }
+
+  newq = (FAR struct kwork_wqueue_s *)&g_hpwork[cpu];
+
+  /* Work can be in only one queue:  The queue of the CPU that it was last
+   * queued on.  Lock that queue and the new queue, then make sure that
+   * another queuer did not move the work while the locks were being taken.
+   * The two queues are always locked in CPU order so that work moved
+   * between the same two CPUs in opposite directions cannot deadlock.
+   */
+
+  for (; ; )
+    {
+      oldcpu = WORK_CPU(work);
+      oldq   = (FAR struct kwork_wqueue_s *)&g_hpwork[oldcpu];
+      lock1  = oldcpu < cpu ? oldq : newq;
+      lock2  = oldcpu < cpu ? newq : oldq;
+
+      flags1 = work_lock(lock1);
+      if (lock2 != lock1)
+        {
+          flags2 = work_lock(lock2);
+        }
+
+      if (WORK_CPU(work) == oldcpu)
+        {
+          break;
+        }
+
+      if (lock2 != lock1)
+        {
+          work_unlock(lock2, flags2);
+        }
+
+      work_unlock(lock1, flags1);
+    }
+
+  /* If the work is pending on a different CPU, then remove it from there.
+   * work_qinsert() will handle the case where the work is already pending
+   * on this CPU.
+   */
+
+  if (oldq != newq && work->worker != NULL)
+    {
+      dq_rem((FAR dq_entry_t *)work, WORK_QUEUE(oldq, work));
+      work->worker = NULL;
+    }
+
+  work->cpu = cpu;
+  nthreads  = work_qinsert(newq, 1, work, worker, arg, delay);
+
+  if (lock2 != lock1)
+    {
+      work_unlock(lock2, flags2);
+    }
+
+  work_unlock(lock1, flags1);
+
+  return nthreads > 0 ? work_qsignal(newq, nthreads) : OK;
+}
+#endif
+
 #endif /* CONFIG_SCHED_WORKQUEUE */
@@ -1,5 +1,5 @@
 /****************************************************************************
- * sched/wqueue/work_signal.c
+ * sched/wqueue/kwork_signal.c
  *
  *   Copyright (C) 2014, 2016-2017 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
@@ -42,6 +42,7 @@
 #include <signal.h>
 #include <errno.h>
 
+#include <nuttx/arch.h>
 #include <nuttx/wqueue.h>
 #include <nuttx/signal.h>
 
@@ -53,6 +54,46 @@
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: work_qsignal
+ *
+ * Description:
+ *   Wake up an idle worker thread of the work queue.  If all of the worker
+ *   threads are busy, nothing is done:  A busy worker thread will check
+ *   the work queue again before it waits.
+ *
+ * Input Parameters:
+ *   wqueue   - Describes the work queue
+ *   nthreads - The number of worker threads of the work queue
+ *
+ * Returned Value:
+ *   Zero (OK) on success, a negated errno value on failure
+ *
+ ****************************************************************************/
+
+int work_qsignal(FAR struct kwork_wqueue_s *wqueue, int nthreads)
+{
+  int i;
+
+  /* Find an IDLE worker thread */
+
+  for (i = 0; i < nthreads; i++)
+    {
+      /* Is this worker thread busy? */
+
+      if (!wqueue->worker[i].busy)
+        {
+          /* No.. signal this thread */
+
+          return nxsig_kill(wqueue->worker[i].pid, SIGWORK);
+        }
+    }
+
+  /* If all of the threads are busy, then just return successfully */
+
+  return OK;
+}
+
 /****************************************************************************
  * Name: work_signal
  *
@@ -71,56 +112,33 @@
 
 int work_signal(int qid)
 {
-  pid_t pid;
-
-  /* Get the process ID of the worker thread */
-
 #ifdef CONFIG_SCHED_HPWORK
   if (qid == HPWORK)
     {
-      pid = g_hpwork.worker[0].pid;
+      /* Signal the high priority worker thread (of this CPU) */
+
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+      return work_qsignal((FAR struct kwork_wqueue_s *)
+                          &g_hpwork[up_cpu_index()], 1);
+#else
+      return work_qsignal((FAR struct kwork_wqueue_s *)&g_hpwork[0], 1);
+#endif
     }
   else
 #endif
 #ifdef CONFIG_SCHED_LPWORK
   if (qid == LPWORK)
     {
-      int i;
-
-      /* Find an IDLE worker thread */
-
-      for (i = 0; i < CONFIG_SCHED_LPNTHREADS; i++)
-        {
-          /* Is this worker thread busy? */
+      /* Signal an IDLE low priority worker thread */
 
-          if (!g_lpwork.worker[i].busy)
-            {
-              /* No.. select this thread */
-
-              break;
-            }
-        }
-
-      /* If all of the IDLE threads are busy, then just return successfully */
-
-      if (i >= CONFIG_SCHED_LPNTHREADS)
-        {
-          return OK;
-        }
-
-      /* Otherwise, signal the first IDLE thread found */
-
-      pid = g_lpwork.worker[i].pid;
+      return work_qsignal((FAR struct kwork_wqueue_s *)&g_lpwork,
+                          CONFIG_SCHED_LPNTHREADS);
     }
   else
 #endif
     {
       return -EINVAL;
     }
-
-  /* Signal the worker thread */
-
-  return nxsig_kill(pid, SIGWORK);
 }
 
 #endif /* CONFIG_SCHED_WORKQUEUE */
@@ -47,6 +47,8 @@
 #include <queue.h>
 
 #include <nuttx/clock.h>
+#include <nuttx/irq.h>
+#include <nuttx/spinlock.h>
 
 #ifdef CONFIG_SCHED_WORKQUEUE
 
@@ -59,6 +61,44 @@
 #define HPWORKNAME "hpwork"
 #define LPWORKNAME "lpwork"
 
+/* Delayed work is kept in the delayed work queue, ordered by the time at
+ * which it expires.  When the delay expires, the work is moved to the end
+ * of the ready queue and its delay is set to zero.  So the queue that holds
+ * any queued work can be determined from its delay.
+ */
+
+#define WORK_EXPIRATION(w)    ((w)->qtime + (w)->delay)
+#define WORK_QUEUE(wq,w)      ((w)->delay == 0 ? &(wq)->q : &(wq)->dlyq)
+
+/* The number of high priority work queues:  One per CPU or just one */
+
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+#  define HPWORK_NQUEUES      CONFIG_SMP_NCPUS
+#else
+#  define HPWORK_NQUEUES      1
+#endif
+
+/* The CPU whose high priority work queue may hold the work.  The work
+ * structure is zeroed by the caller and work->cpu is only ever set to a
+ * valid CPU index, but never index g_hpwork[] with an out-of-range value.
+ * work->cpu only changes while that CPU's work queue is locked.
+ */
+
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+#  define WORK_CPU(w) \
+     ((w)->cpu < CONFIG_SMP_NCPUS ? (int)(w)->cpu : 0)
+#endif
+
+/* In the SMP case, each work queue is protected by its own spinlock (with
+ * local interrupts disabled) so that work queued on different queues does
+ * not contend for the global critical section.
+ */
+
+#ifndef CONFIG_SMP
+#  define work_lock(wq)       enter_critical_section()
+#  define work_unlock(wq,f)   leave_critical_section(f)
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -75,7 +115,14 @@ struct kworker_s
 struct kwork_wqueue_s
 {
   systime_t         delay;     /* Delay between polling cycles (ticks) */
-  struct dq_queue_s q;         /* The queue of pending work */
+  struct dq_queue_s q;         /* The queue of work ready to be performed */
+  struct dq_queue_s dlyq;      /* The queue of delayed work (by expiration) */
+#ifdef CONFIG_SMP
+  spinlock_t        lock;      /* Protects the work queues */
+#endif
+#ifdef CONFIG_SPINLOCK_HOLDTIME
+  struct spinlock_holdtime_s holdtime; /* Hold time statistics of lock */
+#endif
   struct kworker_s  worker[1]; /* Describes a worker thread */
 };
 
@@ -87,7 +134,14 @@ struct kwork_wqueue_s
 struct hp_wqueue_s
 {
   systime_t         delay;     /* Delay between polling cycles (ticks) */
-  struct dq_queue_s q;         /* The queue of pending work */
+  struct dq_queue_s q;         /* The queue of work ready to be performed */
+  struct dq_queue_s dlyq;      /* The queue of delayed work (by expiration) */
+#ifdef CONFIG_SMP
+  spinlock_t        lock;      /* Protects the work queues */
+#endif
+#ifdef CONFIG_SPINLOCK_HOLDTIME
+  struct spinlock_holdtime_s holdtime; /* Hold time statistics of lock */
+#endif
   struct kworker_s  worker[1]; /* Describes the single high priority worker */
 };
 #endif
@@ -100,7 +154,14 @@ struct hp_wqueue_s
 struct lp_wqueue_s
 {
   systime_t         delay;  /* Delay between polling cycles (ticks) */
-  struct dq_queue_s q;      /* The queue of pending work */
+  struct dq_queue_s q;      /* The queue of work ready to be performed */
+  struct dq_queue_s dlyq;   /* The queue of delayed work (by expiration) */
+#ifdef CONFIG_SMP
+  spinlock_t        lock;   /* Protects the work queues */
+#endif
+#ifdef CONFIG_SPINLOCK_HOLDTIME
+  struct spinlock_holdtime_s holdtime; /* Hold time statistics of lock */
+#endif
 
   /* Describes each thread in the low priority queue's thread pool */
 
@@ -113,9 +174,11 @@ struct lp_wqueue_s
  ****************************************************************************/
 
 #ifdef CONFIG_SCHED_HPWORK
-/* The state of the kernel mode, high priority work queue. */
+/* The state of the kernel mode, high priority work queue(s).  There is one
+ * queue for each CPU if CONFIG_SCHED_HPWORK_PERCPU is selected.
+ */
 
-extern struct hp_wqueue_s g_hpwork;
+extern struct hp_wqueue_s g_hpwork[HPWORK_NQUEUES];
 #endif
 
 #ifdef CONFIG_SCHED_LPWORK
@@ -166,6 +229,47 @@ int work_hpstart(void);
 int work_lpstart(void);
 #endif
 
+/****************************************************************************
+ * Name: work_lock and work_unlock
+ *
+ * Description:
+ *   Lock or unlock a work queue.  In the SMP case, local interrupts are
+ *   disabled and the work queue's spinlock is taken.  Otherwise, these are
+ *   equivalent to enter_critical_section() and leave_critical_section().
+ *
+ * Input Parameters:
+ *   wqueue - Describes the work queue to be locked
+ *   flags  - The value returned by work_lock()
+ *
+ * Returned Value:
+ *   work_lock() returns the interrupt state to be passed to work_unlock().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP
+irqstate_t work_lock(FAR struct kwork_wqueue_s *wqueue);
+void work_unlock(FAR struct kwork_wqueue_s *wqueue, irqstate_t flags);
+#endif
+
+/****************************************************************************
+ * Name: work_qsignal
+ *
+ * Description:
+ *   Wake up an idle worker thread of the work queue.  If all of the worker
+ *   threads are busy, nothing is done:  A busy worker thread will check
+ *   the work queue again before it waits.
+ *
+ * Input Parameters:
+ *   wqueue   - Describes the work queue
+ *   nthreads - The number of worker threads of the work queue
+ *
+ * Returned Value:
+ *   Zero (OK) on success, a negated errno value on failure
+ *
+ ****************************************************************************/
+
+int work_qsignal(FAR struct kwork_wqueue_s *wqueue, int nthreads);
+
 /****************************************************************************
  * Name: work_process
  *
@@ -177,7 +281,7 @@ int work_lpstart(void);
  *
  * Input Parameters:
  *   wqueue - Describes the work queue to be processed
- *   period - The polling period in clock ticks
+ *   period - The maximum time to wait in clock ticks (zero: no limit)
  *   wndx   - The worker thread index
  *
  * Returned Value:
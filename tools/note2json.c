@@ -0,0 +1,530 @@
+/****************************************************************************
+ * tools/note2json.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* These must agree with enum note_type_e in include/nuttx/sched_note.h */
+
+#define NOTE_START           0
+#define NOTE_STOP            1
+#define NOTE_SUSPEND         2
+#define NOTE_RESUME          3
+#define NOTE_CPU_START       4
+#define NOTE_CPU_STARTED     5
+#define NOTE_CPU_PAUSE       6
+#define NOTE_CPU_PAUSED      7
+#define NOTE_CPU_RESUME      8
+#define NOTE_CPU_RESUMED     9
+#define NOTE_PREEMPT_LOCK    10
+#define NOTE_PREEMPT_UNLOCK  11
+#define NOTE_CSECTION_ENTER  12
+#define NOTE_CSECTION_LEAVE  13
+#define NOTE_SPINLOCK_LOCK   14
+#define NOTE_SPINLOCK_LOCKED 15
+#define NOTE_SPINLOCK_UNLOCK 16
+#define NOTE_SPINLOCK_ABORT  17
+#define NTYPES               18
+
+#define MAX_NOTE             256
+#define MAX_PID              65536
+#define MAX_CPUS             32
+#define NAME_SIZE            32
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The decoded form of struct note_common_s */
+
+struct note_s
+{
+  unsigned int length;
+  unsigned int type;
+  unsigned int priority;
+  unsigned int cpu;
+  unsigned int pid;
+  uint32_t systime;
+  const uint8_t *data;       /* Type-specific data following the header */
+  unsigned int datalen;
+};
+
+/* What is running on each CPU */
+
+struct cpu_s
+{
+  bool running;
+  unsigned int pid;
+  double start;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const char *g_notename[NTYPES] =
+{
+  "start", "stop", "suspend", "resume",
+  "cpu start", "cpu started", "cpu pause", "cpu paused",
+  "cpu resume", "cpu resumed",
+  "preempt lock", "preempt unlock",
+  "csection enter", "csection leave",
+  "spinlock lock", "spinlock locked", "spinlock unlock", "spinlock abort"
+};
+
+static char (*g_taskname)[NAME_SIZE];
+static struct cpu_s g_cpu[MAX_CPUS];
+static bool g_smp;
+static unsigned int g_ptrsize = 4;
+static double g_freq = 100.0;
+static bool g_first = true;
+static unsigned int g_ncpus = 1;
+static FILE *g_out;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static void show_usage(const char *progname)
+{
+  fprintf(stderr, "USAGE: %s [-s] [-f <freq>] [-p <ptrsize>] "
+          "<note-file> [<json-file>]\n", progname);
+  fprintf(stderr, "\nConvert a binary scheduler note stream (as read from "
+          "/dev/note) to\n");
+  fprintf(stderr, "Chrome trace event JSON which may be viewed with "
+          "chrome://tracing or\n");
+  fprintf(stderr, "ui.perfetto.dev.\n\n");
+  fprintf(stderr, "  -s           Notes were generated by an SMP "
+          "configuration (CONFIG_SMP=y)\n");
+  fprintf(stderr, "  -f <freq>    Frequency of the time stamps in Hz.  "
+          "This is CLK_TCK\n");
+  fprintf(stderr, "               (default 100) or, with "
+          "CONFIG_SCHED_NOTE_PERFTIME,\n");
+  fprintf(stderr, "               the value returned by "
+          "up_perf_getfreq()\n");
+  fprintf(stderr, "  -p <ptrsize> Size of a target pointer in bytes "
+          "(default 4)\n");
+  fprintf(stderr, "  <json-file>  Output file (default stdout)\n");
+  exit(EXIT_FAILURE);
+}
+
+/* Return the name of a task or a generic name if it was never started */
+
+static const char *task_name(unsigned int pid)
+{
+  static char name[NAME_SIZE];
+
+  if (g_taskname[pid][0] != '\0')
+    {
+      return g_taskname[pid];
+    }
+
+  snprintf(name, NAME_SIZE, "pid %u", pid);
+  return name;
+}
+
+/* Output a string with JSON escapes */
+
+static void json_string(const char *str)
+{
+  fputc('"', g_out);
+  for (; *str != '\0'; str++)
+    {
+      if (*str == '"' || *str == '\\')
+        {
+          fprintf(g_out, "\\%c", *str);
+        }
+      else if ((unsigned char)*str < 0x20)
+        {
+          fprintf(g_out, "\\u%04x", (unsigned int)(unsigned char)*str);
+        }
+      else
+        {
+          fputc(*str, g_out);
+        }
+    }
+
+  fputc('"', g_out);
+}
+
+/* Begin a new event object; the caller finishes it with event_end() */
+
+static void event_begin(const char *name, const char *ph, unsigned int cpu,
+                        double ts)
+{
+  fprintf(g_out, "%s\n    {\"name\": ", g_first ? "" : ",");
+  json_string(name);
+  fprintf(g_out, ", \"ph\": \"%s\", \"pid\": 0, \"tid\": %u, "
+          "\"ts\": %.3f", ph, cpu, ts);
+  g_first = false;
+}
+
+static void event_end(void)
+{
+  fputc('}', g_out);
+}
+
+/* Close the slice of whatever is running on the CPU */
+
+static void cpu_idle(unsigned int cpu, double ts)
+{
+  struct cpu_s *cp = &g_cpu[cpu];
+
+  if (cp->running)
+    {
+      event_begin(task_name(cp->pid), "X", cpu, cp->start);
+      fprintf(g_out, ", \"dur\": %.3f, \"args\": {\"pid\": %u}",
+              ts - cp->start, cp->pid);
+      event_end();
+      cp->running = false;
+    }
+}
+
+/* Output an instantaneous event on the CPU track */
+
+static void instant(const struct note_s *note, double ts)
+{
+  unsigned int value;
+  unsigned long addr;
+  unsigned int i;
+
+  event_begin(note->type < NTYPES ? g_notename[note->type] : "unknown",
+              "i", note->cpu, ts);
+  fprintf(g_out, ", \"s\": \"t\", \"args\": {\"pid\": %u, \"task\": ",
+          note->pid);
+  json_string(task_name(note->pid));
+  fprintf(g_out, ", \"priority\": %u", note->priority);
+
+  switch (note->type)
+    {
+      case NOTE_CPU_START:
+      case NOTE_CPU_PAUSE:
+      case NOTE_CPU_RESUME:
+        if (note->datalen >= 1)
+          {
+            fprintf(g_out, ", \"target\": %u", note->data[0]);
+          }
+        break;
+
+      case NOTE_PREEMPT_LOCK:
+      case NOTE_PREEMPT_UNLOCK:
+      case NOTE_CSECTION_ENTER:
+      case NOTE_CSECTION_LEAVE:
+        if (note->datalen >= 2)
+          {
+            value = (unsigned int)note->data[1] << 8 | note->data[0];
+            fprintf(g_out, ", \"count\": %u", value);
+          }
+        break;
+
+      case NOTE_SPINLOCK_LOCK:
+      case NOTE_SPINLOCK_LOCKED:
+      case NOTE_SPINLOCK_UNLOCK:
+      case NOTE_SPINLOCK_ABORT:
+        {
+          /* The pointer follows the header at its natural alignment */
+
+          unsigned int hdrlen = note->length - note->datalen;
+          unsigned int offset = ((hdrlen + g_ptrsize - 1) &
+                                 ~(g_ptrsize - 1)) - hdrlen;
+
+          if (note->datalen >= offset + g_ptrsize + 1)
+            {
+              addr = 0;
+              for (i = 0; i < g_ptrsize; i++)
+                {
+                  addr |= (unsigned long)note->data[offset + i] << (8 * i);
+                }
+
+              fprintf(g_out, ", \"spinlock\": \"0x%lx\", \"value\": %u",
+                      addr, note->data[offset + g_ptrsize]);
+            }
+        }
+        break;
+
+      default:
+        break;
+    }
+
+  fputc('}', g_out);
+  event_end();
+}
+
+/* Decode the common note header */
+
+static bool note_decode(const uint8_t *buffer, struct note_s *note)
+{
+  unsigned int ndx = 0;
+  unsigned int hdrlen = g_smp ? 10 : 9;
+
+  note->length   = buffer[ndx++];
+  if (note->length < hdrlen)
+    {
+      return false;
+    }
+
+  note->type     = buffer[ndx++];
+  note->priority = buffer[ndx++];
+  note->cpu      = g_smp ? buffer[ndx++] : 0;
+  note->pid      = (unsigned int)buffer[ndx + 1] << 8 | buffer[ndx];
+  ndx           += 2;
+  note->systime  = (uint32_t)buffer[ndx + 3] << 24 |
+                   (uint32_t)buffer[ndx + 2] << 16 |
+                   (uint32_t)buffer[ndx + 1] << 8 |
+                   (uint32_t)buffer[ndx];
+  note->data     = &buffer[hdrlen];
+  note->datalen  = note->length - hdrlen;
+
+  if (note->cpu >= MAX_CPUS)
+    {
+      return false;
+    }
+
+  if (note->cpu >= g_ncpus)
+    {
+      g_ncpus = note->cpu + 1;
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int main(int argc, char **argv)
+{
+  struct note_s note;
+  uint8_t buffer[MAX_NOTE];
+  FILE *stream;
+  uint32_t prevtime = 0;
+  int64_t ticks = 0;
+  unsigned long nnotes = 0;
+  unsigned int cpu;
+  unsigned int len;
+  double ts;
+  int ch;
+
+  while ((ch = getopt(argc, argv, ":sf:p:h")) > 0)
+    {
+      switch (ch)
+        {
+          case 's':
+            g_smp = true;
+            break;
+
+          case 'f':
+            g_freq = strtod(optarg, NULL);
+            if (g_freq <= 0.0)
+              {
+                fprintf(stderr, "Invalid frequency: %s\n", optarg);
+                show_usage(argv[0]);
+              }
+            break;
+
+          case 'p':
+            g_ptrsize = (unsigned int)strtoul(optarg, NULL, 0);
+            if (g_ptrsize == 0 || g_ptrsize > sizeof(unsigned long) ||
+                (g_ptrsize & (g_ptrsize - 1)) != 0)
+              {
+                fprintf(stderr, "Invalid pointer size: %s\n", optarg);
+                show_usage(argv[0]);
+              }
+            break;
+
+          case 'h':
+            show_usage(argv[0]);
+            break;
+
+          case ':':
+            fprintf(stderr, "Missing option argument, option: %c\n",
+                    optopt);
+            show_usage(argv[0]);
+            break;
+
+          default:
+          case '?':
+            fprintf(stderr, "Unrecognized option: %c\n", optopt);
+            show_usage(argv[0]);
+            break;
+        }
+    }
+
+  if (optind >= argc || argc - optind > 2)
+    {
+      fprintf(stderr, "Unexpected number of arguments\n");
+      show_usage(argv[0]);
+    }
+
+  stream = fopen(argv[optind], "rb");
+  if (stream == NULL)
+    {
+      fprintf(stderr, "open %s failed: %s\n", argv[optind],
+              strerror(errno));
+      exit(EXIT_FAILURE);
+    }
+
+  g_out = stdout;
+  if (argc - optind > 1)
+    {
+      g_out = fopen(argv[optind + 1], "w");
+      if (g_out == NULL)
+        {
+          fprintf(stderr, "open %s failed: %s\n", argv[optind + 1],
+                  strerror(errno));
+          exit(EXIT_FAILURE);
+        }
+    }
+
+  g_taskname = calloc(MAX_PID, NAME_SIZE);
+  if (g_taskname == NULL)
+    {
+      fprintf(stderr, "Failed to allocate the task name table\n");
+      exit(EXIT_FAILURE);
+    }
+
+  fprintf(g_out, "{\n  \"displayTimeUnit\": \"ns\",\n  \"traceEvents\": [");
+
+  /* The stream is a sequence of notes, each beginning with its length */
+
+  ts = 0.0;
+  while ((ch = fgetc(stream)) != EOF)
+    {
+      buffer[0] = (uint8_t)ch;
+      len       = (unsigned int)ch;
+
+      if (len < 1 || fread(&buffer[1], 1, len - 1, stream) != len - 1)
+        {
+          fprintf(stderr, "Truncated note at note %lu\n", nnotes);
+          break;
+        }
+
+      if (!note_decode(buffer, &note))
+        {
+          fprintf(stderr, "Bad note at note %lu\n", nnotes);
+          break;
+        }
+
+      /* Extend the 32-bit time stamp.  Notes are in time order but allow
+       * for small reorderings between CPUs.
+       */
+
+      if (nnotes > 0)
+        {
+          ticks += (int32_t)(note.systime - prevtime);
+        }
+
+      prevtime = note.systime;
+      ts       = (double)ticks * 1000000.0 / g_freq;
+      nnotes++;
+
+      switch (note.type)
+        {
+          case NOTE_START:
+            if (note.datalen > 0)
+              {
+                len = note.datalen < NAME_SIZE ? note.datalen : NAME_SIZE;
+                memcpy(g_taskname[note.pid], note.data, len);
+                g_taskname[note.pid][len - 1] = '\0';
+              }
+
+            instant(&note, ts);
+            break;
+
+          case NOTE_STOP:
+          case NOTE_SUSPEND:
+            if (g_cpu[note.cpu].running && g_cpu[note.cpu].pid == note.pid)
+              {
+                cpu_idle(note.cpu, ts);
+              }
+
+            if (note.type == NOTE_STOP)
+              {
+                instant(&note, ts);
+              }
+            break;
+
+          case NOTE_RESUME:
+            cpu_idle(note.cpu, ts);
+            g_cpu[note.cpu].running = true;
+            g_cpu[note.cpu].pid     = note.pid;
+            g_cpu[note.cpu].start   = ts;
+            break;
+
+          default:
+            instant(&note, ts);
+            break;
+        }
+    }
+
+  /* Close the slices still open at the end of the trace and name the CPU
+   * tracks.
+   */
+
+  for (cpu = 0; cpu < g_ncpus; cpu++)
+    {
+      cpu_idle(cpu, ts);
+
+      event_begin("thread_name", "M", cpu, 0.0);
+      fprintf(g_out, ", \"args\": {\"name\": \"CPU%u\"}", cpu);
+      event_end();
+    }
+
+  fprintf(g_out, "\n  ]\n}\n");
+
+  fprintf(stderr, "%lu notes converted\n", nnotes);
+  free(g_taskname);
+  fclose(stream);
+
+  if (g_out != stdout)
+    {
+      fclose(g_out);
+    }
+
+  return EXIT_SUCCESS;
+}